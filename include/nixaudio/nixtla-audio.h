@@ -72,6 +72,17 @@ typedef enum ENNixOffsetType_ {
     ENNixOffsetType_Count
 } ENNixOffsetType;
 
+// ENNixOneShotSteal (voice to replace when the one-shots limit is reached)
+
+typedef enum ENNixOneShotSteal_ {
+    ENNixOneShotSteal_None = 0,     //new one-shot is rejected
+    ENNixOneShotSteal_Oldest,       //oldest one-shot is stopped
+    ENNixOneShotSteal_Quietest,     //lowest volume one-shot is stopped (oldest first on ties)
+    ENNixOneShotSteal_LowerPriority, //lowest priority one-shot is stopped if not higher than the new one (oldest first on ties)
+    //
+    ENNixOneShotSteal_Count
+} ENNixOneShotSteal;
+
 // STNixAudioDesc
 
 #define STNixAudioDesc_Zero    { 0, 0, 0, 0, 0 }
@@ -138,12 +149,23 @@ typedef struct STNixMutexItf_ {
     void        (*free)(STNixMutexRef* obj);
     void        (*lock)(STNixMutexRef obj);
     void        (*unlock)(STNixMutexRef obj);
+    NixBOOL     (*trylock)(STNixMutexRef obj);  //optional, NIX_TRUE if acquired without blocking (if NULL and 'lock' is custom, always NIX_FALSE)
 } STNixMutexItf;
 
 //Links NULL methods to a DEFAULT implementation,
 //this reduces the need to check for functions NULL pointers.
 void NixMutexItf_fillMissingMembers(STNixMutexItf* itf);
 
+//Fast mutex, spins before parking the thread and makes no syscalls when
+//uncontended (futex on Linux/Android, WaitOnAddress on Windows, os_unfair_lock
+//on Apple); other platforms get the default implementation.
+STNixMutexItf NixMutexItf_getFast(void);
+
+//Priority-inheritance mutex (PTHREAD_PRIO_INHERIT), a thread holding it runs
+//at the priority of the highest waiter; use it in the context of engines whose
+//sources are fed by low-priority threads. Falls back to the default where unsupported.
+STNixMutexItf NixMutexItf_getPrioInherit(void);
+
 //STNixContextRef
 
 #define STNixContextRef_Zero    { NULL, NULL }
@@ -197,7 +219,9 @@ struct STNixRecorderRef_;
 
 //Callbacks
 
-typedef void (*NixSourceCallbackFnc)(struct STNixSourceRef_* src, struct STNixBufferRef_* buffs, const NixUI32 buffsSz, void* userdata);
+typedef void (*NixSourceCallbackFnc)(struct STNixSourceRef_* src, struct STNixBufferRef_* buffs, const NixUI32 buffsSz, void* userdata); //'buffs' are released after the callback, keep one with NixBuffer_move(&buffs[i])
+typedef void (*NixSourceNeedsDataFnc)(struct STNixSourceRef_* src, const NixUI32 blocksQueued, const NixUI32 blocksDeficit, void* userdata); //queued audio fell below the low watermark, see NixSource_setLowWatermark
+typedef NixUI32 (*NixSourceRenderFnc)(struct STNixSourceRef_* src, void* dst, const NixUI32 frames, const STNixAudioDesc* fmt, void* userdata); //pull-model, called from the audio thread, returns the frames written (the rest is filled with silence)
 typedef void (*NixRecorderCallbackFnc)(struct STNixEngineRef_* eng, struct STNixRecorderRef_* rec, const STNixAudioDesc audioDesc, const NixUI8* audioData, const NixUI32 audioDataBytes, const NixUI32 blocksCount, void* userdata);
 
 //STNixBufferRef (shared pointer)
@@ -215,8 +239,148 @@ NX_INLN NixBOOL NixBuffer_isSame(STNixBufferRef ref, STNixBufferRef other) { ret
 NX_INLN NixBOOL NixBuffer_isNull(STNixBufferRef ref) { return (ref.ptr == NULL); }
 NX_INLN void    NixBuffer_null(STNixBufferRef* ref){ if(ref != NULL) ref->ptr = NULL; }
 NX_INLN void    NixBuffer_set(STNixBufferRef* ref, STNixBufferRef other){ if(!NixBuffer_isNull(other)){ NixBuffer_retain(other); } if(!NixBuffer_isNull(*ref)){ NixBuffer_release(ref); } *ref = other; }
+NX_INLN STNixBufferRef NixBuffer_move(STNixBufferRef* ref){ STNixBufferRef r = *ref; NixBuffer_null(ref); return r; } //transfers the reference, no retain/release
 NixBOOL         NixBuffer_setData(STNixBufferRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 NixBOOL         NixBuffer_fillWithZeroes(STNixBufferRef ref);
+NixUI8*         NixBuffer_getData(STNixBufferRef ref, NixUI32* optDstUse, NixUI32* optDstSz); //in-place access, for filling without copies
+NixBOOL         NixBuffer_setDataUse(STNixBufferRef ref, const NixUI32 bytes); //after filling in-place (rounded to block, up to the allocated size)
+
+//STNixBufferPoolRef (shared pointer, recycles buffers by format and capacity)
+
+#define STNixBufferPoolRef_Zero { NULL }
+
+typedef struct STNixBufferPoolRef_ {
+    struct STNixSharedPtr_*  ptr;
+} STNixBufferPoolRef;
+
+STNixBufferPoolRef NixBufferPool_alloc(STNixContextRef ctx, const NixUI32 maxIdlePerFmt);
+void            NixBufferPool_retain(STNixBufferPoolRef ref);
+void            NixBufferPool_release(STNixBufferPoolRef* ref);
+NX_INLN NixBOOL NixBufferPool_isSame(STNixBufferPoolRef ref, STNixBufferPoolRef other) { return (ref.ptr == other.ptr); }
+NX_INLN NixBOOL NixBufferPool_isNull(STNixBufferPoolRef ref) { return (ref.ptr == NULL); }
+NX_INLN void    NixBufferPool_null(STNixBufferPoolRef* ref){ if(ref != NULL) ref->ptr = NULL; }
+NX_INLN void    NixBufferPool_set(STNixBufferPoolRef* ref, STNixBufferPoolRef other){ if(!NixBufferPool_isNull(other)){ NixBufferPool_retain(other); } if(!NixBufferPool_isNull(*ref)){ NixBufferPool_release(ref); } *ref = other; }
+NixUI32         NixBufferPool_prepare(STNixBufferPoolRef ref, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes, const NixUI32 count); //pre-allocates idle buffers, returns the ammount added
+STNixBufferRef  NixBufferPool_acquire(STNixBufferPoolRef ref, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes); //empty buffer (data-use is zero), returns to the pool when released
+
+//Clock
+
+NixUI64         NixClock_getMonotonicUs(void); //host monotonic time in microseconds (CLOCK_MONOTONIC or QueryPerformanceCounter)
+
+//Log (library messages are queued without locks and delivered by NixLog_flush, which is called at the end of each tick)
+
+typedef enum ENNixLogLevel_ {
+    ENNixLogLevel_Info = 0,
+    ENNixLogLevel_Warning,
+    ENNixLogLevel_Error,
+    //
+    ENNixLogLevel_Count
+} ENNixLogLevel;
+
+typedef void (*NixLogSinkFnc)(const ENNixLogLevel level, const char* msg, void* userdata);
+
+void            NixLog_setSink(NixLogSinkFnc sink, void* userdata); //NULL restores the default (stdout or Android's log); set it before allocating engines
+NixUI32         NixLog_flush(void); //delivers the queued messages to the sink, returns the ammount delivered
+
+//Trace (spans of tick, conversions, callbacks and device threads; only when the library is compiled with NIX_TRACE)
+
+NixBOOL         NixTrace_isEnabled(void);
+NixBOOL         NixTrace_dumpChromeJson(const char* filepath); //Chrome's 'about:tracing' and Perfetto UI format, NIX_FALSE if not enabled
+
+//RtCheck (real-time safety; only when the library is compiled with NIX_RT_CHECK)
+//Memory calls (malloc, realloc, free) and contended locks made from threads marked
+//as real-time are reported to the handler with the call site's 'dbgHintStr'.
+//Device callbacks are marked by the library, other threads can be marked by the user.
+
+typedef enum ENNixRtViolation_ {
+    ENNixRtViolation_Malloc = 0,
+    ENNixRtViolation_Realloc,
+    ENNixRtViolation_Free,
+    ENNixRtViolation_Lock,      //mutex was already locked (would block); not probed if the mutex interface has no trylock
+    //
+    ENNixRtViolation_Count
+} ENNixRtViolation;
+
+typedef void (*NixRtViolationFnc)(const ENNixRtViolation type, const char* dbgHintStr, void* userdata);
+
+NixBOOL         NixRtCheck_isEnabled(void);
+void            NixRtCheck_enter(void);         //marks the current thread as real-time (nestable)
+void            NixRtCheck_exit(void);
+NixBOOL         NixRtCheck_isRealtime(void);    //current thread
+void            NixRtCheck_setHandler(NixRtViolationFnc fnc, void* userdata); //called on the offending thread; NULL restores the default (logs an error)
+NixUI32         NixRtCheck_getViolationsCount(void);
+
+//RtThread (scheduling of real-time threads)
+
+typedef enum ENNixRtSched_ {
+    ENNixRtSched_Default = 0,   //unchanged
+    ENNixRtSched_Fifo,          //SCHED_FIFO (THREAD_PRIORITY_TIME_CRITICAL on Windows)
+    ENNixRtSched_RoundRobin,    //SCHED_RR (THREAD_PRIORITY_TIME_CRITICAL on Windows)
+    //
+    ENNixRtSched_Count
+} ENNixRtSched;
+
+typedef struct STNixRtThreadOpts_ {
+    ENNixRtSched    sched;
+    NixSI32         priority;       //for 'sched', clamped to the policy's range (zero is the minimum)
+    NixUI64         cpuMask;        //bit per CPU, zero means unchanged (Linux, Android and Windows)
+    NixBOOL         flushDenormals; //flush-to-zero and denormals-are-zero (x86 SSE, ARM)
+} STNixRtThreadOpts;
+
+NixBOOL         NixRtThread_apply(const STNixRtThreadOpts* opts); //to the current thread, NIX_FALSE if any option was rejected (privileges or platform)
+
+//Counters (64-bit, monotonic since allocation, frames in the buffers' format)
+
+typedef struct STNixSourceCounters_ {
+    NixUI64         framesQueued;   //frames accepted by setBuffer/queueBuffer*
+    NixUI64         framesPlayed;   //frames consumed by the output (repeats included)
+    NixUI64         timeUs;         //NixClock_getMonotonicUs() when sampled
+} STNixSourceCounters;
+
+typedef struct STNixRecorderCounters_ {
+    NixUI64         framesCaptured; //frames written into the recorder's buffers
+    NixUI64         timeUs;         //NixClock_getMonotonicUs() when sampled
+} STNixRecorderCounters;
+
+//Playback clock (interpolated between the device reports; the audible frame at 'timeUs' is 'framesPlayed - latencyUs * samplerate / 1000000')
+
+typedef struct STNixSourceClock_ {
+    NixUI64         framesPlayed;   //frames consumed by the output at 'timeUs' (same timeline as STNixSourceCounters)
+    NixUI64         latencyUs;      //time until 'framesPlayed' is audible, zero if unknown
+    NixUI64         timeUs;         //NixClock_getMonotonicUs() of the estimate
+} STNixSourceClock;
+
+//Engine statistics (see NixEngine_getStats; monotonic since the engine allocation, readable from any thread)
+
+#define NIX_ENGINE_STATS_TICK_HIST_SZ   8   //tick durations: <250us, <500us, <1ms, <2ms, <4ms, <8ms, <16ms, >=16ms
+
+typedef struct STNixEngineStats_ {
+    //tick
+    NixUI64         ticks;
+    NixUI32         tickUsLast;
+    NixUI32         tickUsAvg;
+    NixUI32         tickUsMax;
+    NixUI32         tickUsHist[NIX_ENGINE_STATS_TICK_HIST_SZ];
+    //sources (when sampled)
+    NixUI32         sourcesTotal;   //allocated (engine's pool excluded)
+    NixUI32         sourcesActive;  //playing and not paused
+    //buffers
+    NixUI64         buffsQueued;    //by setBuffer/queueBuffer*
+    NixUI64         buffsNotified;  //to sources callbacks
+    NixUI32         buffsQueuedLastTick;   //since the previous tick
+    NixUI32         buffsNotifiedLastTick;
+    //format conversion (NixFmtConverter_convert)
+    NixUI64         convBytes;      //source bytes converted
+    NixUI64         convUs;
+    //callbacks (sources and recorders, called by tick)
+    NixUI64         callbacks;
+    NixUI64         callbacksUs;
+    NixUI32         callbackUsMax;
+    //errors
+    NixUI64         backendErrors;  //API errors reported by the backend (OpenAL: process-wide)
+    NixUI64         underruns;      //stream-sources queues drained while playing
+    NixUI64         recOverruns;    //captured frames dropped (oldest filled buffer reused)
+} STNixEngineStats;
 
 //STNixSourceRef (shared pointer)
 
@@ -245,9 +409,25 @@ NixBOOL         NixSource_isRepeat(STNixSourceRef ref);
 NixFLOAT        NixSource_getVolume(STNixSourceRef ref);
 NixBOOL         NixSource_setBuffer(STNixSourceRef ref, STNixBufferRef buff);  //static-source
 NixBOOL         NixSource_queueBuffer(STNixSourceRef ref, STNixBufferRef buff); //stream-source
+NixBOOL         NixSource_queueBufferMove(STNixSourceRef ref, STNixBufferRef* buff); //stream-source, consumes the caller's reference on success ('buff' is nullified)
+NixUI32         NixSource_queueBuffers(STNixSourceRef ref, const STNixBufferRef* buffs, const NixUI32 buffsSz); //stream-source, returns the ammount of buffers queued (in order)
 NixBOOL         NixSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset); //relative to first buffer in queue
 NixUI32         NixSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);   //all buffer queue
 NixUI32         NixSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //relative to first buffer in queue
+NixBOOL         NixSource_setPriority(STNixSourceRef ref, const NixUI8 priority); //higher priority sources keep real voices, see NixEngine_setVoicesLimit
+NixBOOL         NixSource_isVirtual(STNixSourceRef ref); //playing without a real voice
+//Scheduling (engine frame time, see NixEngine_getFrameTime; times already due are applied immediately)
+NixBOOL         NixSource_playAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         NixSource_stopAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         NixSource_queueBufferAt(STNixSourceRef ref, STNixBufferRef buff, const NixUI64 engFrame); //stream-source, queues and schedules the start (if not playing)
+NixBOOL         NixSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames); //achieved error of the last scheduled start in engine frames (positive is late), NIX_FALSE if not started yet
+//Counters
+NixBOOL         NixSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst);
+NixBOOL         NixSource_getClock(STNixSourceRef ref, STNixSourceClock* dst); //sub-millisecond position estimate, see STNixSourceClock
+//Low watermark (stream-source, 'callback' is called by tick once each time the queued audio falls below 'amount', zero disables)
+NixBOOL         NixSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
+//Render (pull-model, 'callback' fills audio on demand in 'fmt' instead of queueing buffers; only once, in a source without buffers)
+NixBOOL         NixSource_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData);
 
 //STNixRecorderRef (shared pointer)
 
@@ -271,6 +451,7 @@ NixBOOL         NixRecorder_stop(STNixRecorderRef ref);
 NixBOOL         NixRecorder_flush(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying);
 NixBOOL         NixRecorder_isCapturing(STNixRecorderRef ref);
 NixUI32         NixRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);
+NixBOOL         NixRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst);
 
 //STNixEngineRef (shared pointer)
 
@@ -298,6 +479,20 @@ void            NixEngine_tick(STNixEngineRef ref);
 STNixSourceRef  NixEngine_allocSource(STNixEngineRef ref);
 STNixBufferRef  NixEngine_allocBuffer(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 STNixRecorderRef NixEngine_allocRecorder(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
+//One-shots (fire-and-forget, the voice is recycled after playback ends)
+NixBOOL         NixEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+NixBOOL         NixEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal); //zero is unlimited ('steal' is not applied)
+//Voices (playing static sources above the limit are virtualized by priority and volume; zero is unlimited)
+NixBOOL         NixEngine_setVoicesLimit(STNixEngineRef ref, const NixUI32 maxReal);
+//Batch (sources are started/stopped together, same device period when the backend allows it)
+void            NixEngine_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+void            NixEngine_stopSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+//Clock (monotonic engine timeline in frames, used by the NixSource_*At() scheduling calls)
+NixUI64         NixEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec);
+//Stats
+NixBOOL         NixEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst);
+//Real-time threads (applied by the device threads driven by the engine; NIX_FALSE if the backend has none, like OpenAL where the caller's thread ticks)
+NixBOOL         NixEngine_setRtThreadOpts(STNixEngineRef ref, const STNixRtThreadOpts* opts);
 
 //STNixEngineItf (API)
 
@@ -313,6 +508,20 @@ typedef struct STNixEngineItf_ {
     STNixSourceRef  (*allocSource)(STNixEngineRef ref);
     STNixBufferRef  (*allocBuffer)(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
     STNixRecorderRef (*allocRecorder)(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
+    //One-shots
+    NixBOOL         (*playOneShot)(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+    NixBOOL         (*setOneShotsLimit)(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal);
+    //Voices
+    NixBOOL         (*setVoicesLimit)(STNixEngineRef ref, const NixUI32 maxReal);
+    //Batch
+    void            (*playSources)(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+    void            (*stopSources)(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+    //Clock
+    NixUI64         (*getFrameTime)(STNixEngineRef ref, NixUI32* optDstFramesPerSec);
+    //Stats
+    NixBOOL         (*getStats)(STNixEngineRef ref, STNixEngineStats* dst);
+    //Real-time threads
+    NixBOOL         (*setRtThreadOpts)(STNixEngineRef ref, const STNixRtThreadOpts* opts);
 } STNixEngineItf;
 
 //Links NULL methods to a NOP implementation,
@@ -326,6 +535,8 @@ typedef struct STNixBufferItf_ {
     void            (*free)(STNixBufferRef ref);
     NixBOOL         (*setData)(STNixBufferRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
     NixBOOL         (*fillWithZeroes)(STNixBufferRef ref);
+    NixUI8*         (*getData)(STNixBufferRef ref, NixUI32* optDstUse, NixUI32* optDstSz);
+    NixBOOL         (*setDataUse)(STNixBufferRef ref, const NixUI32 bytes);
 } STNixBufferItf;
 
 //Links NULL methods to a NOP implementation,
@@ -349,9 +560,25 @@ typedef struct STNixSourceItf_ {
     NixFLOAT        (*getVolume)(STNixSourceRef ref);
     NixBOOL         (*setBuffer)(STNixSourceRef ref, STNixBufferRef buff);  //static-source
     NixBOOL         (*queueBuffer)(STNixSourceRef ref, STNixBufferRef buff); //stream-source
+    NixBOOL         (*queueBufferMove)(STNixSourceRef ref, STNixBufferRef* buff); //stream-source, consumes the caller's reference on success
+    NixUI32         (*queueBuffers)(STNixSourceRef ref, const STNixBufferRef* buffs, const NixUI32 buffsSz); //stream-source, returns the ammount of buffers queued
     NixBOOL         (*setBufferOffset)(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset); //relative to first buffer in queue
     NixUI32         (*getBuffersCount)(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);   //all buffer queue
     NixUI32         (*getBlocksOffset)(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //relative to first buffer in queue
+    NixBOOL         (*setPriority)(STNixSourceRef ref, const NixUI8 priority);
+    NixBOOL         (*isVirtual)(STNixSourceRef ref);
+    //Scheduling
+    NixBOOL         (*playAt)(STNixSourceRef ref, const NixUI64 engFrame);
+    NixBOOL         (*stopAt)(STNixSourceRef ref, const NixUI64 engFrame);
+    NixBOOL         (*queueBufferAt)(STNixSourceRef ref, STNixBufferRef buff, const NixUI64 engFrame);
+    NixBOOL         (*getStartError)(STNixSourceRef ref, NixSI64* dstFrames);
+    //Counters
+    NixBOOL         (*getCounters)(STNixSourceRef ref, STNixSourceCounters* dst);
+    NixBOOL         (*getClock)(STNixSourceRef ref, STNixSourceClock* dst);
+    //Low watermark
+    NixBOOL         (*setLowWatermark)(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
+    //Render
+    NixBOOL         (*setRenderCallback)(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData);
 } STNixSourceItf;
 
 //Links NULL methods to a NOP implementation,
@@ -369,6 +596,7 @@ typedef struct STNixRecorderItf_ {
     NixBOOL         (*flush)(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying);
     NixBOOL         (*isCapturing)(STNixRecorderRef ref);
     NixUI32         (*getBuffersFilledCount)(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);
+    NixBOOL         (*getCounters)(STNixRecorderRef ref, STNixRecorderCounters* dst);
 } STNixRecorderItf;
 
 //Links NULL methods to a NOP implementation,
@@ -404,6 +632,8 @@ void NixPCMBuffer_init(STNixContextRef ctx, STNixPCMBuffer* obj);
 void NixPCMBuffer_destroy(STNixPCMBuffer* obj);
 NixBOOL NixPCMBuffer_setData(STNixPCMBuffer* obj, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 NixBOOL NixPCMBuffer_fillWithZeroes(STNixPCMBuffer* obj);
+NixBOOL NixPCMBuffer_setDataUse(STNixPCMBuffer* obj, const NixUI32 bytes);
+NX_INLN NixUI32 NixPCMBuffer_getBlocks(const STNixPCMBuffer* obj) { return (obj != NULL && obj->desc.blockAlign > 0 ? obj->use / obj->desc.blockAlign : 0); }
 
 //------
 //Notif (internal)
@@ -425,11 +655,19 @@ typedef struct STNixSourceNotif_ {
     STNixSourceCallback callback;
     STNixBufferRef      buffs[NIX_SOURCE_NOTIF_BUFFS_MAX];  //this struct is used internally only, changing this value should not affect already compile code.
     NixUI32             buffsUse;
+    //needs (low watermark, record without buffers)
+    struct {
+        NixSourceNeedsDataFnc func;
+        void*           data;
+        NixUI32         queued;
+        NixUI32         deficit;
+    } needs;
 } STNixSourceNotif;
 
 void NixSourceNotif_init(STNixSourceNotif* obj, STNixSourceRef src, const STNixSourceCallback callback);
 void NixSourceNotif_destroy(STNixSourceNotif* obj);
 NixBOOL NixSourceNotif_addBuff(STNixSourceNotif* obj, STNixBufferRef buff);
+NixBOOL NixSourceNotif_addBuffMove(STNixSourceNotif* obj, STNixBufferRef* buff); //consumes the reference on success
 
 //------
 //NotifQueue (internal)
@@ -447,6 +685,161 @@ void NixNotifQueue_init(STNixContextRef ctx, STNixNotifQueue* obj);
 void NixNotifQueue_destroy(STNixNotifQueue* obj);
 //
 NixBOOL NixNotifQueue_addBuff(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceCallback callback, STNixBufferRef buff);
+NixBOOL NixNotifQueue_addBuffMove(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceCallback callback, STNixBufferRef* buff); //consumes the reference on success
+struct STNixSourceWatermark_;
+NixBOOL NixNotifQueue_addNeedsData(STNixNotifQueue* obj, STNixSourceRef src, const struct STNixSourceWatermark_* wmark, const NixUI32 queued, const NixUI32 deficit);
+
+//------
+//SourceWatermark (internal)
+//------
+
+typedef struct STNixSourceWatermark_ {
+    ENNixOffsetType     type;
+    NixUI32             amount;     //zero if disabled
+    NixSourceNeedsDataFnc func;
+    void*               data;
+    NixBOOL             isArmed;    //fires once per crossing, re-armed when buffers are queued
+} STNixSourceWatermark;
+
+NX_INLN NixBOOL NixSourceWatermark_isEnabled(const STNixSourceWatermark* obj) { return (obj->amount > 0 && obj->func != NULL); }
+void    NixSourceWatermark_set(STNixSourceWatermark* obj, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
+NixBOOL NixSourceWatermark_check(STNixSourceWatermark* obj, const STNixAudioDesc* buffsFmt, const NixUI32 queuedBlocks, NixUI32* dstDeficitBlocks); //NIX_TRUE if the callback must be called (disarms)
+
+//------
+//SourceRender (internal)
+//------
+
+//Pull-model source, the user's callback renders in 'fmt' and the result is converted to the device's format (if different).
+typedef struct STNixSourceRender_ {
+    STNixContextRef     ctx;
+    NixSourceRenderFnc  func;
+    void*               data;
+    STNixAudioDesc      fmt;        //user's format
+    STNixAudioDesc      dstFmt;     //device's format
+    void*               conv;       //NixFmtConverter, NULL if 'fmt' and 'dstFmt' are equal
+    void*               buff;       //user's samples when converting
+    NixUI32             buffBlocks;
+} STNixSourceRender;
+
+void    NixSourceRender_init(STNixContextRef ctx, STNixSourceRender* obj);
+void    NixSourceRender_destroy(STNixSourceRender* obj);
+NX_INLN NixBOOL NixSourceRender_isSet(const STNixSourceRender* obj) { return (obj->func != NULL); }
+NixBOOL NixSourceRender_prepare(STNixSourceRender* obj, const STNixAudioDesc* fmt, const STNixAudioDesc* dstFmt, NixSourceRenderFnc func, void* data);
+NixUI32 NixSourceRender_fill(STNixSourceRender* obj, STNixSourceRef* src, void* dst, const NixUI32 dstBlocks); //always fills 'dstBlocks' in 'dstFmt' (silence after the rendered frames), returns the rendered frames
+
+//------
+//EngineClock (internal)
+//------
+
+//Engine timeline, frames at 'rate' since the engine creation (NixClock_getMonotonicUs based).
+typedef struct STNixEngineClock_ {
+    NixUI64             originUs;
+    NixUI32             rate;       //frames per second
+} STNixEngineClock;
+
+void    NixEngineClock_init(STNixEngineClock* obj, const NixUI32 rate);
+NixUI64 NixEngineClock_getFrame(const STNixEngineClock* obj);
+NixUI64 NixEngineClock_frameToUs(const STNixEngineClock* obj, const NixUI64 frame);  //to NixClock_getMonotonicUs() time
+NixSI64 NixEngineClock_usToFrames(const STNixEngineClock* obj, const NixSI64 us);    //duration
+
+//------
+//EngineStats (internal)
+//------
+
+//Counters updated by the engine (tick, device and API threads) with relaxed atomics, times in nanoseconds.
+typedef struct STNixEngineStatsState_ {
+    volatile NixUI64    ticks;
+    volatile NixUI64    tickNsSum;
+    volatile NixUI32    tickUsLast;
+    volatile NixUI32    tickUsMax;
+    volatile NixUI32    tickUsHist[NIX_ENGINE_STATS_TICK_HIST_SZ];
+    volatile NixUI64    buffsQueued;
+    volatile NixUI64    buffsNotified;
+    volatile NixUI64    buffsQueuedAtTick;      //'buffsQueued' at the end of the previous tick
+    volatile NixUI32    buffsQueuedLastTick;
+    volatile NixUI32    buffsNotifiedLastTick;
+    volatile NixUI64    convBytes;
+    volatile NixUI64    convNs;
+    volatile NixUI64    callbacks;
+    volatile NixUI64    callbacksNs;
+    volatile NixUI32    callbackUsMax;
+    volatile NixUI64    underruns;
+    volatile NixUI64    recOverruns;
+} STNixEngineStatsState;
+
+NixUI64 NixClock_getMonotonicNs(void);
+void    NixEngineStats_init(STNixEngineStatsState* obj);
+void    NixEngineStats_addTick(STNixEngineStatsState* obj, const NixUI64 ns, const NixUI32 buffsNotified);
+void    NixEngineStats_addCallback(STNixEngineStatsState* obj, const NixUI64 ns);
+void    NixEngineStats_addConv(STNixEngineStatsState* obj, const NixUI64 bytes, const NixUI64 ns);
+void    NixEngineStats_addQueued(STNixEngineStatsState* obj, const NixUI32 buffs);
+void    NixEngineStats_addUnderrun(STNixEngineStatsState* obj);
+void    NixEngineStats_addRecOverrun(STNixEngineStatsState* obj, const NixUI32 frames);
+void    NixEngineStats_get(STNixEngineStatsState* obj, STNixEngineStats* dst); //all but sources and backend errors
+
+//------
+//RtThreadState (internal)
+//------
+
+//Options set by the API thread, applied once by each device thread (when 'seq' changes);
+//published as a seqlock of atomic words: a read overlapping a 'set' is discarded and retried on the next call.
+typedef struct STNixRtThreadState_ {
+    volatile NixUI32    seq;        //odd while a 'set' is writing, even when stable
+    struct {
+        volatile NixUI32 sched;
+        volatile NixUI32 priority;
+        volatile NixUI32 cpuMaskLo;
+        volatile NixUI32 cpuMaskHi;
+        volatile NixUI32 flushDenormals;
+    } opts;
+} STNixRtThreadState;
+
+void    NixRtThreadState_init(STNixRtThreadState* obj);
+void    NixRtThreadState_set(STNixRtThreadState* obj, const STNixRtThreadOpts* opts);
+void    NixRtThreadState_applyIfChanged(STNixRtThreadState* obj, NixUI32* seqApplied); //from the device thread, 'seqApplied' is owned by the thread's stream (zero on creation)
+
+//------
+//PosInterp (internal)
+//------
+
+//Extrapolates a position reported in coarse steps (mixer periods) with the monotonic clock; returned positions never go backwards until the reported position does.
+typedef struct STNixPosInterp_ {
+    NixUI64             reported;   //last reported position
+    NixUI64             reportedUs; //time when the reported position changed
+    NixUI64             last;       //last returned position
+} STNixPosInterp;
+
+void    NixPosInterp_reset(STNixPosInterp* obj);
+NixUI64 NixPosInterp_get(STNixPosInterp* obj, const NixUI64 reported, const NixUI32 rate, const NixUI64 maxAhead, const NixUI64 usNow); //maxAhead: frames allowed ahead of 'reported' (zero if not running)
+
+//------
+//OneShots (internal)
+//------
+
+typedef struct STNixOneShot_ {
+    STNixSourceRef      source;
+    NixFLOAT            vol;
+    NixUI8              priority;
+    NixUI32             seq;        //play order
+} STNixOneShot;
+
+typedef struct STNixOneShots_ {
+    STNixContextRef     ctx;
+    STNixMutexRef       mutex;
+    STNixOneShot*       arr;
+    NixUI32             use;
+    NixUI32             sz;
+    NixUI32             max;        //concurrent one-shots, zero is unlimited
+    ENNixOneShotSteal   steal;
+    NixUI32             seq;
+} STNixOneShots;
+
+void NixOneShots_init(STNixContextRef ctx, STNixOneShots* obj);
+void NixOneShots_destroy(STNixOneShots* obj);
+//
+NixBOOL NixOneShots_setLimit(STNixOneShots* obj, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal);
+NixBOOL NixOneShots_play(STNixOneShots* obj, STNixEngineRef eng, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+void NixOneShots_tick(STNixOneShots* obj); //releases the finished one-shots
 
 //------
 //PCMBuffer (API)
@@ -469,6 +862,7 @@ NixBOOL NixFmtConverter_setPtrAtDst(void* obj, const NixUI32 iChannel, void* ptr
 NixBOOL NixFmtConverter_setPtrAtSrcInterlaced(void* obj, const STNixAudioDesc* desc, void* ptr, const NixUI32 iFirstSample); //all channels at once
 NixBOOL NixFmtConverter_setPtrAtDstInterlaced(void* obj, const STNixAudioDesc* desc, void* ptr, const NixUI32 iFirstSample); //all channels at once
 NixBOOL NixFmtConverter_convert(void* obj, const NixUI32 srcBlocks, NixUI32 dstBlocks, NixUI32* dstAmmBlocksRead, NixUI32* dstAmmBlocksWritten);
+void    NixFmtConverter_setStats(void* obj, STNixEngineStatsState* stats); //optional, 'convert' adds its bytes and time to 'stats'
 //
 NixUI32 NixFmtConverter_maxChannels(void); //= 2, defined at compile-time
 NixUI32 NixFmtConverter_blocksForNewFrequency(const NixUI32 ammSampesOrg, const NixUI32 freqOrg, const NixUI32 freqNew); //ammount of output samples from one frequeny to another, +1 for safety
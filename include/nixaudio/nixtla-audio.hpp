@@ -0,0 +1,266 @@
+//
+//  nixtla-audio.hpp
+//  NixtlaAudioLib
+//
+//  Created by Marcos Ortega on 11/02/14.
+//  Copyright (c) 2014 NIBSA. All rights reserved.
+//
+//  This entire notice must be retained in this source code.
+//  This source code is under MIT Licence.
+//
+//  This software is provided "as is", with absolutely no warranty expressed
+//  or implied. Any use is at your own risk.
+//
+//  Latest fixes enhancements and documentation at https://github.com/marcosjom/lib-nixtla-audio
+//
+
+//Header-only C++ wrapper of the C API.
+//Handles are move-only: moving steals the STNix*Ref without touching the refcount,
+//copies are explicit with 'copy()' (retain). Callbacks are called with a pointer to
+//a caller-owned callable (lambda), nothing is allocated by the wrapper.
+
+#ifndef NixtlaAudioLib_nixtla_hpp
+#define NixtlaAudioLib_nixtla_hpp
+
+#include <cstddef>      //size_t, NULL (before the C header)
+#include "nixaudio/nixtla-audio.h"
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#   if __has_include(<span>)
+#       include <span>
+#       define NIX_HPP_HAS_STD_SPAN
+#   endif
+#endif
+
+namespace Nix {
+
+//------
+//Span (std::span when available)
+//------
+
+#ifdef NIX_HPP_HAS_STD_SPAN
+    template<typename T> using Span = std::span<T>;
+#else
+    template<typename T>
+    class Span {
+    public:
+        Span() noexcept : ptr_(NULL), sz_(0) {}
+        Span(T* ptr, const size_t sz) noexcept : ptr_(ptr), sz_(sz) {}
+        T*      data() const noexcept { return ptr_; }
+        size_t  size() const noexcept { return sz_; }
+        bool    empty() const noexcept { return (sz_ == 0); }
+        T*      begin() const noexcept { return ptr_; }
+        T*      end() const noexcept { return ptr_ + sz_; }
+        T&      operator[](const size_t i) const noexcept { return ptr_[i]; }
+    private:
+        T*      ptr_;
+        size_t  sz_;
+    };
+#endif
+
+//------
+//Handle (move-only owner of one reference)
+//------
+
+template<typename D, typename REF, void (*RETAIN)(REF), void (*RELEASE)(REF*)>
+class Handle {
+public:
+    Handle() noexcept { ref_.ptr = NULL; ref_.itf = NULL; }
+    explicit Handle(const REF ref) noexcept : ref_(ref) {} //adopts the reference (no retain)
+    Handle(Handle&& other) noexcept : ref_(other.ref_) { other.ref_.ptr = NULL; }
+    Handle& operator=(Handle&& other) noexcept { if(this != &other){ reset(); ref_ = other.ref_; other.ref_.ptr = NULL; } return *this; }
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    ~Handle(){ reset(); }
+    //
+    static D    retained(const REF ref) noexcept { if(ref.ptr != NULL){ RETAIN(ref); } return D(ref); } //shares the reference (retain)
+    D           copy() const noexcept { return retained(ref_); }
+    void        reset() noexcept { if(ref_.ptr != NULL){ RELEASE(&ref_); ref_.ptr = NULL; } }
+    REF         detach() noexcept { REF r = ref_; ref_.ptr = NULL; return r; } //caller owns the reference
+    const REF&  get() const noexcept { return ref_; }
+    REF*        getPtr() noexcept { return &ref_; }
+    bool        isNull() const noexcept { return (ref_.ptr == NULL); }
+    explicit operator bool() const noexcept { return (ref_.ptr != NULL); }
+    bool        operator==(const Handle& other) const noexcept { return (ref_.ptr == other.ref_.ptr); }
+    bool        operator!=(const Handle& other) const noexcept { return (ref_.ptr != other.ref_.ptr); }
+protected:
+    REF         ref_;
+};
+
+//------
+//Context
+//------
+
+class Context : public Handle<Context, STNixContextRef, NixContext_retain, NixContext_release> {
+public:
+    using Handle::Handle;
+    static Context  create(STNixContextItf* itf) { return Context(NixContext_alloc(itf)); }
+    static Context  createDefault() { STNixContextItf itf = NixContextItf_getDefault(); return Context(NixContext_alloc(&itf)); }
+};
+
+//------
+//Buffer
+//------
+
+class Buffer : public Handle<Buffer, STNixBufferRef, NixBuffer_retain, NixBuffer_release> {
+public:
+    using Handle::Handle;
+    static Buffer   take(STNixBufferRef& ref) noexcept { return Buffer(NixBuffer_move(&ref)); } //steals a reference, ex: from a source callback
+    //
+    bool            setData(const STNixAudioDesc& desc, const void* data, const NixUI32 bytes) { return NixBuffer_setData(ref_, &desc, (const NixUI8*)data, bytes) != NIX_FALSE; }
+    bool            setDataUse(const NixUI32 bytes) { return NixBuffer_setDataUse(ref_, bytes) != NIX_FALSE; }
+    bool            fillWithZeroes() { return NixBuffer_fillWithZeroes(ref_) != NIX_FALSE; }
+    //PCM views (in-place, no copies)
+    template<typename T = NixUI8>
+    Span<T>         data() const { NixUI32 use = 0; NixUI8* ptr = NixBuffer_getData(ref_, &use, NULL); return Span<T>((T*)ptr, (ptr != NULL ? use / sizeof(T) : 0)); }      //filled range
+    template<typename T = NixUI8>
+    Span<T>         capacity() const { NixUI32 sz = 0; NixUI8* ptr = NixBuffer_getData(ref_, NULL, &sz); return Span<T>((T*)ptr, (ptr != NULL ? sz / sizeof(T) : 0)); }   //allocated range, for filling before 'setDataUse'
+};
+
+//------
+//Source
+//------
+
+class Source : public Handle<Source, STNixSourceRef, NixSource_retain, NixSource_release> {
+public:
+    using Handle::Handle;
+    //callback, 'fn' is called as fn(const STNixSourceRef& src, Span<STNixBufferRef> buffs) and must outlive the source's notifications;
+    //keep a buffer with Buffer::take(buffs[i]).
+    template<typename F>
+    void            setCallback(F* fn) { NixSource_setCallback(ref_, (fn != NULL ? &Source::callback_<F> : NULL), (void*)fn); }
+    void            clearCallback() { NixSource_setCallback(ref_, NULL, NULL); }
+    //
+    bool            setVolume(const NixFLOAT vol) { return NixSource_setVolume(ref_, vol) != NIX_FALSE; }
+    bool            setRepeat(const bool isRepeat) { return NixSource_setRepeat(ref_, isRepeat ? NIX_TRUE : NIX_FALSE) != NIX_FALSE; }
+    bool            setPriority(const NixUI8 priority) { return NixSource_setPriority(ref_, priority) != NIX_FALSE; }
+    void            play() { NixSource_play(ref_); }
+    void            pause() { NixSource_pause(ref_); }
+    void            stop() { NixSource_stop(ref_); }
+    bool            isPlaying() const { return NixSource_isPlaying(ref_) != NIX_FALSE; }
+    bool            isPaused() const { return NixSource_isPaused(ref_) != NIX_FALSE; }
+    bool            isRepeat() const { return NixSource_isRepeat(ref_) != NIX_FALSE; }
+    bool            isVirtual() const { return NixSource_isVirtual(ref_) != NIX_FALSE; }
+    NixFLOAT        getVolume() const { return NixSource_getVolume(ref_); }
+    //buffers
+    bool            setBuffer(const Buffer& buff) { return NixSource_setBuffer(ref_, buff.get()) != NIX_FALSE; }   //static-source
+    bool            queueBuffer(const Buffer& buff) { return NixSource_queueBuffer(ref_, buff.get()) != NIX_FALSE; } //stream-source, shares the reference
+    bool            queueBuffer(Buffer&& buff) { return NixSource_queueBufferMove(ref_, buff.getPtr()) != NIX_FALSE; } //stream-source, 'buff' is consumed on success
+    NixUI32         queueBuffers(const Buffer* buffs, const NixUI32 buffsSz) { return NixSource_queueBuffers(ref_, (const STNixBufferRef*)buffs, buffsSz); } //stream-source, shares the references
+    bool            setBufferOffset(const ENNixOffsetType type, const NixUI32 offset) { return NixSource_setBufferOffset(ref_, type, offset) != NIX_FALSE; }
+    NixUI32         getBuffersCount(NixUI32* optDstBytesCount = NULL, NixUI32* optDstBlocksCount = NULL, NixUI32* optDstMsecsCount = NULL) const { return NixSource_getBuffersCount(ref_, optDstBytesCount, optDstBlocksCount, optDstMsecsCount); }
+    NixUI32         getBlocksOffset(NixUI32* optDstBytesCount = NULL, NixUI32* optDstBlocksCount = NULL, NixUI32* optDstMsecsCount = NULL) const { return NixSource_getBlocksOffset(ref_, optDstBytesCount, optDstBlocksCount, optDstMsecsCount); }
+    //scheduling (engine frame time, see Engine::getFrameTime)
+    bool            playAt(const NixUI64 engFrame) { return NixSource_playAt(ref_, engFrame) != NIX_FALSE; }
+    bool            stopAt(const NixUI64 engFrame) { return NixSource_stopAt(ref_, engFrame) != NIX_FALSE; }
+    bool            queueBufferAt(const Buffer& buff, const NixUI64 engFrame) { return NixSource_queueBufferAt(ref_, buff.get(), engFrame) != NIX_FALSE; } //stream-source
+    bool            getStartError(NixSI64* dstFrames) const { return NixSource_getStartError(ref_, dstFrames) != NIX_FALSE; }
+    //counters
+    bool            getCounters(STNixSourceCounters& dst) const { return NixSource_getCounters(ref_, &dst) != NIX_FALSE; }
+    bool            getClock(STNixSourceClock& dst) const { return NixSource_getClock(ref_, &dst) != NIX_FALSE; }
+    //low watermark (stream-source), 'fn' is called by tick as fn(const STNixSourceRef& src, NixUI32 blocksQueued, NixUI32 blocksDeficit) and must outlive the source's notifications
+    template<typename F>
+    bool            setLowWatermark(const ENNixOffsetType type, const NixUI32 amount, F* fn) { return NixSource_setLowWatermark(ref_, type, amount, (fn != NULL ? &Source::needsData_<F> : NULL), (void*)fn) != NIX_FALSE; }
+    bool            clearLowWatermark() { return NixSource_setLowWatermark(ref_, ENNixOffsetType_Blocks, 0, NULL, NULL) != NIX_FALSE; }
+    //render (pull-model), 'fn' is called from the audio thread as fn(const STNixSourceRef& src, void* dst, NixUI32 frames, const STNixAudioDesc& fmt) returning the frames written, and must outlive the source
+    template<typename F>
+    bool            setRenderCallback(const STNixAudioDesc& fmt, F* fn) { return fn != NULL && NixSource_setRenderCallback(ref_, &fmt, &Source::render_<F>, (void*)fn) != NIX_FALSE; }
+private:
+    template<typename F>
+    static void     callback_(STNixSourceRef* src, STNixBufferRef* buffs, const NixUI32 buffsSz, void* userdata){ (*(F*)userdata)(*src, Span<STNixBufferRef>(buffs, buffsSz)); }
+    template<typename F>
+    static void     needsData_(STNixSourceRef* src, const NixUI32 blocksQueued, const NixUI32 blocksDeficit, void* userdata){ (*(F*)userdata)(*src, blocksQueued, blocksDeficit); }
+    template<typename F>
+    static NixUI32  render_(STNixSourceRef* src, void* dst, const NixUI32 frames, const STNixAudioDesc* fmt, void* userdata){ return (*(F*)userdata)(*src, dst, frames, *fmt); }
+};
+
+//------
+//Recorder
+//------
+
+class Recorder : public Handle<Recorder, STNixRecorderRef, NixRecorder_retain, NixRecorder_release> {
+public:
+    using Handle::Handle;
+    //callback, 'fn' is called as fn(const STNixAudioDesc& desc, Span<const NixUI8> data, NixUI32 blocksCount) and must outlive the capture.
+    template<typename F>
+    bool            setCallback(F* fn) { return NixRecorder_setCallback(ref_, (fn != NULL ? &Recorder::callback_<F> : NULL), (void*)fn) != NIX_FALSE; }
+    bool            clearCallback() { return NixRecorder_setCallback(ref_, NULL, NULL) != NIX_FALSE; }
+    //
+    bool            start() { return NixRecorder_start(ref_) != NIX_FALSE; }
+    bool            stop() { return NixRecorder_stop(ref_) != NIX_FALSE; }
+    bool            flush(const bool includeCurrentPartialBuff, const bool discardWithoutNotifying) { return NixRecorder_flush(ref_, includeCurrentPartialBuff ? NIX_TRUE : NIX_FALSE, discardWithoutNotifying ? NIX_TRUE : NIX_FALSE) != NIX_FALSE; }
+    bool            isCapturing() const { return NixRecorder_isCapturing(ref_) != NIX_FALSE; }
+    NixUI32         getBuffersFilledCount(NixUI32* optDstBytesCount = NULL, NixUI32* optDstBlocksCount = NULL, NixUI32* optDstMsecsCount = NULL) const { return NixRecorder_getBuffersFilledCount(ref_, optDstBytesCount, optDstBlocksCount, optDstMsecsCount); }
+    bool            getCounters(STNixRecorderCounters& dst) const { return NixRecorder_getCounters(ref_, &dst) != NIX_FALSE; }
+private:
+    template<typename F>
+    static void     callback_(STNixEngineRef* /*eng*/, STNixRecorderRef* /*rec*/, const STNixAudioDesc audioDesc, const NixUI8* audioData, const NixUI32 audioDataBytes, const NixUI32 blocksCount, void* userdata){ (*(F*)userdata)(audioDesc, Span<const NixUI8>(audioData, audioDataBytes), blocksCount); }
+};
+
+//------
+//BufferPool
+//------
+
+class BufferPool {
+public:
+    BufferPool() noexcept { ref_.ptr = NULL; }
+    explicit BufferPool(const STNixBufferPoolRef ref) noexcept : ref_(ref) {} //adopts the reference (no retain)
+    BufferPool(BufferPool&& other) noexcept : ref_(other.ref_) { other.ref_.ptr = NULL; }
+    BufferPool& operator=(BufferPool&& other) noexcept { if(this != &other){ reset(); ref_ = other.ref_; other.ref_.ptr = NULL; } return *this; }
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    ~BufferPool(){ reset(); }
+    //
+    static BufferPool create(const Context& ctx, const NixUI32 maxIdlePerFmt) { return BufferPool(NixBufferPool_alloc(ctx.get(), maxIdlePerFmt)); }
+    BufferPool      copy() const noexcept { if(ref_.ptr != NULL){ NixBufferPool_retain(ref_); } return BufferPool(ref_); }
+    void            reset() noexcept { if(ref_.ptr != NULL){ NixBufferPool_release(&ref_); ref_.ptr = NULL; } }
+    const STNixBufferPoolRef& get() const noexcept { return ref_; }
+    bool            isNull() const noexcept { return (ref_.ptr == NULL); }
+    explicit operator bool() const noexcept { return (ref_.ptr != NULL); }
+    //
+    NixUI32         prepare(const STNixAudioDesc& desc, const NixUI32 capacityBytes, const NixUI32 count) { return NixBufferPool_prepare(ref_, &desc, capacityBytes, count); }
+    Buffer          acquire(const STNixAudioDesc& desc, const NixUI32 capacityBytes) { return Buffer(NixBufferPool_acquire(ref_, &desc, capacityBytes)); }
+private:
+    STNixBufferPoolRef ref_;
+};
+
+//------
+//Engine
+//------
+
+class Engine : public Handle<Engine, STNixEngineRef, NixEngine_retain, NixEngine_release> {
+public:
+    using Handle::Handle;
+    static Engine   create(const Context& ctx, STNixApiItf* apiItf) { return Engine(NixEngine_alloc(ctx.get(), apiItf)); }
+    static Engine   create(const Context& ctx) { STNixApiItf apiItf; if(!NixApiItf_getDefaultApiForCurrentOS(&apiItf)){ return Engine(); } return Engine(NixEngine_alloc(ctx.get(), &apiItf)); }
+    //
+    void            printCaps() const { NixEngine_printCaps(ref_); }
+    bool            ctxIsActive() const { return NixEngine_ctxIsActive(ref_) != NIX_FALSE; }
+    bool            ctxActivate() { return NixEngine_ctxActivate(ref_) != NIX_FALSE; }
+    bool            ctxDeactivate() { return NixEngine_ctxDeactivate(ref_) != NIX_FALSE; }
+    void            tick() { NixEngine_tick(ref_); }
+    //factory
+    Source          allocSource() { return Source(NixEngine_allocSource(ref_)); }
+    Buffer          allocBuffer(const STNixAudioDesc& desc, const void* data, const NixUI32 bytes) { return Buffer(NixEngine_allocBuffer(ref_, &desc, (const NixUI8*)data, bytes)); }
+    Recorder        allocRecorder(const STNixAudioDesc& desc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer) { return Recorder(NixEngine_allocRecorder(ref_, &desc, buffersCount, blocksPerBuffer)); }
+    //voices
+    bool            playOneShot(const Buffer& buff, const NixFLOAT vol = 1.0f, const NixUI8 priority = 0) { return NixEngine_playOneShot(ref_, buff.get(), vol, priority) != NIX_FALSE; }
+    bool            setOneShotsLimit(const NixUI32 maxConcurrent, const ENNixOneShotSteal steal) { return NixEngine_setOneShotsLimit(ref_, maxConcurrent, steal) != NIX_FALSE; }
+    bool            setVoicesLimit(const NixUI32 maxReal) { return NixEngine_setVoicesLimit(ref_, maxReal) != NIX_FALSE; }
+    //batch
+    void            playSources(const Source* srcs, const NixUI32 srcsSz) { NixEngine_playSources(ref_, (const STNixSourceRef*)srcs, srcsSz); }
+    void            stopSources(const Source* srcs, const NixUI32 srcsSz) { NixEngine_stopSources(ref_, (const STNixSourceRef*)srcs, srcsSz); }
+    //clock
+    NixUI64         getFrameTime(NixUI32* optDstFramesPerSec = NULL) const { return NixEngine_getFrameTime(ref_, optDstFramesPerSec); }
+    //stats
+    bool            getStats(STNixEngineStats& dst) const { return NixEngine_getStats(ref_, &dst) != NIX_FALSE; }
+    //real-time threads
+    bool            setRtThreadOpts(const STNixRtThreadOpts& opts) { return NixEngine_setRtThreadOpts(ref_, &opts) != NIX_FALSE; }
+};
+
+//handles are arrays-compatible with the C refs (batch calls)
+static_assert(sizeof(Buffer) == sizeof(STNixBufferRef), "Nix::Buffer must wrap only the ref");
+static_assert(sizeof(Source) == sizeof(STNixSourceRef), "Nix::Source must wrap only the ref");
+
+} //namespace Nix
+
+#endif
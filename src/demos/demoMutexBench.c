@@ -0,0 +1,158 @@
+//
+//  demoMutexBench.c
+//  NixtlaDemo
+//
+//  Created by Marcos Ortega on 20/07/25.
+//  Copyright (c) 2014 Marcos Ortega. All rights reserved.
+//
+
+//
+// This demo compares the default mutex (OS mutex) against
+// the fast mutex (NixMutexItf_getFast) using the engine's
+// locking patterns:
+// - retain/release: one thread, uncontended (STNixSharedPtr).
+// - tick/callback: two threads locking the same queue
+//   with short critical sections (source's 'queues.mutex').
+// - sources: four threads locking random mutexes of
+//   a set of 64 (one per source, low contention).
+// - shared: four threads locking the same mutex (worst case).
+//
+// No audio device is used, it can be built alone:
+// cc -O2 -Iinclude -Isrc src/demos/demoMutexBench.c src/nixaudio/nixtla-audio.c src/nixaudio/nixtla-openal.c -lopenal -lpthread -lm
+//
+
+#include "NixDemosCommon.h"
+
+#include <stdio.h>  //printf
+#include <string.h> //memset
+
+#if defined(_WIN32) || defined(WIN32)
+    #include <windows.h> //CreateThread
+    #define DEMO_THREAD_T                       HANDLE
+    #define DEMO_THREAD_START(PTH, FUNC, PARAM) (*(PTH) = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)(FUNC), (PARAM), 0, NULL))
+    #define DEMO_THREAD_JOIN(TH)                { WaitForSingleObject(TH, INFINITE); CloseHandle(TH); }
+#else
+    #include <pthread.h> //pthread_create
+    #define DEMO_THREAD_T                       pthread_t
+    #define DEMO_THREAD_START(PTH, FUNC, PARAM) pthread_create((PTH), NULL, (void* (*)(void*))(FUNC), (PARAM))
+    #define DEMO_THREAD_JOIN(TH)                pthread_join(TH, NULL)
+#endif
+
+#define NIX_DEMO_BENCH_OPS          1000000 //lock/unlock per thread and pattern
+#define NIX_DEMO_BENCH_THREADS      4
+#define NIX_DEMO_BENCH_SOURCES      64
+
+//STNixDemoBenchState
+
+typedef struct STNixDemoBenchState_ {
+    STNixMutexRef   mutexes[NIX_DEMO_BENCH_SOURCES];
+    NixUI32         mutexesUse;
+    NixUI32         counters[NIX_DEMO_BENCH_SOURCES]; //protected by 'mutexes'
+    NixUI32         ops;
+    NixUI32         workPerLock;  //iterations inside the critical section
+} STNixDemoBenchState;
+
+typedef struct STNixDemoBenchThread_ {
+    STNixDemoBenchState* state;
+    NixUI32         seed;
+} STNixDemoBenchThread;
+
+static void* NixDemoBench_run_(void* param){
+    STNixDemoBenchThread* th = (STNixDemoBenchThread*)param;
+    STNixDemoBenchState* st = th->state;
+    NixUI32 seed = th->seed, i, w;
+    for(i = 0; i < st->ops; i++){
+        NixUI32 iMutex = 0;
+        if(st->mutexesUse > 1){
+            seed = seed * 1664525u + 1013904223u;
+            iMutex = (seed >> 16) % st->mutexesUse;
+        }
+        NixMutex_lock(st->mutexes[iMutex]);
+        {
+            for(w = 0; w < st->workPerLock; w++){
+                st->counters[iMutex]++;
+            }
+        }
+        NixMutex_unlock(st->mutexes[iMutex]);
+    }
+    return NULL;
+}
+
+//returns nanosecs per lock/unlock pair
+static double NixDemoBench_pattern_(STNixContextRef ctx, const NixUI32 threadsCount, const NixUI32 mutexesCount, const NixUI32 workPerLock){
+    double r = 0.0;
+    STNixDemoBenchState st;
+    STNixDemoBenchThread ths[NIX_DEMO_BENCH_THREADS];
+    DEMO_THREAD_T hndls[NIX_DEMO_BENCH_THREADS];
+    NixUI32 i, total = 0;
+    memset(&st, 0, sizeof(st));
+    st.ops          = NIX_DEMO_BENCH_OPS;
+    st.workPerLock  = workPerLock;
+    for(i = 0; i < mutexesCount && i < NIX_DEMO_BENCH_SOURCES; i++){
+        st.mutexes[st.mutexesUse++] = NixContext_mutex_alloc(ctx);
+    }
+    {
+        const NixUI64 startNs = NixClock_getMonotonicNs();
+        if(threadsCount <= 1){
+            ths[0].state = &st;
+            ths[0].seed  = 1;
+            NixDemoBench_run_(&ths[0]);
+        } else {
+            for(i = 0; i < threadsCount && i < NIX_DEMO_BENCH_THREADS; i++){
+                ths[i].state = &st;
+                ths[i].seed  = i + 1;
+                DEMO_THREAD_START(&hndls[i], NixDemoBench_run_, &ths[i]);
+            }
+            for(i = 0; i < threadsCount && i < NIX_DEMO_BENCH_THREADS; i++){
+                DEMO_THREAD_JOIN(hndls[i]);
+            }
+        }
+        r = (double)(NixClock_getMonotonicNs() - startNs) / (double)(NIX_DEMO_BENCH_OPS * (threadsCount > 0 ? threadsCount : 1));
+    }
+    //validate (a broken mutex loses increments)
+    for(i = 0; i < st.mutexesUse; i++){
+        total += st.counters[i];
+        NixMutex_free(&st.mutexes[i]);
+    }
+    if(total != NIX_DEMO_BENCH_OPS * (threadsCount > 0 ? threadsCount : 1) * workPerLock){
+        NIX_PRINTF_ERROR("NixDemoBench_pattern_, mutex failed, %u of %u increments.\n", total, NIX_DEMO_BENCH_OPS * (threadsCount > 0 ? threadsCount : 1) * workPerLock);
+    }
+    return r;
+}
+
+int main(void){
+    STNixContextItf itfs[2];
+    const char* names[2] = { "default", "fast" };
+    double results[2][4];
+    NixUI32 i, pass;
+    //interfaces
+    {
+        memset(&itfs[0], 0, sizeof(itfs[0]));
+        NixContextItf_fillMissingMembers(&itfs[0]);
+        memset(&itfs[1], 0, sizeof(itfs[1]));
+        itfs[1].mutex = NixMutexItf_getFast();
+        NixContextItf_fillMissingMembers(&itfs[1]);
+    }
+    //run (the first pass warms up caches and CPU frequency, discarded)
+    for(pass = 0; pass < 2; pass++){
+        for(i = 0; i < 2; i++){
+            STNixContextRef ctx = NixContext_alloc(&itfs[i]);
+            if(NixContext_isNull(ctx)){
+                NIX_PRINTF_ERROR("ERROR, NixContext_alloc failed.\n");
+                return -1;
+            }
+            results[i][0] = NixDemoBench_pattern_(ctx, 1, 1, 1);                                            //retain/release
+            results[i][1] = NixDemoBench_pattern_(ctx, 2, 1, 16);                                           //tick/callback
+            results[i][2] = NixDemoBench_pattern_(ctx, NIX_DEMO_BENCH_THREADS, NIX_DEMO_BENCH_SOURCES, 16); //sources
+            results[i][3] = NixDemoBench_pattern_(ctx, NIX_DEMO_BENCH_THREADS, 1, 16);                      //shared
+            NixContext_release(&ctx);
+            NixContext_null(&ctx);
+        }
+    }
+    //report
+    NIX_PRINTF_INFO("%-10s %16s %16s %16s %16s\n", "ns/lock", "retain/release", "tick/callback", "sources", "shared");
+    for(i = 0; i < 2; i++){
+        NIX_PRINTF_INFO("%-10s %16.1f %16.1f %16.1f %16.1f\n", names[i], results[i][0], results[i][1], results[i][2], results[i][3]);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+//
+//  demoTickBench.c
+//  NixtlaDemo
+//
+//  Created by Marcos Ortega on 20/07/25.
+//  Copyright (c) 2014 Marcos Ortega. All rights reserved.
+//
+
+//
+// This demo measures the cost of NixEngine_tick while the
+// amount of allocated sources grows (up to 10k) and only
+// a few of them are playing; idle sources are not visited
+// by the tick, its cost should follow the active sources
+// and not the allocated ones. The last row plays all the
+// allocated sources for comparison.
+//
+// Uses the default API for the current OS (an output device
+// is required). OpenAL implementations limit the sources
+// (OpenAL Soft: 256, see 'sources' in alsoft.conf); the
+// allocation stops at the limit and the totals reached are
+// reported. It can be built alone:
+// cc -O2 -Iinclude -Isrc src/demos/demoTickBench.c src/nixaudio/nixtla-audio.c src/nixaudio/nixtla-openal.c -lopenal -lpthread -lm
+//
+
+#include "NixDemosCommon.h"
+
+#include <stdio.h>  //printf
+#include <stdlib.h> //malloc, free
+#include <string.h> //memset
+
+#define NIX_DEMO_TICK_SOURCES       10000   //allocated at the last step
+#define NIX_DEMO_TICK_ACTIVE        8       //playing during the steps
+#define NIX_DEMO_TICK_STEPS         4       //allocated: 10, 100, 1000, 10000
+#define NIX_DEMO_TICK_WARMUP        16      //ticks discarded before each measure
+#define NIX_DEMO_TICK_TICKS         1000    //ticks per measure
+
+//STNixDemoTickBench
+
+typedef struct STNixDemoTickBench_ {
+    STNixEngineRef  eng;
+    STNixBufferRef  buff;       //silence, shared by the playing sources
+    STNixSourceRef* srcs;
+    NixUI32         srcsUse;
+    NixUI32         srcsPlaying; //the first ones
+} STNixDemoTickBench;
+
+//allocates idle sources up to 'total', returns NIX_FALSE if the backend refused one
+static NixBOOL NixDemoTickBench_grow_(STNixDemoTickBench* obj, const NixUI32 total){
+    NixBOOL r = NIX_TRUE;
+    while(obj->srcsUse < total){
+        STNixSourceRef src = NixEngine_allocSource(obj->eng);
+        if(NixSource_isNull(src)){
+            r = NIX_FALSE;
+            break;
+        }
+        obj->srcs[obj->srcsUse++] = src;
+    }
+    return r;
+}
+
+//plays the sources up to 'count' (looping the silence buffer)
+static void NixDemoTickBench_play_(STNixDemoTickBench* obj, const NixUI32 count){
+    while(obj->srcsPlaying < count && obj->srcsPlaying < obj->srcsUse){
+        STNixSourceRef src = obj->srcs[obj->srcsPlaying++];
+        if(!NixSource_setBuffer(src, obj->buff)){
+            NIX_PRINTF_ERROR("NixDemoTickBench_play_, NixSource_setBuffer failed.\n");
+        } else {
+            NixSource_setRepeat(src, NIX_TRUE);
+            NixSource_setVolume(src, 0.0f);
+            NixSource_play(src);
+        }
+    }
+}
+
+//returns nanosecs per tick
+static double NixDemoTickBench_measure_(STNixDemoTickBench* obj){
+    double r = 0.0;
+    NixUI32 i;
+    for(i = 0; i < NIX_DEMO_TICK_WARMUP; i++){
+        NixEngine_tick(obj->eng);
+    }
+    {
+        const NixUI64 startNs = NixClock_getMonotonicNs();
+        for(i = 0; i < NIX_DEMO_TICK_TICKS; i++){
+            NixEngine_tick(obj->eng);
+        }
+        r = (double)(NixClock_getMonotonicNs() - startNs) / (double)NIX_DEMO_TICK_TICKS;
+    }
+    return r;
+}
+
+static void NixDemoTickBench_report_(STNixDemoTickBench* obj, const char* name){
+    const double nsPerTick = NixDemoTickBench_measure_(obj);
+    STNixEngineStats stats;
+    memset(&stats, 0, sizeof(stats));
+    NixEngine_getStats(obj->eng, &stats);
+    NIX_PRINTF_INFO("%-12s %10u %10u %14.1f\n", name, stats.sourcesTotal, stats.sourcesActive, nsPerTick);
+}
+
+int main(void){
+    STNixContextItf ctxItf;
+    STNixContextRef ctx;
+    STNixApiItf apiItf;
+    STNixDemoTickBench bench;
+    memset(&bench, 0, sizeof(bench));
+    memset(&ctxItf, 0, sizeof(ctxItf));
+    NixContextItf_fillMissingMembers(&ctxItf);
+    ctx = NixContext_alloc(&ctxItf);
+    if(NixContext_isNull(ctx)){
+        NIX_PRINTF_ERROR("ERROR, NixContext_alloc failed.\n");
+        return -1;
+    } else if(!NixApiItf_getDefaultApiForCurrentOS(&apiItf)){
+        NIX_PRINTF_ERROR("ERROR, NixApiItf_getDefaultApiForCurrentOS failed.\n");
+        return -1;
+    }
+    bench.eng = NixEngine_alloc(ctx, &apiItf);
+    if(NixEngine_isNull(bench.eng)){
+        NIX_PRINTF_ERROR("ERROR, NixEngine_alloc failed.\n");
+        return -1;
+    }
+    bench.srcs = (STNixSourceRef*)malloc(sizeof(STNixSourceRef) * NIX_DEMO_TICK_SOURCES);
+    //buffer (one second of silence)
+    {
+        STNixAudioDesc desc = STNixAudioDesc_Zero;
+        NixUI8* silence;
+        desc.samplesFormat  = ENNixSampleFmt_Int;
+        desc.channels       = 1;
+        desc.bitsPerSample  = 16;
+        desc.samplerate     = 44100;
+        desc.blockAlign     = 2;
+        silence = (NixUI8*)malloc(desc.samplerate * desc.blockAlign);
+        if(silence != NULL){
+            memset(silence, 0, desc.samplerate * desc.blockAlign);
+            bench.buff = NixEngine_allocBuffer(bench.eng, &desc, silence, desc.samplerate * desc.blockAlign);
+            free(silence);
+        }
+    }
+    if(bench.srcs == NULL || NixBuffer_isNull(bench.buff)){
+        NIX_PRINTF_ERROR("ERROR, could not allocate the sources array or buffer.\n");
+    } else {
+        NixUI32 step, total = 10;
+        NixBOOL isLimited = NIX_FALSE;
+        NIX_PRINTF_INFO("%-12s %10s %10s %14s\n", "target", "sources", "active", "ns/tick");
+        for(step = 0; step < NIX_DEMO_TICK_STEPS && !isLimited; step++, total *= 10){
+            char name[16];
+            if(!NixDemoTickBench_grow_(&bench, total)){
+                NIX_PRINTF_WARNING("backend refused source #%u (limit reached).\n", bench.srcsUse + 1);
+                isLimited = NIX_TRUE;
+            }
+            NixDemoTickBench_play_(&bench, NIX_DEMO_TICK_ACTIVE);
+            snprintf(name, sizeof(name), "%u", total);
+            NixDemoTickBench_report_(&bench, name);
+        }
+        //all playing (tick visits every source)
+        NixDemoTickBench_play_(&bench, bench.srcsUse);
+        NixDemoTickBench_report_(&bench, "all-active");
+    }
+    //release
+    if(bench.srcs != NULL){
+        NixUI32 i; for(i = 0; i < bench.srcsUse; i++){
+            NixSource_stop(bench.srcs[i]);
+            NixSource_release(&bench.srcs[i]);
+            NixSource_null(&bench.srcs[i]);
+        }
+        free(bench.srcs);
+        bench.srcs = NULL;
+    }
+    if(!NixBuffer_isNull(bench.buff)){
+        NixBuffer_release(&bench.buff);
+        NixBuffer_null(&bench.buff);
+    }
+    NixEngine_release(&bench.eng);
+    NixEngine_null(&bench.eng);
+    NixContext_release(&ctx);
+    NixContext_null(&ctx);
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "nixaudio/nixtla-audio.h"
 #include "nixtla-aaudio.h"
 #include <string.h> //for memset()
+#include <time.h>   //for CLOCK_MONOTONIC
 
 #ifdef __ANDROID__
 #   include <aaudio/AAudio.h>
@@ -45,6 +46,14 @@ void            nixAAudioEngine_tick(STNixEngineRef ref);
 STNixSourceRef  nixAAudioEngine_allocSource(STNixEngineRef ref);
 STNixBufferRef  nixAAudioEngine_allocBuffer(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 STNixRecorderRef nixAAudioEngine_allocRecorder(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
+//One-shots
+NixBOOL         nixAAudioEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+NixBOOL         nixAAudioEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal);
+//Clock
+NixUI64         nixAAudioEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec);
+//Stats
+NixBOOL         nixAAudioEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst);
+NixBOOL         nixAAudioEngine_setRtThreadOpts(STNixEngineRef ref, const STNixRtThreadOpts* opts);
 //Source
 STNixSourceRef  nixAAudioSource_alloc(STNixEngineRef eng);
 void            nixAAudioSource_free(STNixSourceRef ref);
@@ -60,9 +69,21 @@ NixBOOL         nixAAudioSource_isRepeat(STNixSourceRef ref);
 NixFLOAT        nixAAudioSource_getVolume(STNixSourceRef ref);
 NixBOOL         nixAAudioSource_setBuffer(STNixSourceRef ref, STNixBufferRef buff);  //static-source
 NixBOOL         nixAAudioSource_queueBuffer(STNixSourceRef ref, STNixBufferRef buff); //stream-source
+NixBOOL         nixAAudioSource_queueBufferMove(STNixSourceRef ref, STNixBufferRef* buff); //stream-source
 NixBOOL         nixAAudioSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset); //relative to first buffer in queue
 NixUI32         nixAAudioSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);   //all buffer queue
 NixUI32         nixAAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //relative to first buffer in queue
+//Scheduling
+NixBOOL         nixAAudioSource_playAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         nixAAudioSource_stopAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         nixAAudioSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames);
+//Counters
+NixBOOL         nixAAudioSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst);
+NixBOOL         nixAAudioSource_getClock(STNixSourceRef ref, STNixSourceClock* dst);
+//Low watermark
+NixBOOL         nixAAudioSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
+//Render
+NixBOOL         nixAAudioSource_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData);
 //Recorder
 STNixRecorderRef nixAAudioRecorder_alloc(STNixEngineRef eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
 void            nixAAudioRecorder_free(STNixRecorderRef ref);
@@ -72,6 +93,7 @@ NixBOOL         nixAAudioRecorder_stop(STNixRecorderRef ref);
 NixBOOL         nixAAudioRecorder_flush(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying);
 NixBOOL         nixAAudioRecorder_isCapturing(STNixRecorderRef ref);
 NixUI32         nixAAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);
+NixBOOL         nixAAudioRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst);
 
 NixBOOL nixAAudioEngine_getApiItf(STNixApiItf* dst){
     NixBOOL r = NIX_FALSE;
@@ -88,6 +110,14 @@ NixBOOL nixAAudioEngine_getApiItf(STNixApiItf* dst){
         dst->engine.allocSource = nixAAudioEngine_allocSource;
         dst->engine.allocBuffer = nixAAudioEngine_allocBuffer;
         dst->engine.allocRecorder = nixAAudioEngine_allocRecorder;
+        //One-shots
+        dst->engine.playOneShot = nixAAudioEngine_playOneShot;
+        dst->engine.setOneShotsLimit = nixAAudioEngine_setOneShotsLimit;
+        //Clock
+        dst->engine.getFrameTime = nixAAudioEngine_getFrameTime;
+        //Stats
+        dst->engine.getStats = nixAAudioEngine_getStats;
+        dst->engine.setRtThreadOpts = nixAAudioEngine_setRtThreadOpts;
         //PCMBuffer
         NixPCMBuffer_getApiItf(&dst->buffer);
         //Source
@@ -105,9 +135,21 @@ NixBOOL nixAAudioEngine_getApiItf(STNixApiItf* dst){
         dst->source.getVolume   = nixAAudioSource_getVolume;
         dst->source.setBuffer   = nixAAudioSource_setBuffer;  //static-source
         dst->source.queueBuffer = nixAAudioSource_queueBuffer; //stream-source
+        dst->source.queueBufferMove = nixAAudioSource_queueBufferMove; //stream-source
         dst->source.setBufferOffset = nixAAudioSource_setBufferOffset; //relative to first buffer in queue
         dst->source.getBuffersCount = nixAAudioSource_getBuffersCount; //all buffer queue
         dst->source.getBlocksOffset = nixAAudioSource_getBlocksOffset; //relative to first buffer in queue
+        //Scheduling
+        dst->source.playAt      = nixAAudioSource_playAt;
+        dst->source.stopAt      = nixAAudioSource_stopAt;
+        dst->source.getStartError = nixAAudioSource_getStartError;
+        //Counters
+        dst->source.getCounters = nixAAudioSource_getCounters;
+        dst->source.getClock    = nixAAudioSource_getClock;
+        //Low watermark
+        dst->source.setLowWatermark = nixAAudioSource_setLowWatermark;
+        //Render
+        dst->source.setRenderCallback = nixAAudioSource_setRenderCallback;
         //Recorder
         dst->recorder.alloc     = nixAAudioRecorder_alloc;
         dst->recorder.free      = nixAAudioRecorder_free;
@@ -117,6 +159,7 @@ NixBOOL nixAAudioEngine_getApiItf(STNixApiItf* dst){
         dst->recorder.flush     = nixAAudioRecorder_flush;
         dst->recorder.isCapturing = nixAAudioRecorder_isCapturing;
         dst->recorder.getBuffersFilledCount = nixAAudioRecorder_getBuffersFilledCount;
+        dst->recorder.getCounters = nixAAudioRecorder_getCounters;
         //
         r = NIX_TRUE;
     }
@@ -170,6 +213,9 @@ NixBOOL nixAAudioEngine_getApiItf(STNixApiItf* dst){
 #   define AAudioStream_getSampleRate(S)                44100
 #   define AAudioStream_getChannelCount(S)              2
 #   define AAudioStream_getFormat(S)                    AAUDIO_FORMAT_PCM_I16
+#   define AAudioStream_getTimestamp(S, C, F, T)        AAUDIO_ERROR_INVALID_STATE
+#   define AAudioStream_getFramesWritten(S)             0
+#   define AAudioStream_getBufferSizeInFrames(S)        0
 //
 #   define AAudio_convertResultToText(C)                ""
 //
@@ -238,6 +284,16 @@ struct STNixAAudioQueue_;
 struct STNixAAudioQueuePair_;
 struct STNixAAudioRecorder_;
 
+//------
+//Sources snapshot (immutable, reference counted)
+//------
+
+typedef struct STNixAAudioSrcsSnap_ {
+    volatile NixUI32        retainCount;
+    NixUI32                 use;
+    struct STNixAAudioSource_**  arr;    //allocated after this header
+} STNixAAudioSrcsSnap;
+
 //------
 //Engine
 //------
@@ -245,20 +301,38 @@ struct STNixAAudioRecorder_;
 typedef struct STNixAAudioEngine_ {
     STNixContextRef ctx;
     STNixApiItf     apiItf;
-    //srcs
+    STNixOneShots   oneShots;   //fire-and-forget voices
+    STNixEngineClock clock;     //timeline of the scheduling calls
+    STNixEngineStatsState stats;
+    STNixRtThreadState rt;      //options for the callback threads
+    //srcs (published as immutable snapshots, replaced on add/remove)
     struct {
-        STNixMutexRef       mutex;
-        struct STNixAAudioSource_** arr;
-        NixUI32             use;
-        NixUI32             sz;
+        volatile NixUI32    readers; //retains in progress (lock-free, writers wait for them before releasing a replaced snapshot)
+        struct STNixAAudioSrcsSnap_* cur;
         NixUI32             changingStateCountHint;
     } srcs;
+    //actv (sources with pending work, intrusive list; idle sources are not visited by tick)
+    struct {
+        STNixMutexRef       mutex;
+        struct STNixAAudioSource_* first;
+        NixUI32             use;
+        //tick (snapshot of the list, only accessed by tick)
+        struct {
+            struct STNixAAudioSource_** arr;
+            NixUI32         use;
+            NixUI32         sz;
+        } tick;
+    } actv;
     struct STNixAAudioRecorder_* rec;
 } STNixAAudioEngine;
 
 void NixAAudioEngine_init(STNixContextRef ctx, STNixAAudioEngine* obj);
 void NixAAudioEngine_destroy(STNixAAudioEngine* obj);
 NixBOOL NixAAudioEngine_srcsAdd(STNixAAudioEngine* obj, struct STNixAAudioSource_* src);
+NixBOOL NixAAudioEngine_srcsRemove(STNixAAudioEngine* obj, struct STNixAAudioSource_* src);
+STNixAAudioSrcsSnap* NixAAudioEngine_srcsRetain(STNixAAudioEngine* obj);
+void NixAAudioEngine_srcsRelease(STNixAAudioEngine* obj, STNixAAudioSrcsSnap* snap);
+void NixAAudioEngine_actvAdd(STNixAAudioEngine* obj, struct STNixAAudioSource_* src);
 void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup);
 
 //------
@@ -307,6 +381,7 @@ typedef struct STNixAAudioSource_ {
     STNixAudioDesc          buffsFmt;   //first attached buffers' format (defines the converter config)
     STNixAudioDesc          srcFmt;
     AAudioStream*           src;
+    NixUI32                 rtSeq;  //'eng->rt' applied to the callback thread
     //queues
     struct {
         STNixMutexRef       mutex;
@@ -317,17 +392,47 @@ typedef struct STNixAAudioSource_ {
         STNixAAudioQueue    pend;   //to be played/filled
         NixUI32             pendBlockIdx;  //current sample playing/filling
     } queues;
+    //counters (protected by queues.mutex)
+    struct {
+        NixUI64             queued;     //frames of buffsFmt
+        NixUI64             queuedOut;  //frames of srcFmt (after conversion), to report 'played' exactly at the buffers' boundaries
+        volatile NixUI64    played;     //frames of srcFmt (fed to the stream), NIX_ATOMIC_ADD64 (device thread must not lock)
+        STNixPosInterp      clock;      //NixSource_getClock interpolation (when the stream has no timestamp)
+    } counters;
+    STNixSourceWatermark    wmark;      //low watermark (protected by queues.mutex, checked by tick)
+    STNixSourceRender       render;     //pull-model (set once, called by the stream callback)
+    //drain (protected by queues.mutex; one underrun per drain of the queue, only if more data was expected)
+    struct {
+        NixBOOL             isFed;      //buffers were queued since the last drain (or stop)
+        NixBOOL             isDrained;  //ran out while playing without a watermark, counted if refilled
+    } drain;
+    //sched (protected by queues.mutex, applied by the stream callback)
+    struct {
+        NixUI64             startNs;    //CLOCK_MONOTONIC, zero if none
+        NixUI64             stopNs;     //CLOCK_MONOTONIC, zero if none
+        NixSI64             startErr;   //engine frames (positive is late)
+        NixBOOL             isStartErrSet;
+        NixBOOL             isStopReached; //stopped by the callback, pending to be stopped by tick
+        volatile NixUI32    isPendHint; //read by the stream callback before calculating the presentation time
+    } sched;
     //props
     float                   volume;
     NixUI8                  stateBits;  //packed bools to reduce padding, NIX_AAudioSource_BIT_
+    //actv (link at engine's active list, protected by eng->actv.mutex)
+    struct {
+        struct STNixAAudioSource_* prev;
+        struct STNixAAudioSource_* next;
+        NixBOOL             isLinked;
+    } actv;
 } STNixAAudioSource;
 
 void NixAAudioSource_init(STNixContextRef ctx, STNixAAudioSource* obj);
 void NixAAudioSource_destroy(STNixAAudioSource* obj);
-NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBufferRef pBuff);
-NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* dst, const NixUI32 samplesMax, NixBOOL* dstExplicitStop);
+NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBufferRef pBuff, const NixBOOL isMove); //isMove: the caller's reference is consumed on success
+NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* dst, const NixUI32 samplesMax, const NixUI64 dstStartNs, NixBOOL* dstExplicitStop); //dstStartNs: presentation time of dst's first sample (zero if unknown)
 NixBOOL NixAAudioSource_pendPopOldestBuffLocked_(STNixAAudioSource* obj);
 NixBOOL NixAAudioSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixAAudioSource* obj);
+NixUI32 NixAAudioSource_getQueuedBlocksLocked_(STNixAAudioSource* obj); //frames pending to be fed to the stream (buffsFmt)
 
 #define NIX_AAudioSource_BIT_isStatic   (0x1 << 0)  //source expects only one buffer, repeats or pauses after playing it
 #define NIX_AAudioSource_BIT_isChanging (0x1 << 1)  //source is changing state after a call to request*()
@@ -362,6 +467,9 @@ typedef struct STNixAAudioRecorder_ {
     NixBOOL                 engStarted;
     STNixEngineRef          engRef;
     STNixRecorderRef        selfRef;
+    STNixEngineStatsState*  stats;  //engine's ('engRef' is retained)
+    STNixRtThreadState*     rt;     //engine's ('engRef' is retained)
+    NixUI32                 rtSeq;  //'rt' applied to the callback thread
     AAudioStream*           rec;
     STNixAudioDesc          capFmt;
     //callback
@@ -386,6 +494,10 @@ typedef struct STNixAAudioRecorder_ {
             NixSI32         iCurSample; //at first buffer in 'reuse'
         } filling;
     } queues;
+    //counters (protected by queues.mutex, frames of cfg.fmt)
+    struct {
+        NixUI64             captured;
+    } counters;
 } STNixAAudioRecorder;
 
 void NixAAudioRecorder_init(STNixContextRef ctx,STNixAAudioRecorder* obj);
@@ -408,26 +520,53 @@ void NixAAudioEngine_init(STNixContextRef ctx, STNixAAudioEngine* obj){
     //
     NixContext_set(&obj->ctx, ctx);
     nixAAudioEngine_getApiItf(&obj->apiItf);
-    //srcs
+    //oneShots
     {
-        obj->srcs.mutex = NixContext_mutex_alloc(obj->ctx);
+        NixOneShots_init(obj->ctx, &obj->oneShots);
+    }
+    //clock
+    {
+        NixEngineClock_init(&obj->clock, NIX_ENGINE_CLOCK_RATE);
+    }
+    //stats
+    {
+        NixEngineStats_init(&obj->stats);
+    }
+    //real-time threads
+    {
+        NixRtThreadState_init(&obj->rt);
+    }
+    //actv
+    {
+        obj->actv.mutex = NixContext_mutex_alloc(obj->ctx);
     }
 }
 
    
 void NixAAudioEngine_destroy(STNixAAudioEngine* obj){
+    //oneShots (released before sources cleanup)
+    NixOneShots_destroy(&obj->oneShots);
     //srcs
     {
         //cleanup
-        while(obj->srcs.arr != NULL && obj->srcs.use > 0){
+        while(obj->srcs.cur != NULL && obj->srcs.cur->use > 0){
             NixAAudioEngine_tick(obj, NIX_TRUE);
         }
         //
-        if(obj->srcs.arr != NULL){
-            NixContext_mfree(obj->ctx, obj->srcs.arr);
-            obj->srcs.arr = NULL;
+        if(obj->srcs.cur != NULL){
+            NixAAudioEngine_srcsRelease(obj, obj->srcs.cur);
+            obj->srcs.cur = NULL;
+        }
+    }
+    //actv
+    {
+        NIX_ASSERT(obj->actv.first == NULL && obj->actv.use == 0) //all sources should be removed
+        if(obj->actv.tick.arr != NULL){
+            NIX_RT_MFREE(obj->ctx, obj->actv.tick.arr);
+            obj->actv.tick.arr = NULL;
         }
-        NixMutex_free(&obj->srcs.mutex);
+        obj->actv.tick.use = obj->actv.tick.sz = 0;
+        NixMutex_free(&obj->actv.mutex);
     }
     //rec (recorder)
     if(obj->rec != NULL){
@@ -437,56 +576,173 @@ void NixAAudioEngine_destroy(STNixAAudioEngine* obj){
     NixContext_null(&obj->ctx);
 }
 
-NixBOOL NixAAudioEngine_srcsAdd(STNixAAudioEngine* obj, struct STNixAAudioSource_* src){
-    NixBOOL r = NIX_FALSE;
-    if(obj != NULL){
-        NixMutex_lock(obj->srcs.mutex);
-        {
-            //resize array (if necesary)
-            if(obj->srcs.use >= obj->srcs.sz){
-                const NixUI32 szN = obj->srcs.use + 4;
-                STNixAAudioSource** arrN = (STNixAAudioSource**)NixContext_mrealloc(obj->ctx, obj->srcs.arr, sizeof(STNixAAudioSource*) * szN, "STNixAAudioEngine::srcsN");
-                if(arrN != NULL){
-                    obj->srcs.arr = arrN;
-                    obj->srcs.sz = szN;
+STNixAAudioSrcsSnap* NixAAudioEngine_srcsRetain(STNixAAudioEngine* obj){
+    STNixAAudioSrcsSnap* r = NULL;
+    //lock-free; 'readers' keeps writers from releasing the loaded snapshot before it is retained
+    NIX_ATOMIC_ADD32(&obj->srcs.readers, 1);
+    {
+        r = (STNixAAudioSrcsSnap*)NIX_ATOMIC_LOADPTR(&obj->srcs.cur);
+        if(r != NULL){
+            NIX_ATOMIC_ADD32(&r->retainCount, 1);
+        }
+    }
+    NIX_ATOMIC_SUB32(&obj->srcs.readers, 1);
+    return r;
+}
+
+void NixAAudioEngine_srcsRelease(STNixAAudioEngine* obj, STNixAAudioSrcsSnap* snap){
+    if(snap != NULL){
+        if(NIX_ATOMIC_SUB32(&snap->retainCount, 1) == 0){
+            NIX_RT_MFREE(obj->ctx, snap);
+        }
+    }
+}
+
+//Builds a copy of the current snapshot, with or without 'src' (if 'add'), and publishes it.
+//Lock-free: the copy is built outside any lock and swapped only if its base is still current.
+NixBOOL NixAAudioEngine_srcsPublish_(STNixAAudioEngine* obj, struct STNixAAudioSource_* src, const NixBOOL add){
+    NixBOOL r = NIX_FALSE, isDone = NIX_FALSE;
+    while(!isDone){
+        STNixAAudioSrcsSnap* cur = NixAAudioEngine_srcsRetain(obj); //base of the copy (retained, can't be reused while compared)
+        const NixUI32 curUse = (cur != NULL ? cur->use : 0);
+        const NixUI32 szN = (add ? curUse + 1 : curUse);
+        STNixAAudioSrcsSnap* snapN = (STNixAAudioSrcsSnap*)NixContext_malloc(obj->ctx, sizeof(STNixAAudioSrcsSnap) + (sizeof(STNixAAudioSource*) * szN), "STNixAAudioEngine::srcs.snapN");
+        if(snapN == NULL){
+            NIX_PRINTF_ERROR("NixAAudioEngine_srcsPublish_::NixContext_malloc failed.\n");
+            isDone = NIX_TRUE;
+        } else {
+            NixUI32 i;
+            NixBOOL isChanged = NIX_FALSE;
+            snapN->retainCount = 1; //owned by the engine
+            snapN->use = 0;
+            snapN->arr = (STNixAAudioSource**)(snapN + 1);
+            for(i = 0; i < curUse; ++i){
+                if(cur->arr[i] != src){
+                    snapN->arr[snapN->use++] = cur->arr[i];
                 }
             }
-            //add
-            if(obj->srcs.use >= obj->srcs.sz){
-                NIX_PRINTF_ERROR("nixAAudioSource_create::STNixAAudioEngine::srcs failed (no allocated space).\n");
+            if(add){
+                snapN->arr[snapN->use++] = src;
+            }
+            isChanged = (add || snapN->use < curUse); //read before the swap (other writers can replace and release it)
+            //publish (readers retaining 'cur' keep it alive until released)
+            if(!NIX_ATOMIC_CASPTR(&obj->srcs.cur, cur, snapN)){
+                //other writer published first, retry from its snapshot
+                NIX_RT_MFREE(obj->ctx, snapN);
             } else {
-                //become the owner of the pair
-                obj->srcs.arr[obj->srcs.use++] = src;
-                r = NIX_TRUE;
+                r = isChanged;
+                //wait for readers that loaded 'cur' but did not retain it yet (RMW, ordered after the swap)
+                while(NIX_ATOMIC_ADD32(&obj->srcs.readers, 0) != 0){
+                    NIX_CPU_RELAX();
+                }
+                NixAAudioEngine_srcsRelease(obj, cur); //engine's reference
+                isDone = NIX_TRUE;
             }
         }
-        NixMutex_unlock(obj->srcs.mutex);
+        NixAAudioEngine_srcsRelease(obj, cur);
+    }
+    return r;
+}
+
+NixBOOL NixAAudioEngine_srcsAdd(STNixAAudioEngine* obj, struct STNixAAudioSource_* src){
+    NixBOOL r = NIX_FALSE;
+    if(obj != NULL && src != NULL){
+        r = NixAAudioEngine_srcsPublish_(obj, src, NIX_TRUE);
+    }
+    return r;
+}
+
+NixBOOL NixAAudioEngine_srcsRemove(STNixAAudioEngine* obj, struct STNixAAudioSource_* src){
+    NixBOOL r = NIX_FALSE;
+    if(obj != NULL && src != NULL){
+        r = NixAAudioEngine_srcsPublish_(obj, src, NIX_FALSE);
     }
     return r;
 }
 
-void NixAAudioEngine_removeSrcRecordLocked_(STNixAAudioEngine* obj, NixSI32* idx){
-    STNixAAudioSource* src = obj->srcs.arr[*idx];
-    if(src != NULL){
-        NixAAudioSource_destroy(src);
-        NixContext_mfree(obj->ctx, src);
+void NixAAudioEngine_actvRemoveLocked_(STNixAAudioEngine* obj, STNixAAudioSource* src){
+    if(src->actv.isLinked){
+        if(src->actv.prev != NULL){
+            src->actv.prev->actv.next = src->actv.next;
+        } else {
+            NIX_ASSERT(obj->actv.first == src) //program logic error
+            obj->actv.first = src->actv.next;
+        }
+        if(src->actv.next != NULL){
+            src->actv.next->actv.prev = src->actv.prev;
+        }
+        src->actv.prev = src->actv.next = NULL;
+        src->actv.isLinked = NIX_FALSE;
+        NIX_ASSERT(obj->actv.use > 0) //program logic error
+        --obj->actv.use;
+    }
+}
+
+void NixAAudioEngine_actvAddLocked_(STNixAAudioEngine* obj, STNixAAudioSource* src){
+    if(!src->actv.isLinked){
+        src->actv.prev = NULL;
+        src->actv.next = obj->actv.first;
+        if(obj->actv.first != NULL){
+            obj->actv.first->actv.prev = src;
+        }
+        obj->actv.first = src;
+        src->actv.isLinked = NIX_TRUE;
+        ++obj->actv.use;
     }
-    //fill gap
-    --obj->srcs.use;
+}
+
+void NixAAudioEngine_actvAdd(STNixAAudioEngine* obj, STNixAAudioSource* src){
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
     {
-        NixUI32 i2;
-        for(i2 = *idx; i2 < obj->srcs.use; ++i2){
-            obj->srcs.arr[i2] = obj->srcs.arr[i2 + 1];
+        NixAAudioEngine_actvAddLocked_(obj, src);
+    }
+    NixMutex_unlock(obj->actv.mutex);
+}
+
+//Moves the active list to 'actv.tick.arr'; sources flagged while ticking are linked for the next tick.
+void NixAAudioEngine_actvTakeForTick_(STNixAAudioEngine* obj){
+    obj->actv.tick.use = 0;
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
+    {
+        //resize array (if necesary)
+        if(obj->actv.tick.sz < obj->actv.use){
+            const NixUI32 szN = obj->actv.use + 4;
+            STNixAAudioSource** arrN = (STNixAAudioSource**)NixContext_mrealloc(obj->ctx, obj->actv.tick.arr, sizeof(STNixAAudioSource*) * szN, "STNixAAudioEngine::actv.tick.arrN");
+            if(arrN != NULL){
+                obj->actv.tick.arr = arrN;
+                obj->actv.tick.sz = szN;
+            }
+        }
+        //move
+        while(obj->actv.first != NULL && obj->actv.tick.use < obj->actv.tick.sz){
+            STNixAAudioSource* src = obj->actv.first;
+            NixAAudioEngine_actvRemoveLocked_(obj, src);
+            obj->actv.tick.arr[obj->actv.tick.use++] = src;
         }
     }
-    *idx = *idx - 1; //process record again
+    NixMutex_unlock(obj->actv.mutex);
+}
+
+void NixAAudioEngine_removeSrc_(STNixAAudioEngine* obj, STNixAAudioSource* src){
+    //unlink (could be re-flagged as active while ticking)
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
+    {
+        NixAAudioEngine_actvRemoveLocked_(obj, src);
+    }
+    NixMutex_unlock(obj->actv.mutex);
+    //remove record (only tick reads snapshots, no other thread will reach this source)
+    if(!NixAAudioEngine_srcsRemove(obj, src)){
+        NIX_ASSERT(NIX_FALSE) //program logic error
+    }
+    NixAAudioSource_destroy(src);
+    NIX_RT_MFREE(obj->ctx, src);
 }
 
 void NixAAudioEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNixAAudioSource* src){
     if(src->queues.notify.use > 0){
         NixSI32 i; for(i = 0; i < src->queues.notify.use; i++){
             STNixAAudioQueuePair* pair = &src->queues.notify.arr[i];
-            if(!NixNotifQueue_addBuff(notifs, src->self, src->queues.callback, pair->org)){
+            if(!NixNotifQueue_addBuffMove(notifs, src->self, src->queues.callback, &pair->org)){
                 NIX_ASSERT(NIX_FALSE); //program logic error
             }
         }
@@ -498,18 +754,32 @@ void NixAAudioEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNix
     
 void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
     if(obj != NULL){
+        const NixUI64 nsStart = NixClock_getMonotonicNs();
+        NixUI32 buffsNotified = 0;
+        NIX_TRACE_BEGIN(trTick);
         //srcs
         {
             STNixNotifQueue notifs;
             NixNotifQueue_init(obj->ctx, &notifs);
-            NixMutex_lock(obj->srcs.mutex);
-            if(obj->srcs.arr != NULL && obj->srcs.use > 0){
+            //flag sources (snapshot, no lock is held while ticking)
+            if(isFinalCleanup){
+                STNixAAudioSrcsSnap* srcs = NixAAudioEngine_srcsRetain(obj);
+                if(srcs != NULL){
+                    NixUI32 i; for(i = 0; i < srcs->use; ++i){
+                        NixAAudioEngine_actvAdd(obj, srcs->arr[i]);
+                    }
+                    NixAAudioEngine_srcsRelease(obj, srcs);
+                    srcs = NULL;
+                }
+            }
+            NixAAudioEngine_actvTakeForTick_(obj);
+            {
                 NixUI32 changingStateCount = 0;
-                NixSI32 i; for(i = 0; i < (NixSI32)obj->srcs.use; ++i){
-                    STNixAAudioSource* src = obj->srcs.arr[i];
+                NixUI32 i; for(i = 0; i < obj->actv.tick.use; ++i){
+                    STNixAAudioSource* src = obj->actv.tick.arr[i];
                     if(src->src == NULL && NixAAudioSource_isOrphan(src)){
                         //remove
-                        NixAAudioEngine_removeSrcRecordLocked_(obj, &i);
+                        NixAAudioEngine_removeSrc_(obj, src);
                         src = NULL;
                     } else {
                         aaudio_stream_state_t state = AAUDIO_STREAM_STATE_UNKNOWN;
@@ -529,7 +799,7 @@ void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
                                     NixAAudioSource_setIsPaused(src, NIX_FALSE);
                                     NixAAudioSource_setIsChanging(src, NIX_FALSE);
                                     //move all pending buffers to notify
-                                    NixMutex_lock(src->queues.mutex);
+                                    NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                     {
                                         NixAAudioSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(src);
                                     }
@@ -550,7 +820,7 @@ void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
                                     NixAAudioSource_setIsPaused(src, NIX_FALSE);
                                     NixAAudioSource_setIsChanging(src, NIX_FALSE);
                                     //move all pending buffers to notify
-                                    NixMutex_lock(src->queues.mutex);
+                                    NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                     {
                                         NixAAudioSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(src);
                                         //add notif before removing
@@ -558,7 +828,7 @@ void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
                                     }
                                     NixMutex_unlock(src->queues.mutex);
                                     //release and remove
-                                    NixAAudioEngine_removeSrcRecordLocked_(obj, &i);
+                                    NixAAudioEngine_removeSrc_(obj, src);
                                     src = NULL;
                                     break;
                                 default:
@@ -590,25 +860,56 @@ void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
                             }
                             //add to notify queue
                             {
-                                NixMutex_lock(src->queues.mutex);
+                                NixBOOL isActive = NIX_FALSE, isStopReached = NIX_FALSE;
+                                NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                 {
                                     NixAAudioEngine_tick_addQueueNotifSrcLocked_(&notifs, src);
+                                    //scheduled stop reached by the callback
+                                    isStopReached = src->sched.isStopReached;
+                                    src->sched.isStopReached = NIX_FALSE;
+                                    //keep visiting while changing state, while the stream consumes buffers or while a schedule is pending
+                                    isActive = (NixAAudioSource_isChanging(src) || NixAAudioSource_isOrphan(src) || (!NixAAudioSource_isStatic(src) && NixAAudioSource_isPlaying(src) && !NixAAudioSource_isPaused(src) && src->queues.pend.use > 0) || (NixAAudioSource_isPlaying(src) && (src->sched.startNs != 0 || src->sched.stopNs != 0)));
+                                    //low watermark (polled while playing)
+                                    if(!NixAAudioSource_isStatic(src) && NixSourceWatermark_isEnabled(&src->wmark) && NixAAudioSource_isPlaying(src) && !NixAAudioSource_isPaused(src)){
+                                        const NixUI32 queued = NixAAudioSource_getQueuedBlocksLocked_(src);
+                                        NixUI32 deficit = 0;
+                                        if(NixSourceWatermark_check(&src->wmark, &src->buffsFmt, queued, &deficit)){
+                                            NixNotifQueue_addNeedsData(&notifs, src->self, &src->wmark, queued, deficit);
+                                        }
+                                        isActive = NIX_TRUE;
+                                    }
                                 }
                                 NixMutex_unlock(src->queues.mutex);
+                                if(isStopReached && !isFinalCleanup){
+                                    nixAAudioSource_stop(src->self);
+                                } else if(isActive){
+                                    NixAAudioEngine_actvAdd(obj, src);
+                                }
                             }
                         }
                     }
                 }
                 obj->srcs.changingStateCountHint = changingStateCount;
             }
-            NixMutex_unlock(obj->srcs.mutex);
             //notify (unloked)
             if(notifs.use > 0){
                 NixUI32 i; for(i = 0; i < notifs.use; ++i){
                     STNixSourceNotif* n = &notifs.arr[i];
                     if(n->callback.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*n->callback.func)(&n->source, n->buffs, n->buffsUse, n->callback.data);
+                        NIX_TRACE_END(trCall, "srcCallback", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
                     }
+                    if(n->needs.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
+                        (*n->needs.func)(&n->source, n->needs.queued, n->needs.deficit, n->needs.data);
+                        NIX_TRACE_END(trCall, "srcNeedsData", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
+                    }
+                    buffsNotified += n->buffsUse;
                 }
             }
             NixNotifQueue_destroy(&notifs);
@@ -617,6 +918,11 @@ void NixAAudioEngine_tick(STNixAAudioEngine* obj, const NixBOOL isFinalCleanup){
         if(obj->rec != NULL){
             NixAAudioRecorder_notifyBuffers(obj->rec, NIX_FALSE);
         }
+        NIX_TRACE_END(trTick, "tick", obj);
+        //stats
+        NixEngineStats_addTick(&obj->stats, NixClock_getMonotonicNs() - nsStart, buffsNotified);
+        //log (messages queued by this tick and the device threads)
+        NixLog_flush();
     }
 }
 
@@ -636,7 +942,7 @@ void NixAAudioQueuePair_destroy(STNixAAudioQueuePair* obj){
     }
     if(obj->cnv != NULL){
         NixPCMBuffer_destroy(obj->cnv);
-        NixContext_mfree(obj->ctx, obj->cnv);
+        NIX_RT_MFREE(obj->ctx, obj->cnv);
         obj->cnv = NULL;
     }
     NixContext_release(&obj->ctx);
@@ -644,15 +950,16 @@ void NixAAudioQueuePair_destroy(STNixAAudioQueuePair* obj){
 }
 
 void NixAAudioQueuePair_moveOrg(STNixAAudioQueuePair* obj, STNixAAudioQueuePair* to){
-    NixBuffer_set(&to->org, obj->org);
-    NixBuffer_release(&obj->org);
-    NixBuffer_null(&obj->org);
+    if(!NixBuffer_isNull(to->org)){
+        NixBuffer_release(&to->org);
+    }
+    to->org = NixBuffer_move(&obj->org);
 }
 
 void NixAAudioQueuePair_moveCnv(STNixAAudioQueuePair* obj, STNixAAudioQueuePair* to){
     if(to->cnv != NULL){
         NixPCMBuffer_destroy(to->cnv);
-        NixContext_mfree(to->ctx, to->cnv);
+        NIX_RT_MFREE(to->ctx, to->cnv);
         to->cnv = NULL;
     }
     to->cnv = obj->cnv;
@@ -674,7 +981,7 @@ void NixAAudioQueue_destroy(STNixAAudioQueue* obj){
             STNixAAudioQueuePair* b = &obj->arr[i];
             NixAAudioQueuePair_destroy(b);
         }
-        NixContext_mfree(obj->ctx, obj->arr);
+        NIX_RT_MFREE(obj->ctx, obj->arr);
         obj->arr = NULL;
     }
     obj->use = obj->sz = 0;
@@ -791,6 +1098,7 @@ void NixAAudioSource_init(STNixContextRef ctx, STNixAAudioSource* obj){
         NixAAudioQueue_init(ctx, &obj->queues.pend);
         NixAAudioQueue_init(ctx, &obj->queues.reuse);
     }
+    NixSourceRender_init(ctx, &obj->render);
 }
 
 void NixAAudioSource_destroy(STNixAAudioSource* obj){
@@ -815,11 +1123,12 @@ void NixAAudioSource_destroy(STNixAAudioSource* obj){
         NixAAudioQueue_destroy(&obj->queues.notify);
         NixMutex_free(&obj->queues.mutex);
     }
+    NixSourceRender_destroy(&obj->render);
     NixContext_release(&obj->ctx);
     NixContext_null(&obj->ctx);
 }
 
-NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBufferRef pBuff){
+NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBufferRef pBuff, const NixBOOL isMove){
     NixBOOL r = NIX_FALSE;
     STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pBuff.ptr);
     if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
@@ -889,14 +1198,31 @@ NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBuffer
         }
         //add to queue
         if(r){
-            NixBuffer_set(&pair.org, pBuff);
-            NixMutex_lock(obj->queues.mutex);
+            const NixUI32 blocksOut = (pair.cnv != NULL ? NixPCMBuffer_getBlocks(pair.cnv) : NixPCMBuffer_getBlocks(buff)); //as fed to the stream
+            if(isMove){
+                pair.org = pBuff; //take caller's reference
+            } else {
+                NixBuffer_set(&pair.org, pBuff);
+            }
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
             {
                 if(!NixAAudioQueue_pushOwning(&obj->queues.pend, &pair)){
                     NIX_PRINTF_ERROR("NixAAudioSource_queueBufferForOutput::NixAAudioQueue_pushOwning failed.\n");
                     r = NIX_FALSE;
                 } else {
                     //added to queue
+                    obj->counters.queued += NixPCMBuffer_getBlocks(buff);
+                    obj->counters.queuedOut += blocksOut;
+                    obj->wmark.isArmed = NIX_TRUE;
+                    if(obj->eng != NULL){
+                        NixEngineStats_addQueued(&obj->eng->stats, 1);
+                        //refilled after a drain (the data was expected)
+                        if(obj->drain.isDrained && NixAAudioSource_isPlaying(obj) && !NixAAudioSource_isPaused(obj)){
+                            NixEngineStats_addUnderrun(&obj->eng->stats);
+                        }
+                    }
+                    obj->drain.isFed = NIX_TRUE;
+                    obj->drain.isDrained = NIX_FALSE;
                     NixAAudioQueue_prepareForSz(&obj->queues.reuse, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
                     NixAAudioQueue_prepareForSz(&obj->queues.notify, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
                     //this is the first buffer i the queue
@@ -907,8 +1233,15 @@ NixBOOL NixAAudioSource_queueBufferForOutput(STNixAAudioSource* obj, STNixBuffer
                 }
             }
             NixMutex_unlock(obj->queues.mutex);
+            //flag for tick
+            if(r && obj->eng != NULL){
+                NixAAudioEngine_actvAdd(obj->eng, obj);
+            }
         }
         if(!r){
+            if(isMove){
+                NixBuffer_null(&pair.org); //caller keeps its reference
+            }
             NixAAudioQueuePair_destroy(&pair);
         }
     }
@@ -968,12 +1301,70 @@ NixBOOL NixAAudioSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixAAudi
     }
     return r;
 }
+
+NixUI32 NixAAudioSource_getQueuedBlocksLocked_(STNixAAudioSource* obj){
+    NixUI64 r = 0;
+    {
+        NixUI32 i; for(i = 0; i < obj->queues.pend.use; ++i){
+            const STNixAAudioQueuePair* pair = &obj->queues.pend.arr[i];
+            if(!NixBuffer_isNull(pair->org)){
+                r += NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr));
+            }
+        }
+    }
+    //pendBlockIdx is in srcFmt frames (converted buffer)
+    if(obj->queues.pend.use > 0 && obj->srcFmt.samplerate > 0){
+        const NixUI64 played = (NixUI64)obj->queues.pendBlockIdx * obj->buffsFmt.samplerate / obj->srcFmt.samplerate;
+        r = (played < r ? r - played : 0);
+    }
+    return (NixUI32)r;
+}
     
-NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* pDst, const NixUI32 samplesMax, NixBOOL* dstExplicitStop){
-    NixUI32 r = 0;
-    NixMutex_lock(obj->queues.mutex);
+NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* pDst, const NixUI32 samplesMax, const NixUI64 dstStartNs, NixBOOL* dstExplicitStop){
+    NixUI32 r = 0, samplesLimit = samplesMax;
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
-        while(r < samplesMax && obj->queues.pend.use > 0){
+        //sched (sample-accurate, relative to dst's presentation time)
+        if(obj->sched.startNs != 0 || obj->sched.stopNs != 0){
+            const NixUI64 rate = obj->srcFmt.samplerate;
+            if(obj->sched.startNs != 0){
+                if(dstStartNs == 0 || rate == 0 || obj->sched.startNs <= dstStartNs){
+                    //already due, start now
+                    obj->sched.startErr = (dstStartNs == 0 || obj->eng == NULL ? 0 : NixEngineClock_usToFrames(&obj->eng->clock, (NixSI64)(dstStartNs - obj->sched.startNs) / 1000));
+                    obj->sched.isStartErrSet = NIX_TRUE;
+                    obj->sched.startNs = 0;
+                } else {
+                    //leading silence
+                    const NixUI64 silence = (obj->sched.startNs - dstStartNs) * rate / 1000000000ull;
+                    r = (silence < samplesMax ? (NixUI32)silence : samplesMax);
+                    if(r > 0 && obj->srcFmt.blockAlign > 0){
+                        memset(pDst, 0, r * obj->srcFmt.blockAlign);
+                    }
+                    if(r < samplesMax){
+                        //starts inside this buffer
+                        obj->sched.startErr = 0;
+                        obj->sched.isStartErrSet = NIX_TRUE;
+                        obj->sched.startNs = 0;
+                    }
+                }
+            }
+            if(obj->sched.stopNs != 0 && dstStartNs != 0 && rate != 0){
+                const NixUI64 frames = (obj->sched.stopNs <= dstStartNs ? 0 : (obj->sched.stopNs - dstStartNs) * rate / 1000000000ull);
+                if(frames < samplesMax){
+                    //stops inside this buffer
+                    samplesLimit = (frames > r ? (NixUI32)frames : r);
+                    obj->sched.stopNs = 0;
+                    obj->sched.isStopReached = NIX_TRUE;
+                    if(dstExplicitStop != NULL){
+                        *dstExplicitStop = NIX_TRUE;
+                    }
+                }
+            }
+            if(obj->sched.startNs == 0 && obj->sched.stopNs == 0){
+                NIX_ATOMIC_STORE32(&obj->sched.isPendHint, 0);
+            }
+        }
+        while(r < samplesLimit && obj->sched.startNs == 0 && obj->queues.pend.use > 0){
             NixBOOL remove = NIX_FALSE, isFullyConsumed = NIX_FALSE;
             STNixAAudioQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (pair->cnv != NULL ? pair->cnv : (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr));
@@ -989,7 +1380,7 @@ NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* pDst, const
                 } else {
                     //fill samples
                     const NixUI32 blocksAvailRead = (blocks - obj->queues.pendBlockIdx);
-                    const NixUI32 blocksAvailWrite = (samplesMax - r);
+                    const NixUI32 blocksAvailWrite = (samplesLimit - r);
                     const NixUI32 blocksDo = (blocksAvailRead < blocksAvailWrite ? blocksAvailRead : blocksAvailWrite);
                     if(blocksDo > 0){
                         NixBYTE* dst = &((NixBYTE*)pDst)[r * obj->srcFmt.blockAlign];
@@ -997,6 +1388,7 @@ NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* pDst, const
                         //ToDo: copy applying volume
                         memcpy(dst, src, blocksDo * obj->srcFmt.blockAlign);
                         obj->queues.pendBlockIdx += blocksDo;
+                        NIX_ATOMIC_ADD64(&obj->counters.played, blocksDo);
                         r += blocksDo;
                     }
                     if(blocksAvailRead == blocksDo){
@@ -1031,6 +1423,17 @@ NixUI32 NixAAudioSource_feedSamplesTo(STNixAAudioSource* obj, void* pDst, const
                 }
             }
         }
+        //drain (stream-source ran out of buffers while playing, once per drain)
+        if(obj->drain.isFed && r < samplesLimit && obj->queues.pend.use == 0 && obj->sched.startNs == 0 && !NixAAudioSource_isStatic(obj) && (dstExplicitStop == NULL || !*dstExplicitStop)){
+            obj->drain.isFed = NIX_FALSE;
+            if(!NixSourceWatermark_isEnabled(&obj->wmark)){
+                //counted only if more buffers are queued
+                obj->drain.isDrained = NIX_TRUE;
+            } else if(obj->eng != NULL){
+                //the user is refilling by the watermark
+                NixEngineStats_addUnderrun(&obj->eng->stats);
+            }
+        }
     }
     NixMutex_unlock(obj->queues.mutex);
     return r;
@@ -1058,7 +1461,7 @@ void NixAAudioRecorder_init(STNixContextRef ctx, STNixAAudioRecorder* obj){
 void NixAAudioRecorder_destroy(STNixAAudioRecorder* obj){
     //queues
     {
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixAAudioQueue_destroy(&obj->queues.notify);
             NixAAudioQueue_destroy(&obj->queues.reuse);
@@ -1093,15 +1496,22 @@ void nixAAudioRecorder_errorCallback_(AAudioStream *_Nonnull stream, void *_Null
 
 aaudio_data_callback_result_t nixAAudioRecorder_dataCallback_(AAudioStream *_Nonnull stream, void *_Nullable userData, void *_Nonnull audioData, int32_t numFrames){
     STNixAAudioRecorder* obj = (STNixAAudioRecorder*)userData;
+    NIX_RT_ENTER();
+    if(obj->rt != NULL){
+        NixRtThreadState_applyIfChanged(obj->rt, &obj->rtSeq);
+    }
     {
+        NIX_TRACE_BEGIN(trConsume);
         NixAAudioRecorder_consumeInputBuffer(obj, audioData, numFrames);
+        NIX_TRACE_END(trConsume, "recConsume", obj->selfRef.ptr);
     }
+    NIX_RT_EXIT();
     return AAUDIO_CALLBACK_RESULT_CONTINUE;
 }
 
 NixBOOL NixAAudioRecorder_prepare(STNixAAudioRecorder* obj, STNixAAudioEngine* eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer){
     NixBOOL r = NIX_FALSE;
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.conv == NULL && audioDesc->blockAlign > 0){
         AAudioStreamBuilder *bldr;
         aaudio_result_t rr = AAudio_createStreamBuilder(&bldr);
@@ -1181,6 +1591,10 @@ NixBOOL NixAAudioRecorder_prepare(STNixAAudioRecorder* obj, STNixAAudioEngine* e
                             NIX_PRINTF_ERROR("NixAAudioRecorder_prepare::no reusable buffer could be allocated.\n");
                         } else {
                             //prepared
+                            obj->stats = &eng->stats;
+                            obj->rt = &eng->rt;
+                            obj->rtSeq = 0; //new callback thread
+                            NixFmtConverter_setStats(conv, obj->stats);
                             obj->queues.filling.iCurSample = 0;
                             obj->queues.conv = conv; conv = NULL; //consume
                             obj->rec = stream; stream = NULL; //consume
@@ -1261,7 +1675,7 @@ NixBOOL NixAAudioRecorder_stop(STNixAAudioRecorder* obj){
 NixBOOL NixAAudioRecorder_flush(STNixAAudioRecorder* obj){
     NixBOOL r = NIX_TRUE;
     //move filling buffer to notify (if data is available)
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.reuse.use > 0){
         STNixAAudioQueuePair* pair = &obj->queues.reuse.arr[0];
         if(!NixBuffer_isNull(pair->org) && ((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr))->use > 0){
@@ -1278,7 +1692,7 @@ NixBOOL NixAAudioRecorder_flush(STNixAAudioRecorder* obj){
 
 void NixAAudioRecorder_consumeInputBuffer(STNixAAudioRecorder* obj, void* audioData, const NixSI32 numFrames){
     if(obj->queues.conv != NULL && obj->rec != NULL && audioData != NULL && numFrames > 0){
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixUI32 inIdx = 0;
             NixSI32 inSz = numFrames;
@@ -1291,6 +1705,13 @@ void NixAAudioRecorder_consumeInputBuffer(STNixAAudioRecorder* obj, void* audioD
                         NIX_ASSERT(NIX_FALSE);
                         break;
                     }
+                    //overrun (its frames are lost)
+                    if(obj->stats != NULL && !NixBuffer_isNull(obj->queues.reuse.arr[0].org)){
+                        const STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(obj->queues.reuse.arr[0].org.ptr);
+                        if(org->desc.blockAlign > 0){
+                            NixEngineStats_addRecOverrun(obj->stats, org->use / org->desc.blockAlign);
+                        }
+                    }
                 } else {
                     STNixAAudioQueuePair* pair = &obj->queues.reuse.arr[0];
                     if(NixBuffer_isNull(pair->org) || ((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr))->desc.blockAlign <= 0){
@@ -1323,6 +1744,7 @@ void NixAAudioRecorder_consumeInputBuffer(STNixAAudioRecorder* obj, void* audioD
                             } else {
                                 inIdx += ammBlocksRead;
                                 obj->queues.filling.iCurSample += ammBlocksWritten;
+                                obj->counters.captured += ammBlocksWritten;
                                 org->use = (obj->queues.filling.iCurSample * org->desc.blockAlign); NIX_ASSERT(org->use <= org->sz)
                             }
                         }
@@ -1344,7 +1766,7 @@ void NixAAudioRecorder_consumeInputBuffer(STNixAAudioRecorder* obj, void* audioD
 }
 
 void NixAAudioRecorder_notifyBuffers(STNixAAudioRecorder* obj, const NixBOOL discardWithoutNotifying){
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         const NixUI32 maxProcess = obj->queues.notify.use;
         NixUI32 ammProcessed = 0;
@@ -1360,9 +1782,15 @@ void NixAAudioRecorder_notifyBuffers(STNixAAudioRecorder* obj, const NixBOOL dis
                     STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair.org.ptr);
                     NixMutex_unlock(obj->queues.mutex);
                     {
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*obj->callback.func)(&obj->engRef, &obj->selfRef, org->desc, org->ptr, org->use, (org->use / org->desc.blockAlign), obj->callback.data);
+                        NIX_TRACE_END(trCall, "recCallback", obj->selfRef.ptr);
+                        if(obj->stats != NULL){
+                            NixEngineStats_addCallback(obj->stats, NixClock_getMonotonicNs() - nsCall);
+                        }
                     }
-                    NixMutex_lock(obj->queues.mutex);
+                    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
                 }
                 //move to reuse
                 if(!NixAAudioQueue_pushOwning(&obj->queues.reuse, &pair)){
@@ -1396,7 +1824,7 @@ STNixEngineRef nixAAudioEngine_alloc(STNixContextRef ctx){
         //release (if not consumed)
         if(obj != NULL){
             NixAAudioEngine_destroy(obj);
-            NixContext_mfree(ctx, obj);
+            NIX_RT_MFREE(ctx, obj);
             obj = NULL;
         }
     }
@@ -1454,6 +1882,7 @@ NixBOOL nixAAudioEngine_ctxDeactivate(STNixEngineRef pObj){
 void nixAAudioEngine_tick(STNixEngineRef pObj){
     STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(pObj.ptr);
     if(obj != NULL){
+        NixOneShots_tick(&obj->oneShots);
         NixAAudioEngine_tick(obj, NIX_FALSE);
     }
 }
@@ -1487,6 +1916,81 @@ STNixRecorderRef nixAAudioEngine_allocRecorder(STNixEngineRef ref, const STNixAu
     return r;
 }
 
+//One-shots
+
+NixBOOL nixAAudioEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority){
+    NixBOOL r = NIX_FALSE;
+    STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_play(&obj->oneShots, ref, buff, vol, priority);
+    }
+    return r;
+}
+
+NixBOOL nixAAudioEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal){
+    NixBOOL r = NIX_FALSE;
+    STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_setLimit(&obj->oneShots, maxConcurrent, steal);
+    }
+    return r;
+}
+
+//Clock
+
+NixUI64 nixAAudioEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec){
+    NixUI64 r = 0;
+    STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixEngineClock_getFrame(&obj->clock);
+    }
+    if(optDstFramesPerSec != NULL){
+        *optDstFramesPerSec = (obj != NULL ? obj->clock.rate : 0);
+    }
+    return r;
+}
+
+//Real-time threads
+
+NixBOOL nixAAudioEngine_setRtThreadOpts(STNixEngineRef ref, const STNixRtThreadOpts* opts){
+    NixBOOL r = NIX_FALSE;
+    STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        //applied by each stream's callback thread on its next call
+        NixRtThreadState_set(&obj->rt, opts);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//Stats
+
+NixBOOL nixAAudioEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixAAudioEngine* obj = (STNixAAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        NixEngineStats_get(&obj->stats, dst);
+        //sources (snapshot)
+        {
+            STNixAAudioSrcsSnap* srcs = NixAAudioEngine_srcsRetain(obj);
+            if(srcs != NULL){
+                NixUI32 i; for(i = 0; i < srcs->use; ++i){
+                    STNixAAudioSource* src = srcs->arr[i];
+                    if(!NixAAudioSource_isOrphan(src)){
+                        dst->sourcesTotal++;
+                        if(NixAAudioSource_isPlaying(src) && !NixAAudioSource_isPaused(src)){
+                            dst->sourcesActive++;
+                        }
+                    }
+                }
+                NixAAudioEngine_srcsRelease(obj, srcs);
+            }
+        }
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
 //------
 //Source (API)
 //------
@@ -1517,7 +2021,7 @@ STNixSourceRef nixAAudioSource_alloc(STNixEngineRef pEng){
         //release (if not consumed)
         if(obj != NULL){
             NixAAudioSource_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            NIX_RT_MFREE(eng->ctx, obj);
             obj = NULL;
         }
     }
@@ -1528,7 +2032,7 @@ void nixAAudioSource_removeAllBuffersAndNotify_(STNixAAudioSource* obj){
     STNixNotifQueue notifs;
     NixNotifQueue_init(obj->ctx, &notifs);
     //move all pending buffers to notify
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixAAudioSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(obj);
         NixAAudioEngine_tick_addQueueNotifSrcLocked_(&notifs, obj);
@@ -1561,6 +2065,7 @@ void nixAAudioSource_free(STNixSourceRef pObj){ //orphans the source, will autom
                 NixAAudioSource_setIsPlaying(obj, NIX_FALSE);
                 NixAAudioSource_setIsPaused(obj, NIX_FALSE);
                 ++obj->eng->srcs.changingStateCountHint;
+                NixAAudioEngine_actvAdd(obj->eng, obj);
             }
             //flush all pending buffers
             {
@@ -1604,7 +2109,7 @@ void nixAAudioSource_play(STNixSourceRef pObj){
         if(obj->src != NULL && (!NixAAudioSource_isPlaying(obj) || NixAAudioSource_isPaused(obj))){
             //restart static buffer
             if(NixAAudioSource_isStatic(obj)){
-                NixMutex_lock(obj->queues.mutex);
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
                 {
                     if(obj->queues.pend.use == 1){
                         //last buffer to play
@@ -1626,6 +2131,7 @@ void nixAAudioSource_play(STNixSourceRef pObj){
             } else {
                 NixAAudioSource_setIsChanging(obj, NIX_TRUE);
                 ++obj->eng->srcs.changingStateCountHint;
+                NixAAudioEngine_actvAdd(obj->eng, obj);
             }
         }
         NixAAudioSource_setIsPlaying(obj, NIX_TRUE);
@@ -1642,6 +2148,7 @@ void nixAAudioSource_pause(STNixSourceRef pObj){
             } else {
                 NixAAudioSource_setIsChanging(obj, NIX_TRUE);
                 ++obj->eng->srcs.changingStateCountHint;
+                NixAAudioEngine_actvAdd(obj->eng, obj);
             }
         }
         NixAAudioSource_setIsPaused(obj, NIX_TRUE);
@@ -1657,10 +2164,20 @@ void nixAAudioSource_stop(STNixSourceRef pObj){
             } else {
                 NixAAudioSource_setIsChanging(obj, NIX_TRUE);
                 ++obj->eng->srcs.changingStateCountHint;
+                NixAAudioEngine_actvAdd(obj->eng, obj);
             }
         }
         NixAAudioSource_setIsPlaying(obj, NIX_FALSE);
         NixAAudioSource_setIsPaused(obj, NIX_FALSE);
+        //cancel schedules
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            obj->sched.startNs = obj->sched.stopNs = 0;
+            obj->sched.isStopReached = NIX_FALSE;
+            //not an underrun
+            obj->drain.isFed = obj->drain.isDrained = NIX_FALSE;
+        }
+        NixMutex_unlock(obj->queues.mutex);
         //flush all pending buffers
         nixAAudioSource_removeAllBuffersAndNotify_(obj);
     }
@@ -1712,13 +2229,41 @@ void nixAAudioSource_errorCallback_(AAudioStream *_Nonnull stream, void *_Nullab
 aaudio_data_callback_result_t nixAAudioSource_dataCallback_(AAudioStream *_Nonnull stream, void *_Nullable userData, void *_Nonnull audioData, int32_t numFrames){
     STNixAAudioSource* obj = (STNixAAudioSource*)userData;
     NixBOOL dstExplicitStop = NIX_FALSE;
-    const NixUI32 numFed = NixAAudioSource_feedSamplesTo(obj, audioData, numFrames, &dstExplicitStop);
+    NixUI64 dstStartNs = 0;
+    NIX_RT_ENTER();
+    if(obj->eng != NULL){
+        NixRtThreadState_applyIfChanged(&obj->eng->rt, &obj->rtSeq);
+    }
+    NIX_TRACE_BEGIN(trDevice);
+    //pull-model (rendered directly, silence on user's underruns)
+    if(NixSourceRender_isSet(&obj->render)){
+        NixSourceRender_fill(&obj->render, &obj->self, audioData, (NixUI32)numFrames);
+        NIX_ATOMIC_ADD64(&obj->counters.played, (NixUI64)numFrames);
+        NIX_TRACE_END(trDevice, "deviceCallback", obj->self.ptr);
+        NIX_RT_EXIT();
+        return AAUDIO_CALLBACK_RESULT_CONTINUE;
+    }
+    //presentation time of this buffer (only while a schedule is pending)
+    if(NIX_ATOMIC_LOAD32(&obj->sched.isPendHint) && obj->srcFmt.samplerate > 0){
+        int64_t framePos = 0, timeNs = 0;
+        if(AAUDIO_OK == AAudioStream_getTimestamp(stream, CLOCK_MONOTONIC, &framePos, &timeNs)){
+            const int64_t written = AAudioStream_getFramesWritten(stream);
+            dstStartNs = (NixUI64)(timeNs + ((written - framePos) * 1000000000ll / (int64_t)obj->srcFmt.samplerate));
+        } else {
+            //no timestamp yet (stream starting), estimate by the buffer size
+            const int64_t latency = AAudioStream_getBufferSizeInFrames(stream);
+            dstStartNs = (NixClock_getMonotonicUs() * 1000ull) + (NixUI64)(latency * 1000000000ll / (int64_t)obj->srcFmt.samplerate);
+        }
+    }
+    const NixUI32 numFed = NixAAudioSource_feedSamplesTo(obj, audioData, numFrames, dstStartNs, &dstExplicitStop); //counts the underruns
     //fille with zeroes the unpopulated area
     if(numFed < numFrames && obj->srcFmt.blockAlign > 0){
         void* data = &(((NixUI8*)audioData)[numFed * obj->srcFmt.blockAlign]);
         const NixUI32 dataSz = (numFrames - numFed) * obj->srcFmt.blockAlign;
         memset(data, 0, dataSz);
     }
+    NIX_TRACE_END(trDevice, "deviceCallback", obj->self.ptr);
+    NIX_RT_EXIT();
     return (numFed < numFrames || dstExplicitStop ? AAUDIO_CALLBACK_RESULT_STOP : AAUDIO_CALLBACK_RESULT_CONTINUE);
 }
 
@@ -1753,6 +2298,7 @@ NixBOOL nixAAudioSource_prepareSourceForFmt_(STNixAAudioSource* obj, const STNix
             NIX_PRINTF_ERROR("nixAAudioSource_prepareSourceForFmt_::AAudioStreamBuilder_openStream failed.\n");
         } else {
             STNixAudioDesc desc;
+            obj->rtSeq = 0; //new callback thread
             memset(&desc, 0, sizeof(desc));
             //read properties
             switch(AAudioStream_getFormat(stream)){
@@ -1788,6 +2334,9 @@ NixBOOL nixAAudioSource_prepareSourceForFmt_(STNixAAudioSource* obj, const STNix
                         NixFmtConverter_free(conv);
                         r = NIX_FALSE;
                     } else {
+                        if(obj->eng != NULL){
+                            NixFmtConverter_setStats(conv, &obj->eng->stats);
+                        }
                         obj->queues.conv = conv;
                     }
                 }
@@ -1835,12 +2384,14 @@ NixBOOL nixAAudioSource_setBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){  /
             NIX_PRINTF_ERROR("nixAAudioSource_setBuffer, source already has buffer.\n");
         } else if(NixAAudioSource_isStatic(obj)){
             NIX_PRINTF_ERROR("nixAAudioSource_setBuffer, source is already static.\n");
+        } else if(NixSourceRender_isSet(&obj->render)){
+            NIX_PRINTF_ERROR("nixAAudioSource_setBuffer, source is a render source.\n");
         } else if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
             NIX_PRINTF_ERROR("nixAAudioSource_setBuffer, new buffer doesnt match first buffer's format.\n");
         } else {
             NixAAudioSource_setIsStatic(obj, NIX_TRUE);
             //schedule
-            if(!NixAAudioSource_queueBufferForOutput(obj, pBuff)){
+            if(!NixAAudioSource_queueBufferForOutput(obj, pBuff, NIX_FALSE)){
                 NIX_PRINTF_ERROR("nixAAudioSource_setBuffer, NixAAudioSource_queueBufferForOutput failed.\n");
             } else {
                 r = NIX_TRUE;
@@ -1850,7 +2401,7 @@ NixBOOL nixAAudioSource_setBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){  /
     return r;
 }
 
-NixBOOL nixAAudioSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
+NixBOOL nixAAudioSource_queueBuffer_(STNixSourceRef pObj, STNixBufferRef pBuff, const NixBOOL isMove){
     NixBOOL r = NIX_FALSE;
     if(pObj.ptr != NULL && pBuff.ptr != NULL){
         STNixAAudioSource* obj    = (STNixAAudioSource*)NixSharedPtr_getOpq(pObj.ptr);
@@ -1867,11 +2418,13 @@ NixBOOL nixAAudioSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
             NIX_PRINTF_ERROR("nixAAudioSource_queueBuffer, no source available.\n");
         } else if(NixAAudioSource_isStatic(obj)){
             NIX_PRINTF_ERROR("nixAAudioSource_queueBuffer, source is static.\n");
+        } else if(NixSourceRender_isSet(&obj->render)){
+            NIX_PRINTF_ERROR("nixAAudioSource_queueBuffer, source is a render source.\n");
         } else if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
             NIX_PRINTF_ERROR("nixAAudioSource_queueBuffer, new buffer doesnt match first buffer's format.\n");
         } else {
             //schedule
-            if(!NixAAudioSource_queueBufferForOutput(obj, pBuff)){
+            if(!NixAAudioSource_queueBufferForOutput(obj, pBuff, isMove)){
                 NIX_PRINTF_ERROR("nixAAudioSource_queueBuffer, NixAAudioSource_queueBufferForOutput failed.\n");
             } else {
                 //restart stream if necesary
@@ -1892,11 +2445,24 @@ NixBOOL nixAAudioSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
     return r;
 }
 
+NixBOOL nixAAudioSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
+    return nixAAudioSource_queueBuffer_(pObj, pBuff, NIX_FALSE);
+}
+
+NixBOOL nixAAudioSource_queueBufferMove(STNixSourceRef pObj, STNixBufferRef* pBuff){
+    NixBOOL r = NIX_FALSE;
+    if(pBuff != NULL && nixAAudioSource_queueBuffer_(pObj, *pBuff, NIX_TRUE)){
+        NixBuffer_null(pBuff); //consumed
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
 NixBOOL nixAAudioSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset){ //relative to first buffer in queue
     NixBOOL r = NIX_FALSE;
     if(ref.ptr != NULL){
         STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->queues.pend.use > 0){
             STNixAAudioQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1928,7 +2494,7 @@ NixUI32 nixAAudioSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytes
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixUI32 i; for(i = 0; i < obj->queues.pend.use; i++){
                 STNixAAudioQueuePair* pair = &obj->queues.pend.arr[0];
@@ -1954,7 +2520,7 @@ NixUI32 nixAAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytes
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->queues.pend.use > 0){
             STNixAAudioQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1973,6 +2539,186 @@ NixUI32 nixAAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytes
     return r;
 }
 
+//Scheduling
+
+NixBOOL nixAAudioSource_playAt(STNixSourceRef ref, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->eng != NULL && obj->src != NULL){
+            const NixUI64 usAt = NixEngineClock_frameToUs(&obj->eng->clock, engFrame);
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                //applied by the stream callback (silence until the start sample)
+                obj->sched.startNs = (usAt > 0 ? usAt * 1000ull : 1);
+                obj->sched.isStartErrSet = NIX_FALSE;
+                NIX_ATOMIC_STORE32(&obj->sched.isPendHint, 1);
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            nixAAudioSource_play(ref);
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+NixBOOL nixAAudioSource_stopAt(STNixSourceRef ref, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->eng != NULL){
+            const NixUI64 usAt = NixEngineClock_frameToUs(&obj->eng->clock, engFrame);
+            if(usAt <= NixClock_getMonotonicUs() || !NixAAudioSource_isPlaying(obj)){
+                //already due (or nothing consuming samples)
+                nixAAudioSource_stop(ref);
+            } else {
+                //applied by the stream callback
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+                {
+                    obj->sched.stopNs = usAt * 1000ull;
+                    NIX_ATOMIC_STORE32(&obj->sched.isPendHint, 1);
+                }
+                NixMutex_unlock(obj->queues.mutex);
+                NixAAudioEngine_actvAdd(obj->eng, obj);
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+NixBOOL nixAAudioSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        if(obj->sched.isStartErrSet){
+            if(dstFrames != NULL){
+                *dstFrames = obj->sched.startErr;
+            }
+            r = NIX_TRUE;
+        }
+        NixMutex_unlock(obj->queues.mutex);
+    }
+    return r;
+}
+
+//Counters
+
+NixBOOL nixAAudioSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesQueued   = obj->counters.queued;
+            dst->framesPlayed   = NIX_ATOMIC_LOAD64(&obj->counters.played);
+            if(obj->srcFmt.samplerate > 0 && obj->srcFmt.samplerate != obj->buffsFmt.samplerate){
+                if(obj->counters.queuedOut > 0 && dst->framesPlayed >= obj->counters.queuedOut){
+                    //everything queued was consumed (exact, the conversion rounding is not accumulated; repeats are scaled)
+                    dst->framesPlayed = obj->counters.queued + ((dst->framesPlayed - obj->counters.queuedOut) * obj->buffsFmt.samplerate / obj->srcFmt.samplerate);
+                } else {
+                    dst->framesPlayed = dst->framesPlayed * obj->buffsFmt.samplerate / obj->srcFmt.samplerate;
+                }
+            }
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL nixAAudioSource_getClock(STNixSourceRef ref, STNixSourceClock* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        const NixUI64 usNow = NixClock_getMonotonicUs();
+        const NixUI32 rate = obj->srcFmt.samplerate;
+        NixUI64 played = 0, latencyFrames = 0;
+        NixBOOL isTimestamp = NIX_FALSE;
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            played = NIX_ATOMIC_LOAD64(&obj->counters.played);
+            //device position (frames in the stream not presented yet)
+            if(obj->src != NULL && rate > 0 && NixAAudioSource_isPlaying(obj) && !NixAAudioSource_isPaused(obj)){
+                int64_t framePos = 0, timeNs = 0;
+                if(AAUDIO_OK == AAudioStream_getTimestamp(obj->src, CLOCK_MONOTONIC, &framePos, &timeNs)){
+                    const int64_t written = AAudioStream_getFramesWritten(obj->src);
+                    const int64_t presented = framePos + (((int64_t)usNow * 1000ll - timeNs) * (int64_t)rate / 1000000000ll);
+                    latencyFrames = (written > presented ? (NixUI64)(written - presented) : 0);
+                    isTimestamp = NIX_TRUE;
+                }
+            }
+            if(!isTimestamp){
+                //interpolate the callbacks' steps
+                const NixUI64 maxAhead = (rate > 0 && NixAAudioSource_isPlaying(obj) && !NixAAudioSource_isPaused(obj) ? (NixUI64)NIX_POS_INTERP_MAX_US * rate / 1000000ull : 0);
+                played = NixPosInterp_get(&obj->counters.clock, played, rate, maxAhead, usNow);
+            }
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        //to buffers' format
+        if(rate > 0 && rate != obj->buffsFmt.samplerate){
+            played = played * obj->buffsFmt.samplerate / rate;
+        }
+        dst->framesPlayed   = played;
+        dst->latencyUs      = (rate > 0 ? latencyFrames * 1000000ull / rate : 0);
+        dst->timeUs         = usNow;
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//Low watermark
+
+NixBOOL nixAAudioSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(!NixAAudioSource_isStatic(obj)){
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                NixSourceWatermark_set(&obj->wmark, type, amount, callback, callbackData);
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            if(obj->eng != NULL && NixSourceWatermark_isEnabled(&obj->wmark)){
+                NixAAudioEngine_actvAdd(obj->eng, obj);
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+//Render
+
+NixBOOL nixAAudioSource_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && fmt != NULL && callback != NULL){
+        STNixAAudioSource* obj = (STNixAAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->src != NULL || obj->queues.pend.use != 0 || NixAAudioSource_isStatic(obj)){
+            NIX_PRINTF_ERROR("nixAAudioSource_setRenderCallback, source already has buffers.\n");
+        } else if(!nixAAudioSource_prepareSourceForFmt_(obj, fmt)){
+            NIX_PRINTF_ERROR("nixAAudioSource_setRenderCallback, nixAAudioSource_prepareSourceForFmt_ failed.\n");
+        } else {
+            //the render converts on its own (buffers are never queued)
+            if(obj->queues.conv != NULL){
+                NixFmtConverter_free(obj->queues.conv);
+                obj->queues.conv = NULL;
+            }
+            if(!NixSourceRender_prepare(&obj->render, &obj->buffsFmt, &obj->srcFmt, callback, callbackData)){
+                NIX_PRINTF_ERROR("nixAAudioSource_setRenderCallback, NixSourceRender_prepare failed.\n");
+            } else {
+                if(obj->eng != NULL){
+                    NixFmtConverter_setStats(obj->render.conv, &obj->eng->stats);
+                }
+                r = NIX_TRUE;
+            }
+        }
+    }
+    return r;
+}
+
 //------
 //Recorder (API)
 //------
@@ -1998,7 +2744,7 @@ STNixRecorderRef nixAAudioRecorder_alloc(STNixEngineRef pEng, const STNixAudioDe
         //release (if not consumed)
         if(obj != NULL){
             NixAAudioRecorder_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            NIX_RT_MFREE(eng->ctx, obj);
             obj = NULL;
         }
     }
@@ -2075,7 +2821,7 @@ NixUI32 nixAAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* o
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     STNixAAudioRecorder* obj = (STNixAAudioRecorder*)NixSharedPtr_getOpq(ref.ptr);
     //calculate filled buffers
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixUI32 i; for(i = 0; i < obj->queues.notify.use; i++){
             STNixAAudioQueuePair* pair = &obj->queues.notify.arr[0];
@@ -2095,3 +2841,18 @@ NixUI32 nixAAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* o
     if(optDstMsecsCount != NULL) *optDstMsecsCount = msecsCount;
     return r;
 }
+
+NixBOOL nixAAudioRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixAAudioRecorder* obj = (STNixAAudioRecorder*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesCaptured = obj->counters.captured;
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
@@ -20,6 +20,9 @@
 #define NIX_DEBUG
 //#define NIX_SILENT_MODE
 //#define NIX_VERBOSE_MODE
+//#define NIX_TRACE           //records spans of the hot paths, see NixTrace_dumpChromeJson
+//#define NIX_RT_CHECK        //reports allocations and contended locks made from real-time threads, see NixRtCheck_setHandler
+//#define NIX_MUTEX_FAST_DEFAULT  //default mutex itf is the fast one, see NixMutexItf_getFast
 
 //++++++++++++++++++++
 //++++++++++++++++++++
@@ -35,15 +38,17 @@
 
 #ifdef NIX_ASSERTS_ACTIVATED
     #include <assert.h>         //assert
-#   define NIX_ASSERT(EVAL)     { if(!(EVAL)){ NIX_PRINTF_ERROR("ASSERT, cond '"#EVAL"'.\n"); NIX_PRINTF_ERROR("ASSERT, file '%s'\n", __FILE__); NIX_PRINTF_ERROR("ASSERT, line %d.\n", __LINE__); assert(0); }}
+#   define NIX_ASSERT(EVAL)     { if(!(EVAL)){ NIX_PRINTF_ERROR("ASSERT, cond '"#EVAL"'.\n"); NIX_PRINTF_ERROR("ASSERT, file '%s'\n", __FILE__); NIX_PRINTF_ERROR("ASSERT, line %d.\n", __LINE__); NixLog_flush(); assert(0); }}
 #else
 #   define NIX_ASSERT(EVAL)     ((void)0);
 #endif
 
-#ifndef NIX_MSWAIT_BEFORE_DELETING_BUFFERS
-    #ifdef NIX_OPENAL
-#        define NIX_MSWAIT_BEFORE_DELETING_BUFFERS    250 //OpenAL fails when stopping, unqueuing and deleting buffers in the same tick
-    #endif
+#ifndef NIX_OPENAL_BUFFERS_POOL_MAX
+    #define NIX_OPENAL_BUFFERS_POOL_MAX    32 //unqueued AL buffers kept for reuse; OpenAL fails when stopping, unqueuing and deleting buffers in the same tick, the pool only deletes buffers released in previous ticks
+#endif
+
+#ifndef NIX_OPENAL_RENDER_BUFFERS
+    #define NIX_OPENAL_RENDER_BUFFERS   2 //AL buffers of NIX_SOURCES_RENDER_BLOCKS refilled by tick for render sources, when AL_SOFT_callback_buffer is not available
 #endif
 
 #ifndef NIX_SOURCES_MAX
@@ -51,7 +56,31 @@
 #endif
 
 #ifndef NIX_SOURCES_GROWTH
-    #define NIX_SOURCES_GROWTH    1
+    #define NIX_SOURCES_GROWTH    4     //sources created each time the engine's pool is empty
+#endif
+
+#ifndef NIX_SOURCES_POOL_INIT
+    #define NIX_SOURCES_POOL_INIT 8     //sources pre-allocated at engine creation
+#endif
+
+#ifndef NIX_SOURCES_POOL_MAX
+    #define NIX_SOURCES_POOL_MAX  64    //released sources kept for reuse, extra ones are destroyed
+#endif
+
+#ifndef NIX_SOURCES_QUEUE_BATCH
+    #define NIX_SOURCES_QUEUE_BATCH 16  //buffers queued per AL call by NixSource_queueBuffers (stack arrays)
+#endif
+
+#ifndef NIX_SOURCES_PLAY_BATCH
+    #define NIX_SOURCES_PLAY_BATCH  32  //sources started/stopped per AL call by NixEngine_playSources/stopSources (stack arrays)
+#endif
+
+#ifndef NIX_SOURCES_SYNC_START_US
+    #define NIX_SOURCES_SYNC_START_US 20000 //lead of the common start time used by NixEngine_playSources (AVFAudio)
+#endif
+
+#ifndef NIX_SOURCES_RENDER_BLOCKS
+    #define NIX_SOURCES_RENDER_BLOCKS 1024  //frames rendered per call when converting, and per internal buffer when the backend has no pull-callback (OpenAL), see NixSource_setRenderCallback
 #endif
 
 #ifndef NIX_BUFFERS_MAX
@@ -62,10 +91,54 @@
     #define NIX_BUFFERS_GROWTH    1
 #endif
 
+#ifndef NIX_ONESHOTS_MAX
+    #define NIX_ONESHOTS_MAX      16    //default concurrent one-shots per engine, zero is unlimited, see NixEngine_setOneShotsLimit
+#endif
+
+#ifndef NIX_VOICES_MAX
+    #define NIX_VOICES_MAX        0     //default real voices per engine (zero is unlimited), see NixEngine_setVoicesLimit
+#endif
+
+#ifndef NIX_ENGINE_CLOCK_RATE
+    #define NIX_ENGINE_CLOCK_RATE 48000 //frames per second of the engine timeline, see NixEngine_getFrameTime
+#endif
+
+#ifndef NIX_POS_INTERP_MAX_US
+    #define NIX_POS_INTERP_MAX_US 50000 //max extrapolation of a playback position without new reports from the device, see NixSource_getClock
+#endif
+
 #ifndef NIX_AUDIO_GROUPS_SIZE
     #define NIX_AUDIO_GROUPS_SIZE 8
 #endif
 
+#ifndef NIX_MUTEX_FAST_SPINS
+    #define NIX_MUTEX_FAST_SPINS        100  //trylock attempts before parking the thread, see NixMutexItf_getFast
+#endif
+
+#ifndef NIX_TRACE_EVENTS_PER_THREAD
+    #define NIX_TRACE_EVENTS_PER_THREAD 16384 //must be power of two, spans kept per thread (newest overwrite oldest), only with NIX_TRACE
+#endif
+
+#ifndef NIX_LOG_QUEUE_SZ
+    #define NIX_LOG_QUEUE_SZ        128 //must be power of two, messages waiting for NixLog_flush (extra ones are dropped and counted)
+#endif
+
+#ifndef NIX_LOG_MSG_SZ
+    #define NIX_LOG_MSG_SZ          256 //bytes per message, longer ones are truncated
+#endif
+
+#ifndef NIX_LOG_REPEAT_MAX
+    #define NIX_LOG_REPEAT_MAX      8   //messages with the same format per NIX_LOG_REPEAT_WINDOW_MS, extra ones are suppressed and counted
+#endif
+
+#ifndef NIX_LOG_REPEAT_WINDOW_MS
+    #define NIX_LOG_REPEAT_WINDOW_MS 1000
+#endif
+
+#ifndef NIX_OPENAL_EVENTS_QUEUE_SZ
+    #define NIX_OPENAL_EVENTS_QUEUE_SZ  256 //must be power of two, AL_SOFT_events ring (filled by the AL event thread, drained by tick)
+#endif
+
 // PRINTING/LOG
 
 #if defined(__ANDROID__) //Android
@@ -79,46 +152,117 @@
 #   define NIX_PRINTF_ALLWAYS(STR_FMT, ...)     printf("Nix, " STR_FMT, ##__VA_ARGS__)
 #endif
 
+// Messages are queued (lock-free, safe in audio callbacks and under locks) and delivered
+// to the sink by NixLog_flush (called at the end of each tick), see NixLog_setSink.
+
 #if defined(NIX_SILENT_MODE)
 #   define NIX_PRINTF_INFO(STR_FMT, ...)        ((void)0)
 #   define NIX_PRINTF_ERROR(STR_FMT, ...)       ((void)0)
 #   define NIX_PRINTF_WARNING(STR_FMT, ...)     ((void)0)
 #else
-#   if defined(__ANDROID__) //Android
-#        ifndef NIX_VERBOSE_MODE
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   ((void)0)
-#        else
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   __android_log_print(ANDROID_LOG_INFO, "Nixtla", STR_FMT, ##__VA_ARGS__)
-#        endif
-#        define NIX_PRINTF_ERROR(STR_FMT, ...)  __android_log_print(ANDROID_LOG_ERROR, "Nixtla", "ERROR, "STR_FMT, ##__VA_ARGS__)
-#        define NIX_PRINTF_WARNING(STR_FMT, ...) __android_log_print(ANDROID_LOG_WARN, "Nixtla", "WARNING, "STR_FMT, ##__VA_ARGS__)
-#   elif defined(__QNX__) //BB10
-#        ifndef NIX_VERBOSE_MODE
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   ((void)0)
-#        else
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   fprintf(stdout, "Nix, " STR_FMT, ##__VA_ARGS__); fflush(stdout)
-#        endif
-#        define NIX_PRINTF_ERROR(STR_FMT, ...)  fprintf(stderr, "Nix ERROR, " STR_FMT, ##__VA_ARGS__); fflush(stderr)
-#        define NIX_PRINTF_WARNING(STR_FMT, ...) fprintf(stdout, "Nix WARNING, " STR_FMT, ##__VA_ARGS__); fflush(stdout)
+#   ifndef NIX_VERBOSE_MODE
+#   define NIX_PRINTF_INFO(STR_FMT, ...)        ((void)0)
 #   else
-#        ifndef NIX_VERBOSE_MODE
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   ((void)0)
-#        else
-#        define NIX_PRINTF_INFO(STR_FMT, ...)   printf("Nix, " STR_FMT, ##__VA_ARGS__)
-#        endif
-#       define NIX_PRINTF_ERROR(STR_FMT, ...)   printf("Nix ERROR, " STR_FMT, ##__VA_ARGS__)
-#       define NIX_PRINTF_WARNING(STR_FMT, ...) printf("Nix WARNING, " STR_FMT, ##__VA_ARGS__)
+#   define NIX_PRINTF_INFO(STR_FMT, ...)        NixLog_post(ENNixLogLevel_Info, STR_FMT, ##__VA_ARGS__)
 #   endif
+#   define NIX_PRINTF_ERROR(STR_FMT, ...)       NixLog_post(ENNixLogLevel_Error, STR_FMT, ##__VA_ARGS__)
+#   define NIX_PRINTF_WARNING(STR_FMT, ...)     NixLog_post(ENNixLogLevel_Warning, STR_FMT, ##__VA_ARGS__)
 #endif
 
 #include "nixaudio/nixtla-audio.h"
 
-#ifdef __cplusplus
-extern "C" {
+#if defined(__GNUC__) || defined(__clang__)
+#   define NIX_PRINTF_FMT_ATTR(I_FMT, I_ARGS)   __attribute__((format(printf, I_FMT, I_ARGS))) //compiler checks the arguments
+#else
+#   define NIX_PRINTF_FMT_ATTR(I_FMT, I_ARGS)
+#endif
+
+void NixLog_post(const ENNixLogLevel level, const char* fmt, ...) NIX_PRINTF_FMT_ATTR(2, 3); //queues a message, see NIX_PRINTF_*
+
+// ATOMICS (lock-free counters and indexes)
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#   define NIX_ATOMIC_LOAD32(PTR)           ((NixUI32)_InterlockedOr((volatile long*)(PTR), 0))
+#   define NIX_ATOMIC_STORE32(PTR, V)       ((void)_InterlockedExchange((volatile long*)(PTR), (long)(V)))
+#   define NIX_ATOMIC_ADD32(PTR, V)         ((NixUI32)_InterlockedExchangeAdd((volatile long*)(PTR), (long)(V)) + (NixUI32)(V)) //returns new value
+#   define NIX_ATOMIC_SUB32(PTR, V)         ((NixUI32)_InterlockedExchangeAdd((volatile long*)(PTR), -(long)(V)) - (NixUI32)(V)) //returns new value
+#   define NIX_ATOMIC_CAS32(PTR, EXP, V)    (_InterlockedCompareExchange((volatile long*)(PTR), (long)(V), (long)(EXP)) == (long)(EXP))
+#   define NIX_ATOMIC_XCHG32(PTR, V)        ((NixUI32)_InterlockedExchange((volatile long*)(PTR), (long)(V))) //returns old value
+#   define NIX_ATOMIC_LOADPTR(PTR)          _InterlockedCompareExchangePointer((void* volatile*)(PTR), NULL, NULL)
+#   define NIX_ATOMIC_STOREPTR(PTR, V)      ((void)_InterlockedExchangePointer((void* volatile*)(PTR), (void*)(V)))
+#   define NIX_ATOMIC_CASPTR(PTR, EXP, V)   (_InterlockedCompareExchangePointer((void* volatile*)(PTR), (void*)(V), (void*)(EXP)) == (void*)(EXP))
+#   define NIX_ATOMIC_LOAD64(PTR)           ((NixUI64)_InterlockedCompareExchange64((volatile __int64*)(PTR), 0, 0))
+#   define NIX_ATOMIC_ADD64(PTR, V)         ((NixUI64)_InterlockedExchangeAdd64((volatile __int64*)(PTR), (__int64)(V)) + (NixUI64)(V)) //returns new value
+#else
+#   define NIX_ATOMIC_LOAD32(PTR)           __atomic_load_n((PTR), __ATOMIC_ACQUIRE)
+#   define NIX_ATOMIC_STORE32(PTR, V)       __atomic_store_n((PTR), (V), __ATOMIC_RELEASE)
+#   define NIX_ATOMIC_ADD32(PTR, V)         __atomic_add_fetch((PTR), (V), __ATOMIC_ACQ_REL) //returns new value
+#   define NIX_ATOMIC_SUB32(PTR, V)         __atomic_sub_fetch((PTR), (V), __ATOMIC_ACQ_REL) //returns new value
+#   define NIX_ATOMIC_CAS32(PTR, EXP, V)    nixAtomic_cas32_((PTR), (EXP), (V))
+#   define NIX_ATOMIC_XCHG32(PTR, V)        __atomic_exchange_n((PTR), (V), __ATOMIC_ACQ_REL) //returns old value
+#   define NIX_ATOMIC_LOADPTR(PTR)          __atomic_load_n((PTR), __ATOMIC_ACQUIRE)
+#   define NIX_ATOMIC_STOREPTR(PTR, V)      __atomic_store_n((PTR), (V), __ATOMIC_RELEASE)
+#   define NIX_ATOMIC_CASPTR(PTR, EXP, V)   nixAtomic_casPtr_((void* volatile*)(PTR), (void*)(EXP), (void*)(V))
+#   define NIX_ATOMIC_LOAD64(PTR)           __atomic_load_n((PTR), __ATOMIC_RELAXED) //counters only (no ordering)
+#   define NIX_ATOMIC_ADD64(PTR, V)         __atomic_add_fetch((PTR), (V), __ATOMIC_RELAXED) //counters only (no ordering), returns new value
+    NX_INLN int nixAtomic_cas32_(volatile NixUI32* ptr, NixUI32 exp, const NixUI32 v){ return __atomic_compare_exchange_n(ptr, &exp, v, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); }
+    NX_INLN int nixAtomic_casPtr_(void* volatile* ptr, void* exp, void* v){ return __atomic_compare_exchange_n(ptr, &exp, v, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); }
 #endif
 
-#ifdef __cplusplus
-}
+// CPU RELAX (hint inside spin loops)
+
+#if defined(_MSC_VER)
+#   if defined(_M_IX86) || defined(_M_X64)
+#       define NIX_CPU_RELAX()          _mm_pause()
+#   else
+#       define NIX_CPU_RELAX()          __yield()
+#   endif
+#elif defined(__i386__) || defined(__x86_64__)
+#   define NIX_CPU_RELAX()              __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#   define NIX_CPU_RELAX()              __asm__ __volatile__("yield")
+#else
+#   define NIX_CPU_RELAX()              ((void)0)
+#endif
+
+// TRACE (spans, compiled only with NIX_TRACE)
+//
+// NIX_TRACE_BEGIN(VAR);                  //at the start of the span
+// NIX_TRACE_END(VAR, "name", id);        //at the end, 'name' must be a literal, 'id' identifies the object (source, converter...)
+
+#ifdef NIX_TRACE
+    void NixTrace_add(const char* name, const NixUI64 startNs, const NixUI64 id);
+#   define NIX_TRACE_BEGIN(VAR)             const NixUI64 VAR = NixClock_getMonotonicNs()
+#   define NIX_TRACE_END(VAR, NAME, ID)     NixTrace_add(NAME, VAR, (NixUI64)(size_t)(ID))
+#else
+#   define NIX_TRACE_BEGIN(VAR)             ((void)0)
+#   define NIX_TRACE_END(VAR, NAME, ID)     ((void)0)
+#endif
+
+// RT-CHECK (real-time safety, compiled only with NIX_RT_CHECK)
+//
+// NIX_RT_ENTER();                        //at the start of a device callback (real-time thread)
+// NIX_RT_EXIT();                         //before every return of the callback
+// NIX_RT_CHECK_CALL(type, dbgHintStr);   //at the memory hooks, reports if called from a real-time thread
+// NIX_RT_MUTEX_LOCK(mutex);              //NixMutex_lock used inside the library, reports the caller on contended locks
+// NIX_RT_MFREE(ctx, ptr);                //NixContext_mfree used inside the library, reports the caller
+
+#ifdef NIX_RT_CHECK
+    void NixRtCheck_violation(const ENNixRtViolation type, const char* dbgHintStr);
+    void NixMutex_lockAt_(STNixMutexRef ref, const char* dbgHintStr);
+    void NixContext_mfreeAt_(STNixContextRef ref, void* ptr, const char* dbgHintStr);
+#   define NIX_RT_ENTER()                   NixRtCheck_enter()
+#   define NIX_RT_EXIT()                    NixRtCheck_exit()
+#   define NIX_RT_CHECK_CALL(TYPE, HINT)    do { if(NixRtCheck_isRealtime()){ NixRtCheck_violation(TYPE, HINT); } } while(0)
+#   define NIX_RT_MUTEX_LOCK(REF)           NixMutex_lockAt_(REF, __func__)
+#   define NIX_RT_MFREE(REF, PTR)           NixContext_mfreeAt_(REF, PTR, __func__)
+#else
+#   define NIX_RT_ENTER()                   ((void)0)
+#   define NIX_RT_EXIT()                    ((void)0)
+#   define NIX_RT_CHECK_CALL(TYPE, HINT)    ((void)0)
+#   define NIX_RT_MUTEX_LOCK(REF)           NixMutex_lock(REF)
+#   define NIX_RT_MFREE(REF, PTR)           NixContext_mfree(REF, PTR)
 #endif
 
 #endif
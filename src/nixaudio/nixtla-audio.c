@@ -24,6 +24,7 @@
 #include <stdio.h>  //NULL
 #include <string.h> //memcpy, memset
 #include <stdlib.h> //malloc
+#include <stdarg.h> //va_list
 
 //-------------------------------
 //-- IDENTIFY OS
@@ -96,6 +97,7 @@ typedef struct STNixSharedPtr_ {
 
 struct STNixSharedPtr_* NixSharedPtr_alloc(STNixContextItf* itf, void* opq, const char* dbgHintStr){
     struct STNixSharedPtr_* obj = NULL;
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Malloc, dbgHintStr);
     obj = (struct STNixSharedPtr_*)(*itf->mem.malloc)(sizeof(struct STNixSharedPtr_), dbgHintStr);
     if(obj != NULL){
         obj->mutex = (itf->mutex.alloc)(itf);
@@ -108,6 +110,7 @@ struct STNixSharedPtr_* NixSharedPtr_alloc(STNixContextItf* itf, void* opq, cons
 }
 
 void NixSharedPtr_free(struct STNixSharedPtr_* obj){
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Free, "NixSharedPtr_free");
     NixMutex_free(&obj->mutex);
     (*obj->memItf.free)(obj);
 }
@@ -118,7 +121,7 @@ void* NixSharedPtr_getOpq(struct STNixSharedPtr_* obj){
 }
 
 void NixSharedPtr_retain(struct STNixSharedPtr_* obj){
-    NixMutex_lock(obj->mutex);
+    NIX_RT_MUTEX_LOCK(obj->mutex);
     {
         NIX_ASSERT(obj->retainCount > 0) //if fails, the pointer was re-activated during cleanup (change your code to avoid this)
         ++obj->retainCount;
@@ -134,9 +137,19 @@ void NixSharedPtr_retain(struct STNixSharedPtr_* obj){
     */
 }
 
+//Reactivates a pointer released to zero (used by pools to recycle objects)
+void NixSharedPtr_revive_(struct STNixSharedPtr_* obj){
+    NIX_RT_MUTEX_LOCK(obj->mutex);
+    {
+        NIX_ASSERT(obj->retainCount == 0)
+        obj->retainCount = 1;
+    }
+    NixMutex_unlock(obj->mutex);
+}
+
 NixSI32 NixSharedPtr_release(struct STNixSharedPtr_* obj){
     NixSI32 r = 0;
-    NixMutex_lock(obj->mutex);
+    NIX_RT_MUTEX_LOCK(obj->mutex);
     {
         NIX_ASSERT(obj->retainCount > 0)
         r = --obj->retainCount;
@@ -176,7 +189,9 @@ void TYPE ## _ ## METHOD PARAMS_DEFS { \
 #define STNixEngineRef_Zero     { NULL, NULL }
 
 STNixEngineRef NixEngine_alloc(STNixContextRef ctx, struct STNixApiItf_* apiItf){
-    return (ctx.ptr != NULL && apiItf != NULL && apiItf->engine.alloc != NULL ? (*apiItf->engine.alloc)(ctx) : (STNixEngineRef)STNixEngineRef_Zero);
+    STNixEngineRef r = (ctx.ptr != NULL && apiItf != NULL && apiItf->engine.alloc != NULL ? (*apiItf->engine.alloc)(ctx) : (STNixEngineRef)STNixEngineRef_Zero);
+    NixLog_flush(); //allocation errors are visible even without ticks
+    return r;
 }
 
 void NixEngine_retain(STNixEngineRef ref){
@@ -189,6 +204,7 @@ void NixEngine_release(STNixEngineRef* ref){
             if(ref->itf != NULL && ref->itf->free != NULL){
                 (*ref->itf->free)(*ref);
             }
+            NixLog_flush();
         }
     }
 }
@@ -213,6 +229,38 @@ STNixRecorderRef NixEngine_allocRecorder(STNixEngineRef ref, const STNixAudioDes
     return (ref.itf != NULL && ref.itf->allocRecorder != NULL ? (*ref.itf->allocRecorder)(ref, audioDesc, buffersCount, blocksPerBuffer) : (STNixRecorderRef)STNixRecorderRef_Zero);
 }
 
+//One-shots
+
+NIX_REF_METHOD_DEFINITION_BOOL(NixEngine, playOneShot, (STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority), (ref, buff, vol, priority))
+NIX_REF_METHOD_DEFINITION_BOOL(NixEngine, setOneShotsLimit, (STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal), (ref, maxConcurrent, steal))
+
+//Voices
+
+NIX_REF_METHOD_DEFINITION_BOOL(NixEngine, setVoicesLimit, (STNixEngineRef ref, const NixUI32 maxReal), (ref, maxReal))
+
+//Batch
+
+NIX_REF_METHOD_DEFINITION_VOID(NixEngine, playSources, (STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz), (ref, srcs, srcsSz))
+NIX_REF_METHOD_DEFINITION_VOID(NixEngine, stopSources, (STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz), (ref, srcs, srcsSz))
+
+//Clock
+
+NixUI64 NixEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec){
+    if(ref.itf != NULL && ref.itf->getFrameTime != NULL){
+        return (*ref.itf->getFrameTime)(ref, optDstFramesPerSec);
+    }
+    if(optDstFramesPerSec != NULL) *optDstFramesPerSec = 0;
+    return 0;
+}
+
+//Stats
+
+NIX_REF_METHOD_DEFINITION_BOOL(NixEngine, getStats, (STNixEngineRef ref, STNixEngineStats* dst), (ref, dst))
+
+//Real-time threads
+
+NIX_REF_METHOD_DEFINITION_BOOL(NixEngine, setRtThreadOpts, (STNixEngineRef ref, const STNixRtThreadOpts* opts), (ref, opts))
+
 //STNixBufferRef (shared pointer)
 
 #define STNixBufferRef_Zero     { NULL, NULL }
@@ -233,6 +281,16 @@ void NixBuffer_release(STNixBufferRef* ref){
 
 NIX_REF_METHOD_DEFINITION_BOOL(NixBuffer, setData, (STNixBufferRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes), (ref, audioDesc, audioDataPCM, audioDataPCMBytes) )
 NIX_REF_METHOD_DEFINITION_BOOL(NixBuffer, fillWithZeroes, (STNixBufferRef ref), (ref))
+NIX_REF_METHOD_DEFINITION_BOOL(NixBuffer, setDataUse, (STNixBufferRef ref, const NixUI32 bytes), (ref, bytes))
+
+NixUI8* NixBuffer_getData(STNixBufferRef ref, NixUI32* optDstUse, NixUI32* optDstSz){
+    if(ref.itf != NULL && ref.itf->getData != NULL){
+        return (*ref.itf->getData)(ref, optDstUse, optDstSz);
+    }
+    if(optDstUse != NULL) *optDstUse = 0;
+    if(optDstSz != NULL) *optDstSz = 0;
+    return NULL;
+}
 
 
 //STNixSourceRef (shared pointer)
@@ -266,6 +324,24 @@ NIX_REF_METHOD_DEFINITION_BOOL(NixSource, isRepeat, (STNixSourceRef ref), (ref))
 NIX_REF_METHOD_DEFINITION_FLOAT(NixSource, getVolume, (STNixSourceRef ref), (ref))
 NIX_REF_METHOD_DEFINITION_BOOL(NixSource, setBuffer, (STNixSourceRef ref, STNixBufferRef buff), (ref, buff))
 NIX_REF_METHOD_DEFINITION_BOOL(NixSource, queueBuffer, (STNixSourceRef ref, STNixBufferRef buff), (ref, buff))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, queueBufferMove, (STNixSourceRef ref, STNixBufferRef* buff), (ref, buff))
+
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, playAt, (STNixSourceRef ref, const NixUI64 engFrame), (ref, engFrame))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, stopAt, (STNixSourceRef ref, const NixUI64 engFrame), (ref, engFrame))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, queueBufferAt, (STNixSourceRef ref, STNixBufferRef buff, const NixUI64 engFrame), (ref, buff, engFrame))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, getStartError, (STNixSourceRef ref, NixSI64* dstFrames), (ref, dstFrames))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, getCounters, (STNixSourceRef ref, STNixSourceCounters* dst), (ref, dst))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, getClock, (STNixSourceRef ref, STNixSourceClock* dst), (ref, dst))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, setLowWatermark, (STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData), (ref, type, amount, callback, callbackData))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, setRenderCallback, (STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData), (ref, fmt, callback, callbackData))
+
+NixUI32 NixSource_queueBuffers(STNixSourceRef ref, const STNixBufferRef* buffs, const NixUI32 buffsSz){ //stream-source
+    if(ref.itf != NULL && ref.itf->queueBuffers != NULL){
+        return (*ref.itf->queueBuffers)(ref, buffs, buffsSz);
+    }
+    return 0;
+}
+
 NIX_REF_METHOD_DEFINITION_BOOL(NixSource, setBufferOffset, (STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset), (ref,  type, offset))
 NixUI32 NixSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount){   //all buffer queue
     if(ref.itf != NULL && ref.itf->getBuffersCount != NULL){
@@ -287,6 +363,9 @@ NixUI32 NixSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount,
     return 0;
 }
 
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, setPriority, (STNixSourceRef ref, const NixUI8 priority), (ref, priority))
+NIX_REF_METHOD_DEFINITION_BOOL(NixSource, isVirtual, (STNixSourceRef ref), (ref))
+
 //STNixRecorderRef (shared pointer)
 
 #define STNixRecorderRef_Zero     { NULL, NULL }
@@ -310,6 +389,7 @@ NIX_REF_METHOD_DEFINITION_BOOL(NixRecorder, start, (STNixRecorderRef ref), (ref)
 NIX_REF_METHOD_DEFINITION_BOOL(NixRecorder, stop, (STNixRecorderRef ref), (ref))
 NIX_REF_METHOD_DEFINITION_BOOL(NixRecorder, flush, (STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying), (ref, includeCurrentPartialBuff, discardWithoutNotifying))
 NIX_REF_METHOD_DEFINITION_BOOL(NixRecorder, isCapturing, (STNixRecorderRef ref), (ref))
+NIX_REF_METHOD_DEFINITION_BOOL(NixRecorder, getCounters, (STNixRecorderRef ref, STNixRecorderCounters* dst), (ref, dst))
 NixUI32 NixRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount){  //relative to first buffer in queue
     if(ref.itf != NULL && ref.itf->getBuffersFilledCount != NULL){
         return (*ref.itf->getBuffersFilledCount)(ref, optDstBytesCount, optDstBlocksCount, optDstMsecsCount);
@@ -323,10 +403,31 @@ NixUI32 NixRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstB
 // STNixMutexRef
 
 void NixMutex_lock(STNixMutexRef ref){
+#   ifdef NIX_RT_CHECK
+    NixMutex_lockAt_(ref, "NixMutex_lock");
+#   else
+    if(ref.opq != NULL && ref.itf != NULL && ref.itf->lock != NULL){
+        (*ref.itf->lock)(ref);
+    }
+#   endif
+}
+
+#ifdef NIX_RT_CHECK
+NixBOOL NixMutexItf_nop_trylock(STNixMutexRef pObj); //defined below
+
+void NixMutex_lockAt_(STNixMutexRef ref, const char* dbgHintStr){
     if(ref.opq != NULL && ref.itf != NULL && ref.itf->lock != NULL){
+        //contention probe (not possible with user's interfaces without trylock, left untested)
+        if(NixRtCheck_isRealtime() && ref.itf->trylock != NULL && ref.itf->trylock != NixMutexItf_nop_trylock){
+            if((*ref.itf->trylock)(ref)){
+                return; //acquired without blocking
+            }
+            NixRtCheck_violation(ENNixRtViolation_Lock, dbgHintStr);
+        }
         (*ref.itf->lock)(ref);
     }
 }
+#endif
 
 void NixMutex_unlock(STNixMutexRef ref){
     if(ref.opq != NULL && ref.itf != NULL && ref.itf->unlock != NULL){
@@ -394,13 +495,17 @@ void NixMemoryItf_fillMissingMembers(STNixMemoryItf* itf){
 #       define NIX_MUTEX_DESTROY(PTR)   DeleteCriticalSection(PTR)
 #       define NIX_MUTEX_LOCK(PTR)      EnterCriticalSection(PTR)
 #       define NIX_MUTEX_UNLOCK(PTR)    LeaveCriticalSection(PTR)
+#       define NIX_MUTEX_TRYLOCK(PTR)   (TryEnterCriticalSection(PTR) != 0)
 #   else
 #       include <pthread.h>             //for pthread_mutex_t
+#       include <unistd.h>              //for _POSIX_THREAD_PRIO_INHERIT
+#       define NIX_MUTEX_PTHREAD        //allows priority-inheritance attributes
 #       define NIX_MUTEX_T              pthread_mutex_t
 #       define NIX_MUTEX_INIT(PTR)      pthread_mutex_init(PTR, NULL)
 #       define NIX_MUTEX_DESTROY(PTR)   pthread_mutex_destroy(PTR)
 #       define NIX_MUTEX_LOCK(PTR)      pthread_mutex_lock(PTR)
 #       define NIX_MUTEX_UNLOCK(PTR)    pthread_mutex_unlock(PTR)
+#       define NIX_MUTEX_TRYLOCK(PTR)   (pthread_mutex_trylock(PTR) == 0)
 #   endif
 #endif
 
@@ -421,6 +526,26 @@ STNixMutexRef NixMutexItf_default_alloc(struct STNixContextItf_* ctx){
     return r;
 }
 
+#if defined(NIX_MUTEX_PTHREAD) && defined(_POSIX_THREAD_PRIO_INHERIT) && (_POSIX_THREAD_PRIO_INHERIT > 0)
+STNixMutexRef NixMutexItf_prioInherit_alloc(struct STNixContextItf_* ctx){
+    STNixMutexRef r = STNixMutexRef_Zero;
+    STNixMutexOpq* obj = (STNixMutexOpq*)(*ctx->mem.malloc)(sizeof(STNixMutexOpq), "NixMutexItf_prioInherit_alloc");
+    if(obj != NULL){
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        if(0 != pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT)){
+            NIX_PRINTF_WARNING("NixMutexItf_prioInherit_alloc, PTHREAD_PRIO_INHERIT rejected, using a normal mutex.\n");
+        }
+        pthread_mutex_init(&obj->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+        obj->ctx = *ctx;
+        r.opq = obj;
+        r.itf = &obj->ctx.mutex;
+    }
+    return r;
+}
+#endif
+
 void NixMutexItf_default_free(STNixMutexRef* pObj){
     if(pObj != NULL){
         STNixMutexOpq* obj = (STNixMutexOpq*)pObj->opq;
@@ -447,10 +572,224 @@ void NixMutexItf_default_unlock(STNixMutexRef pObj){
     }
 }
 
+NixBOOL NixMutexItf_default_trylock(STNixMutexRef pObj){
+    NixBOOL r = NIX_FALSE;
+    if(pObj.opq != NULL){
+        STNixMutexOpq* obj = (STNixMutexOpq*)pObj.opq;
+        r = (NIX_MUTEX_TRYLOCK(&obj->mutex) ? NIX_TRUE : NIX_FALSE);
+    }
+    return r;
+}
+
+NixBOOL NixMutexItf_nop_trylock(STNixMutexRef pObj){
+    return NIX_FALSE;
+}
+
+STNixMutexItf NixMutexItf_getPrioInherit(void){
+    STNixMutexItf itf;
+    memset(&itf, 0, sizeof(itf));
+#   if defined(NIX_MUTEX_PTHREAD) && defined(_POSIX_THREAD_PRIO_INHERIT) && (_POSIX_THREAD_PRIO_INHERIT > 0)
+    itf.alloc   = NixMutexItf_prioInherit_alloc;
+    itf.free    = NixMutexItf_default_free;
+    itf.lock    = NixMutexItf_default_lock;
+    itf.unlock  = NixMutexItf_default_unlock;
+    itf.trylock = NixMutexItf_default_trylock;
+#   else
+    NixMutexItf_fillMissingMembers(&itf);
+#   endif
+    return itf;
+}
+
+//STNixMutexItf (fast)
+//Three states word (0 = unlocked, 1 = locked, 2 = locked with sleepers),
+//the owner only makes a wake syscall when someone parked.
+
+#if defined(__APPLE__)
+#   include <os/lock.h>                 //for os_unfair_lock
+#   define NIX_MUTEX_FAST_NATIVE
+#elif defined(__linux__) || defined(__ANDROID__)
+#   include <unistd.h>                  //for syscall
+#   include <sys/syscall.h>             //for SYS_futex
+#   include <linux/futex.h>             //for FUTEX_WAIT_PRIVATE
+#   define NIX_MUTEX_FAST_WAIT(PTR, V)  syscall(SYS_futex, (PTR), FUTEX_WAIT_PRIVATE, (V), NULL, NULL, 0)
+#   define NIX_MUTEX_FAST_WAKE1(PTR)    syscall(SYS_futex, (PTR), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0)
+#elif defined(_WIN32) && (!defined(_WIN32_WINNT) || _WIN32_WINNT >= 0x0602)
+#   include <windows.h>                 //for WaitOnAddress (Windows 8+)
+#   pragma comment(lib, "Synchronization.lib")
+#   define NIX_MUTEX_FAST_WAIT(PTR, V)  { NixUI32 v_ = (V); WaitOnAddress((volatile VOID*)(PTR), &v_, sizeof(v_), INFINITE); }
+#   define NIX_MUTEX_FAST_WAKE1(PTR)    WakeByAddressSingle((PVOID)(PTR))
+#endif
+
+#if defined(NIX_MUTEX_FAST_NATIVE) || defined(NIX_MUTEX_FAST_WAIT)
+
+typedef struct STNixMutexFastOpq_ {
+#   ifdef NIX_MUTEX_FAST_NATIVE
+    os_unfair_lock          lock;
+#   else
+    volatile NixUI32        state;
+#   endif
+    STNixMutexItf*          itf;    //returned in refs
+    void                    (*free)(void* ptr);
+} STNixMutexFastOpq;
+
+static STNixMutexItf NixMutexItf_fast_; //shared by all the fast mutexes (refs point to it), defined below
+static volatile NixUI32 NixMutexItf_fastSpins_ = 0xFFFFFFFFu; //NIX_MUTEX_FAST_SPINS, or zero on single-CPU devices (the owner cannot run while spinning); atomic, set by the first alloc
+
+static NixUI32 NixMutexItf_fast_getSpins_(void){
+    NixUI32 r = NIX_ATOMIC_LOAD32(&NixMutexItf_fastSpins_);
+    if(r == 0xFFFFFFFFu){
+        NixUI32 cpus = 2;
+#       if defined(_WIN32)
+        {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            cpus = (NixUI32)info.dwNumberOfProcessors;
+        }
+#       elif defined(_SC_NPROCESSORS_ONLN)
+        cpus = (NixUI32)sysconf(_SC_NPROCESSORS_ONLN);
+#       endif
+        r = (cpus > 1 ? NIX_MUTEX_FAST_SPINS : 0);
+        NIX_ATOMIC_STORE32(&NixMutexItf_fastSpins_, r); //same value from any thread
+    }
+    return r;
+}
+
+STNixMutexRef NixMutexItf_fast_alloc(struct STNixContextItf_* ctx){
+    STNixMutexRef r = STNixMutexRef_Zero;
+    STNixMutexFastOpq* obj = (STNixMutexFastOpq*)(*ctx->mem.malloc)(sizeof(STNixMutexFastOpq), "NixMutexItf_fast_alloc");
+    NixMutexItf_fast_getSpins_(); //resolved before the first lock (not in the contended path)
+    if(obj != NULL){
+        memset(obj, 0, sizeof(*obj));
+#       ifdef NIX_MUTEX_FAST_NATIVE
+        obj->lock   = OS_UNFAIR_LOCK_INIT;
+#       endif
+        obj->itf    = &NixMutexItf_fast_;
+        obj->free   = ctx->mem.free;
+        r.opq = obj;
+        r.itf = obj->itf;
+    }
+    return r;
+}
+
+void NixMutexItf_fast_free(STNixMutexRef* pObj){
+    if(pObj != NULL){
+        STNixMutexFastOpq* obj = (STNixMutexFastOpq*)pObj->opq;
+        if(obj != NULL){
+#           ifndef NIX_MUTEX_FAST_NATIVE
+            NIX_ASSERT(obj->state == 0) //should be unlocked
+#           endif
+            (*obj->free)(obj);
+        }
+        pObj->opq = NULL;
+        pObj->itf = NULL;
+    }
+}
+
+NixBOOL NixMutexItf_fast_trylock(STNixMutexRef pObj){
+    NixBOOL r = NIX_FALSE;
+    STNixMutexFastOpq* obj = (STNixMutexFastOpq*)pObj.opq;
+    if(obj != NULL){
+#       ifdef NIX_MUTEX_FAST_NATIVE
+        r = (os_unfair_lock_trylock(&obj->lock) ? NIX_TRUE : NIX_FALSE);
+#       else
+        r = (NIX_ATOMIC_CAS32(&obj->state, 0, 1) ? NIX_TRUE : NIX_FALSE);
+#       endif
+    }
+    return r;
+}
+
+void NixMutexItf_fast_lock(STNixMutexRef pObj){
+    STNixMutexFastOpq* obj = (STNixMutexFastOpq*)pObj.opq;
+    if(obj != NULL){
+        //uncontended
+#       ifdef NIX_MUTEX_FAST_NATIVE
+        if(os_unfair_lock_trylock(&obj->lock)){
+            return;
+        }
+#       else
+        if(NIX_ATOMIC_CAS32(&obj->state, 0, 1)){
+            return;
+        }
+#       endif
+        //spin (the owner usually releases in a few hundred cycles)
+        {
+            const NixUI32 spins = NixMutexItf_fast_getSpins_();
+            NixUI32 i; for(i = 0; i < spins; i++){
+                NIX_CPU_RELAX();
+#               ifdef NIX_MUTEX_FAST_NATIVE
+                if(os_unfair_lock_trylock(&obj->lock)){
+                    return;
+                }
+#               else
+                if(obj->state == 0 && NIX_ATOMIC_CAS32(&obj->state, 0, 1)){
+                    return;
+                }
+#               endif
+            }
+        }
+        //park
+#       ifdef NIX_MUTEX_FAST_NATIVE
+        os_unfair_lock_lock(&obj->lock);
+#       else
+        while(NIX_ATOMIC_XCHG32(&obj->state, 2) != 0){
+            NIX_MUTEX_FAST_WAIT(&obj->state, 2);
+        }
+#       endif
+    }
+}
+
+void NixMutexItf_fast_unlock(STNixMutexRef pObj){
+    STNixMutexFastOpq* obj = (STNixMutexFastOpq*)pObj.opq;
+    if(obj != NULL){
+#       ifdef NIX_MUTEX_FAST_NATIVE
+        os_unfair_lock_unlock(&obj->lock);
+#       else
+        if(NIX_ATOMIC_XCHG32(&obj->state, 0) == 2){
+            NIX_MUTEX_FAST_WAKE1(&obj->state);
+        }
+#       endif
+    }
+}
+
+static STNixMutexItf NixMutexItf_fast_ = {
+    NixMutexItf_fast_alloc,
+    NixMutexItf_fast_free,
+    NixMutexItf_fast_lock,
+    NixMutexItf_fast_unlock,
+    NixMutexItf_fast_trylock
+};
+
+#endif
+
+STNixMutexItf NixMutexItf_getFast(void){
+    STNixMutexItf itf;
+    memset(&itf, 0, sizeof(itf));
+#   if defined(NIX_MUTEX_FAST_NATIVE) || defined(NIX_MUTEX_FAST_WAIT)
+    itf = NixMutexItf_fast_;
+#   else
+    NixMutexItf_fillMissingMembers(&itf);
+#   endif
+    return itf;
+}
+
 //Links NULL methods to a DEFAULT implementation,
 //this reduces the need to check for functions NULL pointers.
 void NixMutexItf_fillMissingMembers(STNixMutexItf* itf){
     if(itf == NULL) return;
+#   if defined(NIX_MUTEX_FAST_DEFAULT) && (defined(NIX_MUTEX_FAST_NATIVE) || defined(NIX_MUTEX_FAST_WAIT))
+    if(itf->alloc == NULL && itf->free == NULL && itf->lock == NULL && itf->unlock == NULL && itf->trylock == NULL){
+        *itf = NixMutexItf_fast_;
+        return;
+    }
+#   endif
+    //trylock (the default only works with the default lock)
+    if(itf->trylock == NULL){
+        if(itf->lock == NULL){
+            itf->trylock = NixMutexItf_default_trylock;
+        } else {
+            itf->trylock = NixMutexItf_nop_trylock;
+        }
+    }
     NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixMutexItf, alloc);
     NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixMutexItf, free);
     NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixMutexItf, lock);
@@ -468,104 +807,776 @@ void NixMutexItf_fillMissingMembers(STNixMutexItf* itf){
 #   endif
 }
 
-//STNixContextRef
+//Clock
 
-typedef struct STNixContextOpq_ {
-    NixUI32 dummy;  //empty struct
-} STNixContextOpq;
+#ifdef _WIN32
+#   include <windows.h> //QueryPerformanceCounter
+NixUI64 NixClock_getMonotonicUs(void){
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER cur;
+    if(freq.QuadPart == 0){
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&cur);
+    return (NixUI64)(cur.QuadPart / freq.QuadPart) * 1000000ull + (NixUI64)(cur.QuadPart % freq.QuadPart) * 1000000ull / (NixUI64)freq.QuadPart;
+}
+NixUI64 NixClock_getMonotonicNs(void){
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER cur;
+    if(freq.QuadPart == 0){
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&cur);
+    return (NixUI64)(cur.QuadPart / freq.QuadPart) * 1000000000ull + (NixUI64)(cur.QuadPart % freq.QuadPart) * 1000000000ull / (NixUI64)freq.QuadPart;
+}
+#else
+#   include <time.h>    //clock_gettime
+NixUI64 NixClock_getMonotonicUs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (NixUI64)ts.tv_sec * 1000000ull + (NixUI64)ts.tv_nsec / 1000ull;
+}
+NixUI64 NixClock_getMonotonicNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (NixUI64)ts.tv_sec * 1000000000ull + (NixUI64)ts.tv_nsec;
+}
+#endif
 
-STNixContextRef NixContext_alloc(STNixContextItf* ctx){
-    STNixContextRef r = STNixContextRef_Zero;
-    if(ctx != NULL){
-        STNixContextOpq* opq = (STNixContextOpq*)(ctx->mem.malloc)(sizeof(STNixContextOpq), "NixContext_alloc::opq");
-        STNixContextItf* itf = (STNixContextItf*)(ctx->mem.malloc)(sizeof(STNixContextItf), "NixContext_alloc::itf");
-        STNixSharedPtr* ptr  = NixSharedPtr_alloc(ctx, opq, "NixContext_alloc");
-        if(opq != NULL && itf != NULL && ptr != NULL){
-            memset(opq, 0, sizeof(*opq));
-            memcpy(itf, ctx, sizeof(*itf));
-            r.ptr = ptr; ptr = NULL; //consume
-            r.itf = itf; itf = NULL; //consume
-            opq = NULL; //consume
-        }
-        //release (if not consumed)
-        if(opq != NULL){
-            (ctx->mem.free)(opq);
-            opq = NULL;
+//------
+//Log
+//------
+
+//Queue slot, 'seq' is relative to the slot's lap (zero-initialized queue is empty):
+//'lap' is free for the writer at position 'lap + i', 'lap + 1' is ready for the reader, 'lap + NIX_LOG_QUEUE_SZ' is free for the next lap.
+typedef struct STNixLogSlot_ {
+    volatile NixUI32    seq;
+    NixUI32             level;
+    char                msg[NIX_LOG_MSG_SZ];
+} STNixLogSlot;
+
+//Repeated messages (by format), approximated without locks (every field is accessed atomically).
+typedef struct STNixLogRepeat_ {
+    const char* volatile fmt;
+    volatile NixUI32    windowMs;
+    volatile NixUI32    count;
+    volatile NixUI32    suppressed;
+} STNixLogRepeat;
+
+#define NIX_LOG_REPEAT_SLOTS    64  //must be power of two
+
+static struct {
+    STNixLogSlot        slots[NIX_LOG_QUEUE_SZ];
+    volatile NixUI32    iWrite;     //multiple producers
+    NixUI32             iRead;      //single consumer (NixLog_flush)
+    volatile NixUI32    isFlushing;
+    volatile NixUI32    dropped;    //queue was full
+    STNixLogRepeat      repeats[NIX_LOG_REPEAT_SLOTS];
+    //sink
+    NixLogSinkFnc volatile sink;
+    void* volatile      sinkData;
+} NixLog_ = { 0 };
+
+void NixLog_sinkDefault_(const ENNixLogLevel level, const char* msg, void* userdata){
+#   if defined(__ANDROID__) //Android
+    __android_log_print((level == ENNixLogLevel_Error ? ANDROID_LOG_ERROR : level == ENNixLogLevel_Warning ? ANDROID_LOG_WARN : ANDROID_LOG_INFO), "Nixtla", "%s%s", (level == ENNixLogLevel_Error ? "ERROR, " : level == ENNixLogLevel_Warning ? "WARNING, " : ""), msg);
+#   elif defined(__QNX__) //BB10
+    FILE* f = (level == ENNixLogLevel_Error ? stderr : stdout);
+    fprintf(f, "%s%s", (level == ENNixLogLevel_Error ? "Nix ERROR, " : level == ENNixLogLevel_Warning ? "Nix WARNING, " : "Nix, "), msg); fflush(f);
+#   else
+    printf("%s%s", (level == ENNixLogLevel_Error ? "Nix ERROR, " : level == ENNixLogLevel_Warning ? "Nix WARNING, " : "Nix, "), msg);
+#   endif
+}
+
+NixBOOL NixLog_push_(const ENNixLogLevel level, const char* fmt, va_list args){
+    NixBOOL r = NIX_FALSE;
+    NixUI32 pos = NIX_ATOMIC_LOAD32(&NixLog_.iWrite);
+    STNixLogSlot* slot = NULL;
+    //claim a slot
+    while(slot == NULL){
+        STNixLogSlot* s = &NixLog_.slots[pos & (NIX_LOG_QUEUE_SZ - 1)];
+        const NixUI32 lap = (pos & ~(NixUI32)(NIX_LOG_QUEUE_SZ - 1));
+        const NixSI32 diff = (NixSI32)(NIX_ATOMIC_LOAD32(&s->seq) - lap);
+        if(diff == 0){
+            if(NIX_ATOMIC_CAS32(&NixLog_.iWrite, pos, pos + 1)){
+                slot = s;
+            } else {
+                pos = NIX_ATOMIC_LOAD32(&NixLog_.iWrite);
+            }
+        } else if(diff < 0){
+            //full (not consumed yet)
+            NIX_ATOMIC_ADD32(&NixLog_.dropped, 1);
+            break;
+        } else {
+            //claimed by other producer
+            pos = NIX_ATOMIC_LOAD32(&NixLog_.iWrite);
         }
-        if(itf != NULL){
-            (ctx->mem.free)(itf);
-            itf = NULL;
+    }
+    //fill and publish
+    if(slot != NULL){
+        slot->level = level;
+        vsnprintf(slot->msg, sizeof(slot->msg), fmt, args);
+        NIX_ATOMIC_STORE32(&slot->seq, (pos & ~(NixUI32)(NIX_LOG_QUEUE_SZ - 1)) + 1);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL NixLog_pushf_(const ENNixLogLevel level, const char* fmt, ...) NIX_PRINTF_FMT_ATTR(2, 3);
+
+NixBOOL NixLog_pushf_(const ENNixLogLevel level, const char* fmt, ...){
+    NixBOOL r;
+    va_list args;
+    va_start(args, fmt);
+    r = NixLog_push_(level, fmt, args);
+    va_end(args);
+    return r;
+}
+
+void NixLog_post(const ENNixLogLevel level, const char* fmt, ...){
+    //repeated messages (approximated; the format and the window are claimed with CAS by one producer)
+    {
+        STNixLogRepeat* rep = &NixLog_.repeats[((size_t)fmt >> 3) & (NIX_LOG_REPEAT_SLOTS - 1)];
+        const NixUI32 nowMs = (NixUI32)(NixClock_getMonotonicUs() / 1000ull);
+        const char* repFmt = (const char*)NIX_ATOMIC_LOADPTR(&rep->fmt);
+        NixBOOL isLimited = NIX_TRUE;
+        if(repFmt != fmt){
+            //new format in this slot
+            if(!NIX_ATOMIC_CASPTR(&rep->fmt, repFmt, fmt)){
+                //other producer claimed the slot, not limited this time
+                isLimited = NIX_FALSE;
+            } else {
+                const NixUI32 suppressed = NIX_ATOMIC_XCHG32(&rep->suppressed, 0);
+                NIX_ATOMIC_STORE32(&rep->windowMs, nowMs);
+                NIX_ATOMIC_STORE32(&rep->count, 0);
+                if(suppressed > 0){
+                    NixLog_pushf_(level, "(%u similar messages suppressed)\n", suppressed);
+                }
+            }
+        } else {
+            const NixUI32 windowMs = NIX_ATOMIC_LOAD32(&rep->windowMs);
+            if((nowMs - windowMs) >= NIX_LOG_REPEAT_WINDOW_MS && NIX_ATOMIC_CAS32(&rep->windowMs, windowMs, nowMs)){
+                //new window
+                const NixUI32 suppressed = NIX_ATOMIC_XCHG32(&rep->suppressed, 0);
+                NIX_ATOMIC_STORE32(&rep->count, 0);
+                if(suppressed > 0){
+                    NixLog_pushf_(level, "(%u similar messages suppressed)\n", suppressed);
+                }
+            }
         }
-        if(ptr != NULL){
-            NixSharedPtr_free(ptr);
-            ptr = NULL;
+        if(isLimited && NIX_ATOMIC_ADD32(&rep->count, 1) > NIX_LOG_REPEAT_MAX){
+            NIX_ATOMIC_ADD32(&rep->suppressed, 1);
+            return;
         }
     }
-    return r;
+    //queue
+    {
+        va_list args;
+        va_start(args, fmt);
+        NixLog_push_(level, fmt, args);
+        va_end(args);
+    }
 }
 
-void NixContext_retain(STNixContextRef ref){
-    NixSharedPtr_retain(ref.ptr);
+void NixLog_setSink(NixLogSinkFnc sink, void* userdata){
+    NIX_ATOMIC_STOREPTR(&NixLog_.sinkData, userdata);
+    NIX_ATOMIC_STOREPTR(&NixLog_.sink, sink);
 }
 
-void NixContext_release(STNixContextRef* ref){
-    if(ref != NULL && 0 == NixSharedPtr_release(ref->ptr)){
-        STNixContextOpq* opq = (STNixContextOpq*)NixSharedPtr_getOpq(ref->ptr);
-        STNixContextRef cpy = *ref;
-        *ref = (STNixContextRef)STNixContextRef_Zero;
-        //free
-        if(opq != NULL){
-            (cpy.itf->mem.free)(opq);
-            opq = NULL;
+NixUI32 NixLog_flush(void){
+    NixUI32 r = 0;
+    //single consumer (concurrent calls return immediately)
+    if(NIX_ATOMIC_CAS32(&NixLog_.isFlushing, 0, 1)){
+        NixLogSinkFnc sink = (NixLogSinkFnc)NIX_ATOMIC_LOADPTR(&NixLog_.sink);
+        void* sinkData = NIX_ATOMIC_LOADPTR(&NixLog_.sinkData);
+        const NixUI32 dropped = NIX_ATOMIC_LOAD32(&NixLog_.dropped);
+        if(sink == NULL){
+            sink = NixLog_sinkDefault_;
         }
-        if(cpy.itf != NULL){
-            (cpy.itf->mem.free)(cpy.itf);
-            cpy.itf = NULL;
+        while(NIX_TRUE){
+            STNixLogSlot* slot = &NixLog_.slots[NixLog_.iRead & (NIX_LOG_QUEUE_SZ - 1)];
+            const NixUI32 lap = (NixLog_.iRead & ~(NixUI32)(NIX_LOG_QUEUE_SZ - 1));
+            if(NIX_ATOMIC_LOAD32(&slot->seq) != lap + 1){
+                //empty (or being filled)
+                break;
+            }
+            (*sink)((ENNixLogLevel)slot->level, slot->msg, sinkData);
+            NIX_ATOMIC_STORE32(&slot->seq, lap + NIX_LOG_QUEUE_SZ); //free for next lap
+            ++NixLog_.iRead;
+            ++r;
         }
-        if(cpy.ptr != NULL){
-            NixSharedPtr_free(cpy.ptr);
-            cpy.ptr = NULL;
+        if(dropped > 0){
+            char msg[64];
+            NIX_ATOMIC_SUB32(&NixLog_.dropped, dropped);
+            snprintf(msg, sizeof(msg), "(%u messages dropped, log queue was full)\n", dropped);
+            (*sink)(ENNixLogLevel_Warning, msg, sinkData);
         }
+        NIX_ATOMIC_STORE32(&NixLog_.isFlushing, 0);
     }
+    return r;
 }
 
-void NixContext_set(STNixContextRef* ref, STNixContextRef other){
-    //retain first
-    if(other.ptr != NULL){
-        NixContext_retain(other);
-    }
-    //release after
-    if(ref->ptr != NULL){
-        NixContext_release(ref);
-    }
-    //set
-    *ref = other;
+//------
+//EngineClock
+//------
+
+void NixEngineClock_init(STNixEngineClock* obj, const NixUI32 rate){
+    obj->originUs = NixClock_getMonotonicUs();
+    obj->rate = rate;
 }
 
-void NixContext_null(STNixContextRef* ref){
-    *ref = (STNixContextRef)STNixContextRef_Zero;
+NixUI64 NixEngineClock_getFrame(const STNixEngineClock* obj){
+    const NixUI64 us = NixClock_getMonotonicUs() - obj->originUs;
+    return (us / 1000000ull) * obj->rate + (us % 1000000ull) * obj->rate / 1000000ull;
 }
 
-//context (memory)
+NixUI64 NixEngineClock_frameToUs(const STNixEngineClock* obj, const NixUI64 frame){
+    return obj->originUs + (obj->rate == 0 ? 0 : (frame / obj->rate) * 1000000ull + (frame % obj->rate) * 1000000ull / obj->rate);
+}
 
-void* NixContext_malloc(STNixContextRef ref, const NixUI32 newSz, const char* dbgHintStr){
-    return (ref.itf != NULL && ref.itf->mem.malloc != NULL ? (*ref.itf->mem.malloc)(newSz, dbgHintStr) : NULL);
+NixSI64 NixEngineClock_usToFrames(const STNixEngineClock* obj, const NixSI64 us){
+    return (us / 1000000ll) * (NixSI64)obj->rate + (us % 1000000ll) * (NixSI64)obj->rate / 1000000ll;
 }
 
-void* NixContext_mrealloc(STNixContextRef ref, void* ptr, const NixUI32 newSz, const char* dbgHintStr){
-    return (ref.itf != NULL && ref.itf->mem.realloc != NULL ? (*ref.itf->mem.realloc)(ptr, newSz, dbgHintStr) : NULL);
+//------
+//EngineStats
+//------
+
+void NixEngineStats_init(STNixEngineStatsState* obj){
+    memset(obj, 0, sizeof(*obj));
 }
 
-void NixContext_mfree(STNixContextRef ref, void* ptr){
-    if(ref.itf != NULL && ref.itf->mem.free != NULL){
-        (*ref.itf->mem.free)(ptr);
+void NixEngineStats_setMax32_(volatile NixUI32* dst, const NixUI32 v){
+    NixUI32 cur = NIX_ATOMIC_LOAD32(dst);
+    while(cur < v && !NIX_ATOMIC_CAS32(dst, cur, v)){
+        cur = NIX_ATOMIC_LOAD32(dst);
     }
 }
 
-//context (mutex)
+void NixEngineStats_addTick(STNixEngineStatsState* obj, const NixUI64 ns, const NixUI32 buffsNotified){
+    const NixUI32 us = (ns / 1000ull > 0xFFFFFFFFull ? 0xFFFFFFFFu : (NixUI32)(ns / 1000ull));
+    NixUI32 iHist = 0, limit = 250;
+    while(iHist < (NIX_ENGINE_STATS_TICK_HIST_SZ - 1) && us >= limit){
+        limit *= 2;
+        iHist++;
+    }
+    NIX_ATOMIC_ADD64(&obj->ticks, 1);
+    NIX_ATOMIC_ADD64(&obj->tickNsSum, ns);
+    NIX_ATOMIC_STORE32(&obj->tickUsLast, us);
+    NixEngineStats_setMax32_(&obj->tickUsMax, us);
+    NIX_ATOMIC_ADD32(&obj->tickUsHist[iHist], 1);
+    //buffers
+    {
+        const NixUI64 queued = NIX_ATOMIC_LOAD64(&obj->buffsQueued);
+        NIX_ATOMIC_STORE32(&obj->buffsQueuedLastTick, (NixUI32)(queued - obj->buffsQueuedAtTick));
+        obj->buffsQueuedAtTick = queued; //only accessed by tick
+    }
+    NIX_ATOMIC_ADD64(&obj->buffsNotified, buffsNotified);
+    NIX_ATOMIC_STORE32(&obj->buffsNotifiedLastTick, buffsNotified);
+}
 
-STNixMutexRef NixContext_mutex_alloc(STNixContextRef ref){
-    return (ref.itf != NULL && ref.itf->mutex.alloc != NULL ? (*ref.itf->mutex.alloc)(ref.itf) : (STNixMutexRef)STNixMutexRef_Zero);
+void NixEngineStats_addCallback(STNixEngineStatsState* obj, const NixUI64 ns){
+    NIX_ATOMIC_ADD64(&obj->callbacks, 1);
+    NIX_ATOMIC_ADD64(&obj->callbacksNs, ns);
+    NixEngineStats_setMax32_(&obj->callbackUsMax, (ns / 1000ull > 0xFFFFFFFFull ? 0xFFFFFFFFu : (NixUI32)(ns / 1000ull)));
+}
+
+void NixEngineStats_addConv(STNixEngineStatsState* obj, const NixUI64 bytes, const NixUI64 ns){
+    NIX_ATOMIC_ADD64(&obj->convBytes, bytes);
+    NIX_ATOMIC_ADD64(&obj->convNs, ns);
+}
+
+void NixEngineStats_addQueued(STNixEngineStatsState* obj, const NixUI32 buffs){
+    NIX_ATOMIC_ADD64(&obj->buffsQueued, buffs);
+}
+
+void NixEngineStats_addUnderrun(STNixEngineStatsState* obj){
+    NIX_ATOMIC_ADD64(&obj->underruns, 1);
+}
+
+void NixEngineStats_addRecOverrun(STNixEngineStatsState* obj, const NixUI32 frames){
+    NIX_ATOMIC_ADD64(&obj->recOverruns, frames);
+}
+
+void NixEngineStats_get(STNixEngineStatsState* obj, STNixEngineStats* dst){
+    NixUI32 i;
+    memset(dst, 0, sizeof(*dst));
+    dst->ticks          = NIX_ATOMIC_LOAD64(&obj->ticks);
+    dst->tickUsLast     = NIX_ATOMIC_LOAD32(&obj->tickUsLast);
+    dst->tickUsAvg      = (dst->ticks == 0 ? 0 : (NixUI32)(NIX_ATOMIC_LOAD64(&obj->tickNsSum) / dst->ticks / 1000ull));
+    dst->tickUsMax      = NIX_ATOMIC_LOAD32(&obj->tickUsMax);
+    for(i = 0; i < NIX_ENGINE_STATS_TICK_HIST_SZ; i++){
+        dst->tickUsHist[i] = NIX_ATOMIC_LOAD32(&obj->tickUsHist[i]);
+    }
+    dst->buffsQueued    = NIX_ATOMIC_LOAD64(&obj->buffsQueued);
+    dst->buffsNotified  = NIX_ATOMIC_LOAD64(&obj->buffsNotified);
+    dst->buffsQueuedLastTick = NIX_ATOMIC_LOAD32(&obj->buffsQueuedLastTick);
+    dst->buffsNotifiedLastTick = NIX_ATOMIC_LOAD32(&obj->buffsNotifiedLastTick);
+    dst->convBytes      = NIX_ATOMIC_LOAD64(&obj->convBytes);
+    dst->convUs         = NIX_ATOMIC_LOAD64(&obj->convNs) / 1000ull;
+    dst->callbacks      = NIX_ATOMIC_LOAD64(&obj->callbacks);
+    dst->callbacksUs    = NIX_ATOMIC_LOAD64(&obj->callbacksNs) / 1000ull;
+    dst->callbackUsMax  = NIX_ATOMIC_LOAD32(&obj->callbackUsMax);
+    dst->underruns      = NIX_ATOMIC_LOAD64(&obj->underruns);
+    dst->recOverruns    = NIX_ATOMIC_LOAD64(&obj->recOverruns);
+}
+
+//------
+//Trace
+//------
+
+#ifdef NIX_TRACE
+
+#if defined(_MSC_VER)
+#   define NIX_TRACE_TLS    __declspec(thread)
+#else
+#   define NIX_TRACE_TLS    __thread
+#endif
+
+typedef struct STNixTraceEvent_ {
+    const char*         name;       //literal
+    NixUI64             startNs;
+    NixUI64             durNs;
+    NixUI64             id;
+} STNixTraceEvent;
+
+//Per-thread ring (single writer), never freed so the spans of ended threads can be dumped.
+typedef struct STNixTraceThread_ {
+    struct STNixTraceThread_* next;
+    NixUI32             tid;        //sequential
+    volatile NixUI32    iWrite;     //events written (wraps)
+    STNixTraceEvent     events[NIX_TRACE_EVENTS_PER_THREAD];
+} STNixTraceThread;
+
+static STNixTraceThread* volatile NixTrace_threads_ = NULL;  //lock-free list (push only)
+static volatile NixUI32 NixTrace_threadsSeq_ = 0;
+static NIX_TRACE_TLS STNixTraceThread* NixTrace_cur_ = NULL;
+
+STNixTraceThread* NixTrace_threadRegister_(void){
+    STNixTraceThread* t = (STNixTraceThread*)malloc(sizeof(STNixTraceThread));
+    if(t != NULL){
+        STNixTraceThread* first;
+        memset(t, 0, sizeof(*t));
+        t->tid = NIX_ATOMIC_ADD32(&NixTrace_threadsSeq_, 1);
+        do {
+            first = (STNixTraceThread*)NIX_ATOMIC_LOADPTR(&NixTrace_threads_);
+            t->next = first;
+        } while(!NIX_ATOMIC_CASPTR(&NixTrace_threads_, first, t));
+        NixTrace_cur_ = t;
+    }
+    return t;
+}
+
+void NixTrace_add(const char* name, const NixUI64 startNs, const NixUI64 id){
+    STNixTraceThread* t = NixTrace_cur_;
+    if(t == NULL){
+        t = NixTrace_threadRegister_();
+    }
+    if(t != NULL){
+        const NixUI32 iWrite = t->iWrite;
+        STNixTraceEvent* e = &t->events[iWrite & (NIX_TRACE_EVENTS_PER_THREAD - 1)];
+        e->name     = name;
+        e->startNs  = startNs;
+        e->durNs    = NixClock_getMonotonicNs() - startNs;
+        e->id       = id;
+        NIX_ATOMIC_STORE32(&t->iWrite, iWrite + 1); //publish
+    }
+}
+
+#endif
+
+NixBOOL NixTrace_isEnabled(void){
+#   ifdef NIX_TRACE
+    return NIX_TRUE;
+#   else
+    return NIX_FALSE;
+#   endif
+}
+
+NixBOOL NixTrace_dumpChromeJson(const char* filepath){
+    NixBOOL r = NIX_FALSE;
+#   ifdef NIX_TRACE
+    FILE* f = (filepath != NULL ? fopen(filepath, "wb") : NULL);
+    if(f == NULL){
+        NIX_PRINTF_ERROR("NixTrace_dumpChromeJson, could not open file.\n");
+    } else {
+        NixBOOL isFirst = NIX_TRUE;
+        const STNixTraceThread* t = (const STNixTraceThread*)NIX_ATOMIC_LOADPTR(&NixTrace_threads_);
+        fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        while(t != NULL){
+            //the oldest slot could be overwritten while dumping, skipped
+            const NixUI32 iWrite = NIX_ATOMIC_LOAD32(&t->iWrite);
+            NixUI32 i = (iWrite > (NIX_TRACE_EVENTS_PER_THREAD - 1) ? iWrite - (NIX_TRACE_EVENTS_PER_THREAD - 1) : 0);
+            fprintf(f, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"nix-%u\"}}", (isFirst ? "" : ",\n"), t->tid, t->tid);
+            isFirst = NIX_FALSE;
+            for(; i != iWrite; ++i){
+                const STNixTraceEvent* e = &t->events[i & (NIX_TRACE_EVENTS_PER_THREAD - 1)];
+                fprintf(f, ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"args\":{\"id\":\"0x%llx\"}}", e->name, t->tid, (unsigned long long)(e->startNs / 1000ull), (unsigned)(e->startNs % 1000ull), (unsigned long long)(e->durNs / 1000ull), (unsigned)(e->durNs % 1000ull), (unsigned long long)e->id);
+            }
+            t = t->next;
+        }
+        fprintf(f, "\n]}\n");
+        fclose(f);
+        r = NIX_TRUE;
+    }
+#   endif
+    return r;
+}
+
+//------
+//RtCheck
+//------
+
+#ifdef NIX_RT_CHECK
+
+#if defined(_MSC_VER)
+#   define NIX_RT_CHECK_TLS __declspec(thread)
+#else
+#   define NIX_RT_CHECK_TLS __thread
+#endif
+
+static NIX_RT_CHECK_TLS NixUI32 NixRtCheck_depth_ = 0;        //real-time sections of this thread
+static NIX_RT_CHECK_TLS NixUI32 NixRtCheck_isReporting_ = 0;  //avoids reporting the handler's own calls
+static volatile NixUI32 NixRtCheck_violations_ = 0;
+static NixRtViolationFnc NixRtCheck_handler_ = NULL;
+static void* NixRtCheck_handlerData_ = NULL;
+
+static const char* NixRtCheck_typeNames_[] = { "malloc", "realloc", "free", "blocking lock" };
+
+void NixRtCheck_violation(const ENNixRtViolation type, const char* dbgHintStr){
+    if(NixRtCheck_isReporting_ == 0){
+        NixRtViolationFnc fnc = NixRtCheck_handler_;
+        NixRtCheck_isReporting_ = 1;
+        NIX_ATOMIC_ADD32(&NixRtCheck_violations_, 1);
+        if(fnc != NULL){
+            (*fnc)(type, dbgHintStr, NixRtCheck_handlerData_);
+        } else {
+            //lock-free log, flushed at the next tick
+            NixLog_post(ENNixLogLevel_Error, "RT-CHECK, %s on a real-time thread: '%s'.\n", (type >= 0 && type < ENNixRtViolation_Count ? NixRtCheck_typeNames_[type] : "unknown"), (dbgHintStr != NULL ? dbgHintStr : ""));
+        }
+        NixRtCheck_isReporting_ = 0;
+    }
+}
+
+#endif
+
+NixBOOL NixRtCheck_isEnabled(void){
+#   ifdef NIX_RT_CHECK
+    return NIX_TRUE;
+#   else
+    return NIX_FALSE;
+#   endif
+}
+
+void NixRtCheck_enter(void){
+#   ifdef NIX_RT_CHECK
+    NixRtCheck_depth_++;
+#   endif
+}
+
+void NixRtCheck_exit(void){
+#   ifdef NIX_RT_CHECK
+    NIX_ASSERT(NixRtCheck_depth_ > 0)
+    if(NixRtCheck_depth_ > 0){
+        NixRtCheck_depth_--;
+    }
+#   endif
+}
+
+NixBOOL NixRtCheck_isRealtime(void){
+#   ifdef NIX_RT_CHECK
+    return (NixRtCheck_depth_ > 0 ? NIX_TRUE : NIX_FALSE);
+#   else
+    return NIX_FALSE;
+#   endif
+}
+
+void NixRtCheck_setHandler(NixRtViolationFnc fnc, void* userdata){
+#   ifdef NIX_RT_CHECK
+    NixRtCheck_handler_ = NULL;
+    NixRtCheck_handlerData_ = userdata;
+    NixRtCheck_handler_ = fnc;
+#   endif
+}
+
+NixUI32 NixRtCheck_getViolationsCount(void){
+#   ifdef NIX_RT_CHECK
+    return NIX_ATOMIC_LOAD32(&NixRtCheck_violations_);
+#   else
+    return 0;
+#   endif
+}
+
+//------
+//RtThread
+//------
+
+#if defined(_WIN32)
+#   include <windows.h>                 //for SetThreadPriority
+#else
+#   include <pthread.h>                 //for pthread_setschedparam
+#   include <sched.h>                   //for sched_get_priority_max
+#endif
+#if defined(__linux__) || defined(__ANDROID__)
+#   include <unistd.h>                  //for syscall
+#   include <sys/syscall.h>             //for SYS_sched_setaffinity
+#endif
+#if (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))) || defined(__SSE__)
+#   include <xmmintrin.h>               //for _mm_setcsr
+#   define NIX_RT_FTZ_SSE
+#endif
+
+NixBOOL NixRtThread_apply(const STNixRtThreadOpts* opts){
+    NixBOOL r = NIX_TRUE;
+    if(opts == NULL){
+        return NIX_FALSE;
+    }
+    //scheduling
+    if(opts->sched != ENNixRtSched_Default){
+#       if defined(_WIN32)
+        if(!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)){
+            NIX_PRINTF_WARNING("NixRtThread_apply, SetThreadPriority failed.\n");
+            r = NIX_FALSE;
+        }
+#       else
+        {
+            const int policy = (opts->sched == ENNixRtSched_RoundRobin ? SCHED_RR : SCHED_FIFO);
+            const int prioMin = sched_get_priority_min(policy), prioMax = sched_get_priority_max(policy);
+            struct sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = (opts->priority < prioMin ? prioMin : opts->priority > prioMax ? prioMax : opts->priority);
+            if(0 != pthread_setschedparam(pthread_self(), policy, &param)){
+                NIX_PRINTF_WARNING("NixRtThread_apply, pthread_setschedparam failed (privileges?).\n");
+                r = NIX_FALSE;
+            }
+        }
+#       endif
+    }
+    //affinity
+    if(opts->cpuMask != 0){
+#       if defined(_WIN32)
+        if(0 == SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)opts->cpuMask)){
+            NIX_PRINTF_WARNING("NixRtThread_apply, SetThreadAffinityMask failed.\n");
+            r = NIX_FALSE;
+        }
+#       elif defined(__linux__) || defined(__ANDROID__)
+        {
+            unsigned long mask[64 / (sizeof(unsigned long) * 8) > 0 ? 64 / (sizeof(unsigned long) * 8) : 1];
+            memcpy(mask, &opts->cpuMask, sizeof(mask) < sizeof(opts->cpuMask) ? sizeof(mask) : sizeof(opts->cpuMask));
+            if(0 != syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask)){ //current thread
+                NIX_PRINTF_WARNING("NixRtThread_apply, sched_setaffinity failed.\n");
+                r = NIX_FALSE;
+            }
+        }
+#       else
+        r = NIX_FALSE; //not supported
+#       endif
+    }
+    //denormals
+    if(opts->flushDenormals){
+#       if defined(NIX_RT_FTZ_SSE)
+        _mm_setcsr(_mm_getcsr() | 0x8040); //FTZ (bit 15) and DAZ (bit 6)
+#       elif defined(__aarch64__)
+        {
+            NixUI64 fpcr;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+            fpcr |= (1ull << 24); //FZ
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+        }
+#       elif defined(__arm__) && defined(__ARM_FP)
+        {
+            NixUI32 fpscr;
+            __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+            fpscr |= (1u << 24); //FZ
+            __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+        }
+#       else
+        r = NIX_FALSE; //not supported
+#       endif
+    }
+    return r;
+}
+
+void NixRtThreadState_init(STNixRtThreadState* obj){
+    memset(obj, 0, sizeof(*obj));
+}
+
+void NixRtThreadState_set(STNixRtThreadState* obj, const STNixRtThreadOpts* opts){
+    STNixRtThreadOpts v;
+    NixUI32 seq;
+    if(opts != NULL){
+        v = *opts;
+    } else {
+        memset(&v, 0, sizeof(v));
+    }
+    //lock (odd 'seq', also serializes concurrent writers)
+    do {
+        seq = NIX_ATOMIC_LOAD32(&obj->seq);
+    } while((seq & 1) != 0 || !NIX_ATOMIC_CAS32(&obj->seq, seq, seq + 1));
+    NIX_ATOMIC_STORE32(&obj->opts.sched, (NixUI32)v.sched);
+    NIX_ATOMIC_STORE32(&obj->opts.priority, (NixUI32)v.priority);
+    NIX_ATOMIC_STORE32(&obj->opts.cpuMaskLo, (NixUI32)(v.cpuMask & 0xFFFFFFFFu));
+    NIX_ATOMIC_STORE32(&obj->opts.cpuMaskHi, (NixUI32)(v.cpuMask >> 32));
+    NIX_ATOMIC_STORE32(&obj->opts.flushDenormals, (NixUI32)v.flushDenormals);
+    NIX_ATOMIC_ADD32(&obj->seq, 1); //publish (even 'seq')
+}
+
+void NixRtThreadState_applyIfChanged(STNixRtThreadState* obj, NixUI32* seqApplied){
+    const NixUI32 seq = NIX_ATOMIC_LOAD32(&obj->seq);
+    if(seq != *seqApplied && (seq & 1) == 0){
+        STNixRtThreadOpts v;
+        v.sched             = (ENNixRtSched)NIX_ATOMIC_LOAD32(&obj->opts.sched);
+        v.priority          = (NixSI32)NIX_ATOMIC_LOAD32(&obj->opts.priority);
+        v.cpuMask           = ((NixUI64)NIX_ATOMIC_LOAD32(&obj->opts.cpuMaskHi) << 32) | (NixUI64)NIX_ATOMIC_LOAD32(&obj->opts.cpuMaskLo);
+        v.flushDenormals    = (NixBOOL)NIX_ATOMIC_LOAD32(&obj->opts.flushDenormals);
+        //consistent only if no 'set' started meanwhile (the loads above are acquire, not reordered after this one)
+        if(NIX_ATOMIC_LOAD32(&obj->seq) == seq){
+            *seqApplied = seq;
+            NixRtThread_apply(&v);
+        }
+    }
+}
+
+//------
+//PosInterp
+//------
+
+void NixPosInterp_reset(STNixPosInterp* obj){
+    memset(obj, 0, sizeof(*obj));
+}
+
+NixUI64 NixPosInterp_get(STNixPosInterp* obj, const NixUI64 reported, const NixUI32 rate, const NixUI64 maxAhead, const NixUI64 usNow){
+    NixUI64 r = reported;
+    if(reported < obj->reported){
+        //restarted (stopped, flushed or looped)
+        obj->last = reported;
+    }
+    if(reported != obj->reported){
+        //new report
+        obj->reported   = reported;
+        obj->reportedUs = usNow;
+    } else if(maxAhead > 0 && rate > 0 && usNow > obj->reportedUs){
+        //extrapolate
+        const NixUI64 ahead = (usNow - obj->reportedUs) * rate / 1000000ull;
+        r = reported + (ahead < maxAhead ? ahead : maxAhead);
+    }
+    if(r < obj->last){
+        r = obj->last;
+    }
+    obj->last = r;
+    return r;
+}
+
+//STNixContextRef
+
+typedef struct STNixContextOpq_ {
+    NixUI32 dummy;  //empty struct
+} STNixContextOpq;
+
+STNixContextRef NixContext_alloc(STNixContextItf* ctx){
+    STNixContextRef r = STNixContextRef_Zero;
+    if(ctx != NULL){
+        STNixContextOpq* opq = (STNixContextOpq*)(ctx->mem.malloc)(sizeof(STNixContextOpq), "NixContext_alloc::opq");
+        STNixContextItf* itf = (STNixContextItf*)(ctx->mem.malloc)(sizeof(STNixContextItf), "NixContext_alloc::itf");
+        STNixSharedPtr* ptr  = NixSharedPtr_alloc(ctx, opq, "NixContext_alloc");
+        if(opq != NULL && itf != NULL && ptr != NULL){
+            memset(opq, 0, sizeof(*opq));
+            memcpy(itf, ctx, sizeof(*itf));
+            r.ptr = ptr; ptr = NULL; //consume
+            r.itf = itf; itf = NULL; //consume
+            opq = NULL; //consume
+        }
+        //release (if not consumed)
+        if(opq != NULL){
+            (ctx->mem.free)(opq);
+            opq = NULL;
+        }
+        if(itf != NULL){
+            (ctx->mem.free)(itf);
+            itf = NULL;
+        }
+        if(ptr != NULL){
+            NixSharedPtr_free(ptr);
+            ptr = NULL;
+        }
+    }
+    return r;
+}
+
+void NixContext_retain(STNixContextRef ref){
+    NixSharedPtr_retain(ref.ptr);
+}
+
+void NixContext_release(STNixContextRef* ref){
+    if(ref != NULL && 0 == NixSharedPtr_release(ref->ptr)){
+        STNixContextOpq* opq = (STNixContextOpq*)NixSharedPtr_getOpq(ref->ptr);
+        STNixContextRef cpy = *ref;
+        *ref = (STNixContextRef)STNixContextRef_Zero;
+        //free
+        if(opq != NULL){
+            (cpy.itf->mem.free)(opq);
+            opq = NULL;
+        }
+        if(cpy.itf != NULL){
+            (cpy.itf->mem.free)(cpy.itf);
+            cpy.itf = NULL;
+        }
+        if(cpy.ptr != NULL){
+            NixSharedPtr_free(cpy.ptr);
+            cpy.ptr = NULL;
+        }
+    }
+}
+
+void NixContext_set(STNixContextRef* ref, STNixContextRef other){
+    //retain first
+    if(other.ptr != NULL){
+        NixContext_retain(other);
+    }
+    //release after
+    if(ref->ptr != NULL){
+        NixContext_release(ref);
+    }
+    //set
+    *ref = other;
+}
+
+void NixContext_null(STNixContextRef* ref){
+    *ref = (STNixContextRef)STNixContextRef_Zero;
+}
+
+//context (memory)
+
+void* NixContext_malloc(STNixContextRef ref, const NixUI32 newSz, const char* dbgHintStr){
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Malloc, dbgHintStr);
+    return (ref.itf != NULL && ref.itf->mem.malloc != NULL ? (*ref.itf->mem.malloc)(newSz, dbgHintStr) : NULL);
+}
+
+void* NixContext_mrealloc(STNixContextRef ref, void* ptr, const NixUI32 newSz, const char* dbgHintStr){
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Realloc, dbgHintStr);
+    return (ref.itf != NULL && ref.itf->mem.realloc != NULL ? (*ref.itf->mem.realloc)(ptr, newSz, dbgHintStr) : NULL);
+}
+
+void NixContext_mfree(STNixContextRef ref, void* ptr){
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Free, "NixContext_mfree");
+    if(ref.itf != NULL && ref.itf->mem.free != NULL){
+        (*ref.itf->mem.free)(ptr);
+    }
+}
+
+#ifdef NIX_RT_CHECK
+void NixContext_mfreeAt_(STNixContextRef ref, void* ptr, const char* dbgHintStr){
+    NIX_RT_CHECK_CALL(ENNixRtViolation_Free, dbgHintStr);
+    if(ref.itf != NULL && ref.itf->mem.free != NULL){
+        (*ref.itf->mem.free)(ptr);
+    }
+}
+#endif
+
+//context (mutex)
+
+STNixMutexRef NixContext_mutex_alloc(STNixContextRef ref){
+    return (ref.itf != NULL && ref.itf->mutex.alloc != NULL ? (*ref.itf->mutex.alloc)(ref.itf) : (STNixMutexRef)STNixMutexRef_Zero);
 }
 
 
@@ -610,6 +1621,31 @@ void            NixEngineItf_nop_tick(STNixEngineRef ref) { }
 STNixSourceRef  NixEngineItf_nop_allocSource(STNixEngineRef ref) { return (STNixSourceRef)STNixSourceRef_Zero; }
 STNixBufferRef  NixEngineItf_nop_allocBuffer(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes) { return (STNixBufferRef)STNixBufferRef_Zero; }
 STNixRecorderRef NixEngineItf_nop_allocRecorder(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer) { return (STNixRecorderRef)STNixRecorderRef_Zero; }
+//One-shots
+NixBOOL         NixEngineItf_nop_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority) { return NIX_FALSE; }
+NixBOOL         NixEngineItf_nop_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal) { return NIX_FALSE; }
+//Voices
+NixBOOL         NixEngineItf_nop_setVoicesLimit(STNixEngineRef ref, const NixUI32 maxReal) { return NIX_FALSE; }
+
+NixUI64         NixEngineItf_nop_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec) { if(optDstFramesPerSec != NULL) *optDstFramesPerSec = 0; return 0; }
+NixBOOL         NixEngineItf_nop_getStats(STNixEngineRef ref, STNixEngineStats* dst) { if(dst != NULL) memset(dst, 0, sizeof(*dst)); return NIX_FALSE; }
+NixBOOL         NixEngineItf_nop_setRtThreadOpts(STNixEngineRef ref, const STNixRtThreadOpts* opts) { return NIX_FALSE; }
+
+void NixEngineItf_default_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz){
+    if(srcs != NULL){
+        NixUI32 i; for(i = 0; i < srcsSz; i++){
+            NixSource_play(srcs[i]);
+        }
+    }
+}
+
+void NixEngineItf_default_stopSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz){
+    if(srcs != NULL){
+        NixUI32 i; for(i = 0; i < srcsSz; i++){
+            NixSource_stop(srcs[i]);
+        }
+    }
+}
 
 //Links NULL methods to a NOP implementation,
 //this reduces the need to check for functions NULL pointers.
@@ -627,6 +1663,19 @@ void NixEngineItf_fillMissingMembers(STNixEngineItf* itf){
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, allocSource);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, allocBuffer);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, allocRecorder);
+    //One-shots
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, playOneShot);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, setOneShotsLimit);
+    //Voices
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, setVoicesLimit);
+    //Batch
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixEngineItf, playSources); //one by one
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixEngineItf, stopSources); //one by one
+    //Clock
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, getFrameTime);
+    //Stats
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, getStats);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixEngineItf, setRtThreadOpts);
     //validate missing implementations
 #   ifdef NIX_ASSERTS_ACTIVATED
     {
@@ -646,6 +1695,8 @@ STNixBufferRef  NixBufferItf_nop_alloc(STNixContextRef ctx, const STNixAudioDesc
 void            NixBufferItf_nop_free(STNixBufferRef ref) { }
 NixBOOL         NixBufferItf_nop_setData(STNixBufferRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes) { return NIX_FALSE; }
 NixBOOL         NixBufferItf_nop_fillWithZeroes(STNixBufferRef ref) { return NIX_FALSE; }
+NixUI8*         NixBufferItf_nop_getData(STNixBufferRef ref, NixUI32* optDstUse, NixUI32* optDstSz) { if(optDstUse != NULL) *optDstUse = 0; if(optDstSz != NULL) *optDstSz = 0; return NULL; }
+NixBOOL         NixBufferItf_nop_setDataUse(STNixBufferRef ref, const NixUI32 bytes) { return NIX_FALSE; }
 
 //Links NULL methods to a NOP implementation,
 //this reduces the need to check for functions NULL pointers.
@@ -655,6 +1706,8 @@ void NixBufferItf_fillMissingMembers(STNixBufferItf* itf){
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixBufferItf, free);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixBufferItf, setData);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixBufferItf, fillWithZeroes);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixBufferItf, getData);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixBufferItf, setDataUse);
     //validate missing implementations
 #   ifdef NIX_ASSERTS_ACTIVATED
     {
@@ -687,6 +1740,60 @@ NixBOOL         NixSourceItf_nop_queueBuffer(STNixSourceRef ref, STNixBufferRef
 NixBOOL         NixSourceItf_nop_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset){ return NIX_FALSE; } //relative to first buffer in queue
 NixUI32         NixSourceItf_nop_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount) { if(optDstBytesCount != NULL) *optDstBytesCount = 0; if(optDstBlocksCount != NULL) *optDstBlocksCount = 0; if(optDstMsecsCount != NULL) *optDstMsecsCount = 0; return 0; }
 NixUI32         NixSourceItf_nop_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount) { if(optDstBytesCount != NULL) *optDstBytesCount = 0; if(optDstBlocksCount != NULL) *optDstBlocksCount = 0; if(optDstMsecsCount != NULL) *optDstMsecsCount = 0; return 0; }
+NixBOOL         NixSourceItf_nop_setPriority(STNixSourceRef ref, const NixUI8 priority) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_isVirtual(STNixSourceRef ref) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_playAt(STNixSourceRef ref, const NixUI64 engFrame) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_stopAt(STNixSourceRef ref, const NixUI64 engFrame) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_getStartError(STNixSourceRef ref, NixSI64* dstFrames) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_getCounters(STNixSourceRef ref, STNixSourceCounters* dst) { if(dst != NULL) memset(dst, 0, sizeof(*dst)); return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData) { return NIX_FALSE; }
+NixBOOL         NixSourceItf_nop_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData) { return NIX_FALSE; }
+
+NixBOOL NixSourceItf_default_getClock(STNixSourceRef ref, STNixSourceClock* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixSourceCounters cnts;
+    if(dst != NULL && ref.itf != NULL && ref.itf->getCounters != NULL && (*ref.itf->getCounters)(ref, &cnts)){
+        //not interpolated
+        dst->framesPlayed   = cnts.framesPlayed;
+        dst->latencyUs      = 0;
+        dst->timeUs         = cnts.timeUs;
+        r = NIX_TRUE;
+    } else if(dst != NULL){
+        memset(dst, 0, sizeof(*dst));
+    }
+    return r;
+}
+
+NixBOOL NixSourceItf_default_queueBufferAt(STNixSourceRef ref, STNixBufferRef buff, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.itf != NULL && ref.itf->queueBuffer != NULL && (*ref.itf->queueBuffer)(ref, buff)){
+        r = NIX_TRUE;
+        if(ref.itf->isPlaying == NULL || !(*ref.itf->isPlaying)(ref)){
+            r = (ref.itf->playAt != NULL && (*ref.itf->playAt)(ref, engFrame));
+        }
+    }
+    return r;
+}
+
+NixBOOL NixSourceItf_default_queueBufferMove(STNixSourceRef ref, STNixBufferRef* buff){
+    NixBOOL r = NIX_FALSE;
+    if(buff != NULL && ref.itf != NULL && ref.itf->queueBuffer != NULL && (*ref.itf->queueBuffer)(ref, *buff)){
+        NixBuffer_release(buff);
+        NixBuffer_null(buff);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixUI32 NixSourceItf_default_queueBuffers(STNixSourceRef ref, const STNixBufferRef* buffs, const NixUI32 buffsSz){
+    NixUI32 r = 0;
+    if(buffs != NULL && ref.itf != NULL && ref.itf->queueBuffer != NULL){
+        while(r < buffsSz && (*ref.itf->queueBuffer)(ref, buffs[r])){
+            r++;
+        }
+    }
+    return r;
+}
 
 
 //Links NULL methods to a NOP implementation,
@@ -707,9 +1814,25 @@ void NixSourceItf_fillMissingMembers(STNixSourceItf* itf){
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, getVolume);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, setBuffer);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, queueBuffer);
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixSourceItf, queueBufferMove); //queueBuffer + release
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixSourceItf, queueBuffers); //queueBuffer one by one
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, setBufferOffset);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, getBuffersCount);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, getBlocksOffset);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, setPriority);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, isVirtual);
+    //Scheduling
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, playAt);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, stopAt);
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixSourceItf, queueBufferAt); //queueBuffer + playAt
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, getStartError);
+    //Counters
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, getCounters);
+    NIX_ITF_SET_MISSING_METHOD_TO_DEFAULT(itf, NixSourceItf, getClock); //getCounters, not interpolated
+    //Low watermark
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, setLowWatermark);
+    //Render
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixSourceItf, setRenderCallback);
     //validate missing implementations
 #   ifdef NIX_ASSERTS_ACTIVATED
     {
@@ -733,6 +1856,7 @@ NixBOOL         NixRecorderItf_nop_stop(STNixRecorderRef ref) { return NIX_FALSE
 NixBOOL         NixRecorderItf_nop_flush(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying) { return NIX_FALSE; }
 NixBOOL         NixRecorderItf_nop_isCapturing(STNixRecorderRef ref) { return NIX_FALSE; }
 NixUI32         NixRecorderItf_nop_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount) { if(optDstBytesCount != NULL) *optDstBytesCount = 0; if(optDstBlocksCount != NULL) *optDstBlocksCount = 0; if(optDstMsecsCount != NULL) *optDstMsecsCount = 0; return 0; }
+NixBOOL         NixRecorderItf_nop_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst) { if(dst != NULL) memset(dst, 0, sizeof(*dst)); return NIX_FALSE; }
 
 //Links NULL methods to a NOP implementation,
 //this reduces the need to check for functions NULL pointers.
@@ -746,6 +1870,7 @@ void NixRecorderItf_fillMissingMembers(STNixRecorderItf* itf){
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixRecorderItf, flush);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixRecorderItf, isCapturing);
     NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixRecorderItf, getBuffersFilledCount);
+    NIX_ITF_SET_MISSING_METHOD_TO_NOP(itf, NixRecorderItf, getCounters);
     //validate missing implementations
 #   ifdef NIX_ASSERTS_ACTIVATED
     {
@@ -793,7 +1918,7 @@ void NixPCMBuffer_init(STNixContextRef ctx, STNixPCMBuffer* obj){
 
 void NixPCMBuffer_destroy(STNixPCMBuffer* obj){
     if(obj->ptr != NULL){
-        NixContext_mfree(obj->ctx, obj->ptr);
+        NIX_RT_MFREE(obj->ctx, obj->ptr);
         obj->ptr = NULL;
     }
     obj->use = obj->sz = 0;
@@ -808,7 +1933,7 @@ NixBOOL NixPCMBuffer_setData(STNixPCMBuffer* obj, const STNixAudioDesc* audioDes
         //destroy current buffer (if necesary)
         if(!STNixAudioDesc_isEqual(&obj->desc, audioDesc) || obj->sz < reqBytes){
             if(obj->ptr != NULL){
-                NixContext_mfree(obj->ctx, obj->ptr);
+                NIX_RT_MFREE(obj->ctx, obj->ptr);
                 obj->ptr = NULL;
             }
             obj->use = obj->sz = 0;
@@ -827,142 +1952,523 @@ NixBOOL NixPCMBuffer_setData(STNixPCMBuffer* obj, const STNixAudioDesc* audioDes
                     obj->sz = reqBytes;
                 }
             }
-            //results
-            if(obj->ptr != NULL){
-                //copy data
-                if(audioDataPCM != NULL){
-                    memcpy(obj->ptr, audioDataPCM, reqBytes);
-                }
-                obj->use = reqBytes;
-                r = NIX_TRUE;
+            //results
+            if(obj->ptr != NULL){
+                //copy data
+                if(audioDataPCM != NULL){
+                    memcpy(obj->ptr, audioDataPCM, reqBytes);
+                }
+                obj->use = reqBytes;
+                r = NIX_TRUE;
+            }
+        }
+    }
+    return r;
+}
+
+NixBOOL NixPCMBuffer_fillWithZeroes(STNixPCMBuffer* obj){
+    NixBOOL r = NIX_FALSE;
+    if(obj->ptr != NULL){
+        if(obj->use < obj->sz){
+            memset(&((NixBYTE*)obj->ptr)[obj->use], 0, obj->sz - obj->use);
+            obj->use = obj->sz;
+        }
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL NixPCMBuffer_setDataUse(STNixPCMBuffer* obj, const NixUI32 bytes){
+    NixBOOL r = NIX_FALSE;
+    if(obj->desc.blockAlign > 0 && bytes <= obj->sz){
+        obj->use = (bytes / obj->desc.blockAlign * obj->desc.blockAlign);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//------
+//Notif
+//------
+
+void NixSourceNotif_init(STNixSourceNotif* obj, STNixSourceRef src, const STNixSourceCallback callback){
+    memset(obj, 0, sizeof(*obj));
+    if(!NixSource_isNull(src)){
+        NixSource_set(&obj->source, src);
+    }
+    obj->callback = callback;
+}
+
+void NixSourceNotif_destroy(STNixSourceNotif* obj){
+    {
+        NixSI32 i; for(i= 0; i < obj->buffsUse; i++){
+            STNixBufferRef* buff = &obj->buffs[i];
+            if(!NixBuffer_isNull(*buff)){
+                NixBuffer_release(buff);
+                NixBuffer_null(buff);
+            }
+        }
+        obj->buffsUse = 0;
+    }
+    if(!NixSource_isNull(obj->source)){
+        NixSource_release(&obj->source);
+        NixSource_null(&obj->source);
+    }
+}
+
+NixBOOL NixSourceNotif_addBuff(STNixSourceNotif* obj, STNixBufferRef buff){
+    NixBOOL r = NIX_FALSE;
+    if(!NixBuffer_isNull(buff) && obj->buffsUse < sizeof(obj->buffs) / sizeof(obj->buffs[0])){
+        obj->buffs[obj->buffsUse++] = buff;
+        NixBuffer_retain(buff);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL NixSourceNotif_addBuffMove(STNixSourceNotif* obj, STNixBufferRef* buff){
+    NixBOOL r = NIX_FALSE;
+    if(!NixBuffer_isNull(*buff) && obj->buffsUse < sizeof(obj->buffs) / sizeof(obj->buffs[0])){
+        obj->buffs[obj->buffsUse++] = NixBuffer_move(buff);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//------
+//NotifQueue
+//------
+
+void NixNotifQueue_init(STNixContextRef ctx, STNixNotifQueue* obj){
+    memset(obj, 0, sizeof(*obj));
+    NixContext_set(&obj->ctx, ctx);
+    obj->arr = obj->arrEmbedded;
+    obj->sz = (sizeof(obj->arrEmbedded) / sizeof(obj->arrEmbedded[0]));
+}
+
+void NixNotifQueue_destroy(STNixNotifQueue* obj){
+    if(obj->arr != NULL){
+        NixUI32 i; for(i = 0; i < obj->use; i++){
+            STNixSourceNotif* b = &obj->arr[i];
+            NixSourceNotif_destroy(b);
+        }
+        if(obj->arr != obj->arrEmbedded){
+            NIX_RT_MFREE(obj->ctx, obj->arr);
+        }
+        obj->arr = NULL;
+    }
+    obj->use = obj->sz = 0;
+    NixContext_release(&obj->ctx);
+    NixContext_null(&obj->ctx);
+}
+
+NixBOOL NixNotifQueue_addBuff(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceCallback callback, STNixBufferRef buff){
+    NixBOOL r = NIX_FALSE;
+    if(!NixBuffer_isNull(buff)){
+        STNixBufferRef b = buff;
+        NixBuffer_retain(b);
+        if(!(r = NixNotifQueue_addBuffMove(obj, src, callback, &b))){
+            NixBuffer_release(&b);
+        }
+    }
+    return r;
+}
+
+NixBOOL NixNotifQueue_addBuffMove(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceCallback callback, STNixBufferRef* buff){
+    NixBOOL r = NIX_FALSE;
+    if(obj != NULL){
+        STNixSourceNotif* lst = (obj->use != 0 ? &obj->arr[obj->use - 1] : NULL);
+        if(lst != NULL && lst->needs.func == NULL && NixSource_isSame(src, lst->source)){
+            //accumulate buffer in last record
+            r = NixSourceNotif_addBuffMove(lst, buff);
+        }
+        if(!r){
+            //resize array (if necesary)
+            if(obj->use >= obj->sz){
+                const NixUI32 szN = obj->use + 4;
+                STNixSourceNotif* arrN = (STNixSourceNotif*)NixContext_mrealloc(obj->ctx, obj->arr, sizeof(STNixSourceNotif) * szN, "NixNotifQueue_addBuff::arrN");
+                if(arrN != NULL){
+                    obj->arr = arrN;
+                    obj->sz = szN;
+                }
+            }
+            //add
+            if(obj->use >= obj->sz){
+                NIX_PRINTF_ERROR("NixNotifQueue_addBuff failed (no allocated space).\n");
+            } else {
+                //become the owner of the pair
+                STNixSourceNotif n;
+                NixSourceNotif_init(&n, src, callback);
+                if(!NixSourceNotif_addBuffMove(&n, buff)){
+                    NixSourceNotif_destroy(&n);
+                    NIX_ASSERT(NIX_FALSE) //program logic error
+                } else {
+                    obj->arr[obj->use++] = n;
+                    r = NIX_TRUE;
+                }
+            }
+        }
+    }
+    return r;
+}
+
+NixBOOL NixNotifQueue_addNeedsData(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceWatermark* wmark, const NixUI32 queued, const NixUI32 deficit){
+    NixBOOL r = NIX_FALSE;
+    if(obj != NULL && wmark != NULL && wmark->func != NULL){
+        //resize array (if necesary)
+        if(obj->use >= obj->sz){
+            const NixUI32 szN = obj->use + 4;
+            STNixSourceNotif* arrN = (STNixSourceNotif*)NixContext_mrealloc(obj->ctx, obj->arr, sizeof(STNixSourceNotif) * szN, "NixNotifQueue_addNeedsData::arrN");
+            if(arrN != NULL){
+                obj->arr = arrN;
+                obj->sz = szN;
             }
         }
+        //add
+        if(obj->use >= obj->sz){
+            NIX_PRINTF_ERROR("NixNotifQueue_addNeedsData failed (no allocated space).\n");
+        } else {
+            const STNixSourceCallback noCallback = { NULL, NULL };
+            STNixSourceNotif n;
+            NixSourceNotif_init(&n, src, noCallback);
+            n.needs.func    = wmark->func;
+            n.needs.data    = wmark->data;
+            n.needs.queued  = queued;
+            n.needs.deficit = deficit;
+            obj->arr[obj->use++] = n;
+            r = NIX_TRUE;
+        }
     }
     return r;
 }
 
-NixBOOL NixPCMBuffer_fillWithZeroes(STNixPCMBuffer* obj){
+//------
+//SourceWatermark
+//------
+
+void NixSourceWatermark_set(STNixSourceWatermark* obj, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData){
+    obj->type       = type;
+    obj->amount     = amount;
+    obj->func       = callback;
+    obj->data       = callbackData;
+    obj->isArmed    = NIX_TRUE;
+}
+
+NixBOOL NixSourceWatermark_check(STNixSourceWatermark* obj, const STNixAudioDesc* buffsFmt, const NixUI32 queuedBlocks, NixUI32* dstDeficitBlocks){
     NixBOOL r = NIX_FALSE;
-    if(obj->ptr != NULL){
-        if(obj->use < obj->sz){
-            memset(&((NixBYTE*)obj->ptr)[obj->use], 0, obj->sz - obj->use);
-            obj->use = obj->sz;
+    if(obj->isArmed && NixSourceWatermark_isEnabled(obj) && buffsFmt != NULL && buffsFmt->blockAlign > 0){
+        NixUI32 blocks = 0;
+        switch(obj->type){
+            case ENNixOffsetType_Msecs: blocks = (NixUI32)((NixUI64)obj->amount * buffsFmt->samplerate / 1000ull); break;
+            case ENNixOffsetType_Bytes: blocks = obj->amount / buffsFmt->blockAlign; break;
+            default: blocks = obj->amount; break;
+        }
+        if(queuedBlocks < blocks){
+            if(dstDeficitBlocks != NULL){
+                *dstDeficitBlocks = blocks - queuedBlocks;
+            }
+            obj->isArmed = NIX_FALSE;
+            r = NIX_TRUE;
         }
-        r = NIX_TRUE;
     }
     return r;
 }
 
 //------
-//Notif
+//SourceRender
 //------
 
-void NixSourceNotif_init(STNixSourceNotif* obj, STNixSourceRef src, const STNixSourceCallback callback){
+void NixSourceRender_init(STNixContextRef ctx, STNixSourceRender* obj){
     memset(obj, 0, sizeof(*obj));
-    if(!NixSource_isNull(src)){
-        NixSource_set(&obj->source, src);
+    NixContext_set(&obj->ctx, ctx);
+}
+
+void NixSourceRender_destroy(STNixSourceRender* obj){
+    if(obj->conv != NULL){
+        NixFmtConverter_free(obj->conv);
+        obj->conv = NULL;
     }
-    obj->callback = callback;
+    if(obj->buff != NULL){
+        NIX_RT_MFREE(obj->ctx, obj->buff);
+        obj->buff = NULL;
+    }
+    obj->buffBlocks = 0;
+    obj->func = NULL;
+    obj->data = NULL;
+    NixContext_release(&obj->ctx);
+    NixContext_null(&obj->ctx);
 }
 
-void NixSourceNotif_destroy(STNixSourceNotif* obj){
-    {
-        NixSI32 i; for(i= 0; i < obj->buffsUse; i++){
-            STNixBufferRef* buff = &obj->buffs[i];
-            if(!NixBuffer_isNull(*buff)){
-                NixBuffer_release(buff);
-                NixBuffer_null(buff);
+NixBOOL NixSourceRender_prepare(STNixSourceRender* obj, const STNixAudioDesc* fmt, const STNixAudioDesc* dstFmt, NixSourceRenderFnc func, void* data){
+    NixBOOL r = NIX_FALSE;
+    if(obj->func == NULL && func != NULL && fmt != NULL && dstFmt != NULL && fmt->blockAlign > 0 && dstFmt->blockAlign > 0){
+        if(STNixAudioDesc_isEqual(fmt, dstFmt)){
+            //rendered directly into the device's buffer
+            r = NIX_TRUE;
+        } else {
+            //rendered in chunks and converted
+            void* conv = NixFmtConverter_alloc(obj->ctx);
+            if(!NixFmtConverter_prepare(conv, fmt, dstFmt)){
+                NIX_PRINTF_ERROR("NixSourceRender_prepare::NixFmtConverter_prepare failed.\n");
+            } else if(NULL == (obj->buff = NixContext_malloc(obj->ctx, NIX_SOURCES_RENDER_BLOCKS * fmt->blockAlign, "NixSourceRender::buff"))){
+                NIX_PRINTF_ERROR("NixSourceRender_prepare::NixContext_malloc failed.\n");
+            } else {
+                obj->buffBlocks = NIX_SOURCES_RENDER_BLOCKS;
+                obj->conv = conv; conv = NULL; //consume
+                r = NIX_TRUE;
+            }
+            //release (if not consumed)
+            if(conv != NULL){
+                NixFmtConverter_free(conv);
+                conv = NULL;
             }
         }
-        obj->buffsUse = 0;
-    }
-    if(!NixSource_isNull(obj->source)){
-        NixSource_release(&obj->source);
-        NixSource_null(&obj->source);
+        if(r){
+            obj->fmt    = *fmt;
+            obj->dstFmt = *dstFmt;
+            obj->func   = func;
+            obj->data   = data;
+        }
     }
+    return r;
 }
 
-NixBOOL NixSourceNotif_addBuff(STNixSourceNotif* obj, STNixBufferRef buff){
-    NixBOOL r = NIX_FALSE;
-    if(!NixBuffer_isNull(buff) && obj->buffsUse < sizeof(obj->buffs) / sizeof(obj->buffs[0])){
-        obj->buffs[obj->buffsUse++] = buff;
-        NixBuffer_retain(buff);
-        r = NIX_TRUE;
+NixUI32 NixSourceRender_fill(STNixSourceRender* obj, STNixSourceRef* src, void* pDst, const NixUI32 dstBlocks){
+    NixUI32 r = 0, written = 0;
+    NIX_TRACE_BEGIN(trRender);
+    if(obj->func != NULL){
+        if(obj->conv == NULL){
+            //direct
+            written = r = (*obj->func)(src, pDst, dstBlocks, &obj->fmt, obj->data);
+            if(written > dstBlocks){
+                written = r = dstBlocks;
+            }
+        } else if(obj->buff != NULL){
+            //chunks
+            while(written < dstBlocks){
+                const NixUI32 dstAvail = (dstBlocks - written);
+                NixUI32 srcBlocks = NixFmtConverter_blocksForNewFrequency(dstAvail, obj->dstFmt.samplerate, obj->fmt.samplerate), rendered = 0, ammRead = 0, ammWritten = 0;
+                if(srcBlocks > obj->buffBlocks){
+                    srcBlocks = obj->buffBlocks;
+                }
+                rendered = (*obj->func)(src, obj->buff, srcBlocks, &obj->fmt, obj->data);
+                if(rendered > srcBlocks){
+                    rendered = srcBlocks;
+                }
+                if(rendered == 0){
+                    break;
+                } else if(!NixFmtConverter_setPtrAtSrcInterlaced(obj->conv, &obj->fmt, obj->buff, 0) || !NixFmtConverter_setPtrAtDstInterlaced(obj->conv, &obj->dstFmt, pDst, written)){
+                    NIX_PRINTF_ERROR("NixSourceRender_fill::NixFmtConverter_setPtrAt failed.\n");
+                    break;
+                } else if(!NixFmtConverter_convert(obj->conv, rendered, dstAvail, &ammRead, &ammWritten) || ammWritten == 0){
+                    NIX_PRINTF_ERROR("NixSourceRender_fill::NixFmtConverter_convert failed.\n");
+                    break;
+                }
+                written += ammWritten;
+                r += rendered;
+                if(rendered < srcBlocks){
+                    //user's underrun
+                    break;
+                }
+            }
+        }
+    }
+    //silence
+    if(written < dstBlocks && obj->dstFmt.blockAlign > 0){
+        const int silence = (obj->dstFmt.samplesFormat == ENNixSampleFmt_Int && obj->dstFmt.bitsPerSample == 8 ? 0x80 : 0x00); //8-bits PCM is unsigned
+        memset(&((NixUI8*)pDst)[written * obj->dstFmt.blockAlign], silence, (dstBlocks - written) * obj->dstFmt.blockAlign);
     }
+    NIX_TRACE_END(trRender, "render", (src != NULL ? src->ptr : NULL));
     return r;
 }
 
 //------
-//NotifQueue
+//OneShots
 //------
 
-void NixNotifQueue_init(STNixContextRef ctx, STNixNotifQueue* obj){
+void NixOneShots_init(STNixContextRef ctx, STNixOneShots* obj){
     memset(obj, 0, sizeof(*obj));
     NixContext_set(&obj->ctx, ctx);
-    obj->arr = obj->arrEmbedded;
-    obj->sz = (sizeof(obj->arrEmbedded) / sizeof(obj->arrEmbedded[0]));
+    obj->mutex  = NixContext_mutex_alloc(obj->ctx);
+    obj->max    = NIX_ONESHOTS_MAX;
+    obj->steal  = ENNixOneShotSteal_Oldest;
 }
 
-void NixNotifQueue_destroy(STNixNotifQueue* obj){
+void NixOneShots_destroy(STNixOneShots* obj){
     if(obj->arr != NULL){
         NixUI32 i; for(i = 0; i < obj->use; i++){
-            STNixSourceNotif* b = &obj->arr[i];
-            NixSourceNotif_destroy(b);
-        }
-        if(obj->arr != obj->arrEmbedded){
-            NixContext_mfree(obj->ctx, obj->arr);
+            STNixOneShot* v = &obj->arr[i];
+            NixSource_stop(v->source);
+            NixSource_release(&v->source);
+            NixSource_null(&v->source);
         }
+        NIX_RT_MFREE(obj->ctx, obj->arr);
         obj->arr = NULL;
     }
     obj->use = obj->sz = 0;
+    NixMutex_free(&obj->mutex);
     NixContext_release(&obj->ctx);
     NixContext_null(&obj->ctx);
 }
 
-NixBOOL NixNotifQueue_addBuff(STNixNotifQueue* obj, STNixSourceRef src, const STNixSourceCallback callback, STNixBufferRef buff){
+void NixOneShots_removeAtLocked_(STNixOneShots* obj, const NixUI32 idx){
+    STNixOneShot* v = &obj->arr[idx];
+    NixSource_stop(v->source);
+    NixSource_release(&v->source);
+    NixSource_null(&v->source);
+    //fill gap with last record (order is defined by 'seq')
+    obj->arr[idx] = obj->arr[--obj->use];
+}
+
+//Returns the index of the voice to replace, or -1 if the new one-shot must be rejected.
+NixSI32 NixOneShots_stealIdxLocked_(STNixOneShots* obj, const NixUI8 priority){
+    NixSI32 r = -1;
+    if(obj->steal != ENNixOneShotSteal_None){
+        NixUI32 i; for(i = 0; i < obj->use; i++){
+            const STNixOneShot* v = &obj->arr[i];
+            if(r < 0){
+                r = (NixSI32)i;
+            } else {
+                const STNixOneShot* b = &obj->arr[r];
+                const NixBOOL isOlder = ((NixSI32)(v->seq - b->seq) < 0);
+                switch (obj->steal) {
+                    case ENNixOneShotSteal_Quietest:
+                        if(v->vol < b->vol || (v->vol == b->vol && isOlder)) r = (NixSI32)i;
+                        break;
+                    case ENNixOneShotSteal_LowerPriority:
+                        if(v->priority < b->priority || (v->priority == b->priority && isOlder)) r = (NixSI32)i;
+                        break;
+                    default:
+                        if(isOlder) r = (NixSI32)i;
+                        break;
+                }
+            }
+        }
+        //higher priority voices are not stolen
+        if(r >= 0 && obj->steal == ENNixOneShotSteal_LowerPriority && obj->arr[r].priority > priority){
+            r = -1;
+        }
+    }
+    return r;
+}
+
+NixBOOL NixOneShots_setLimit(STNixOneShots* obj, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal){
     NixBOOL r = NIX_FALSE;
-    if(obj != NULL){
-        STNixSourceNotif* lst = (obj->use != 0 ? &obj->arr[obj->use - 1] : NULL);
-        if(lst != NULL && NixSource_isSame(src, lst->source)){
-            //accumulate buffer in last record
-            r = NixSourceNotif_addBuff(lst, buff);
+    if((NixUI32)steal < ENNixOneShotSteal_Count){
+        NIX_RT_MUTEX_LOCK(obj->mutex);
+        {
+            obj->max    = maxConcurrent;
+            obj->steal  = steal;
+            //stop extra voices (oldest first, zero is unlimited)
+            while(obj->max > 0 && obj->use > obj->max){
+                NixUI32 i, iOldest = 0;
+                for(i = 1; i < obj->use; i++){
+                    if((NixSI32)(obj->arr[i].seq - obj->arr[iOldest].seq) < 0){
+                        iOldest = i;
+                    }
+                }
+                NixOneShots_removeAtLocked_(obj, iOldest);
+            }
         }
-        if(!r){
+        NixMutex_unlock(obj->mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL NixOneShots_play(STNixOneShots* obj, STNixEngineRef eng, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority){
+    NixBOOL r = NIX_FALSE;
+    if(!NixBuffer_isNull(buff)){
+        NIX_RT_MUTEX_LOCK(obj->mutex);
+        {
+            const NixBOOL isFull = (obj->max > 0 && obj->use >= obj->max); //zero is unlimited
+            //make room
+            if(isFull){
+                const NixSI32 iSteal = NixOneShots_stealIdxLocked_(obj, priority);
+                if(iSteal >= 0){
+                    NixOneShots_removeAtLocked_(obj, (NixUI32)iSteal);
+                }
+            }
             //resize array (if necesary)
-            if(obj->use >= obj->sz){
+            if((obj->max == 0 || obj->use < obj->max) && obj->use >= obj->sz){
                 const NixUI32 szN = obj->use + 4;
-                STNixSourceNotif* arrN = (STNixSourceNotif*)NixContext_mrealloc(obj->ctx, obj->arr, sizeof(STNixSourceNotif) * szN, "NixNotifQueue_addBuff::arrN");
+                STNixOneShot* arrN = (STNixOneShot*)NixContext_mrealloc(obj->ctx, obj->arr, sizeof(STNixOneShot) * szN, "NixOneShots_play::arrN");
                 if(arrN != NULL){
                     obj->arr = arrN;
                     obj->sz = szN;
                 }
             }
-            //add
-            if(obj->use >= obj->sz){
-                NIX_PRINTF_ERROR("NixNotifQueue_addBuff failed (no allocated space).\n");
+            //play
+            if((obj->max > 0 && obj->use >= obj->max) || obj->use >= obj->sz){
+                //limit reached (or no allocated space)
             } else {
-                //become the owner of the pair
-                STNixSourceNotif n;
-                NixSourceNotif_init(&n, src, callback);
-                if(!NixSourceNotif_addBuff(&n, buff)){
-                    NixSourceNotif_destroy(&n);
-                    NIX_ASSERT(NIX_FALSE) //program logic error
+                STNixSourceRef src = NixEngine_allocSource(eng);
+                if(NixSource_isNull(src)){
+                    NIX_PRINTF_ERROR("NixOneShots_play::NixEngine_allocSource failed.\n");
+                } else if(!NixSource_setBuffer(src, buff)){
+                    NIX_PRINTF_ERROR("NixOneShots_play::NixSource_setBuffer failed.\n");
                 } else {
-                    obj->arr[obj->use++] = n;
+                    STNixOneShot* v = &obj->arr[obj->use++];
+                    NixSource_setVolume(src, vol);
+                    NixSource_setPriority(src, priority);
+                    NixSource_play(src);
+                    v->source   = src;
+                    v->vol      = vol;
+                    v->priority = priority;
+                    v->seq      = obj->seq++;
+                    NixSource_null(&src); //consume
                     r = NIX_TRUE;
                 }
+                //release (if not consumed)
+                if(!NixSource_isNull(src)){
+                    NixSource_release(&src);
+                    NixSource_null(&src);
+                }
             }
         }
+        NixMutex_unlock(obj->mutex);
+    }
+    return r;
+}
+
+//One-shots are never paused by the user, but some backends (AAudio, AVFAudio) keep a
+//static source paused after its buffer was fully consumed; compare the counters.
+NixBOOL NixOneShots_isEnded_(STNixOneShot* v){
+    NixBOOL r = NIX_FALSE;
+    if(!NixSource_isPlaying(v->source)){
+        r = !NixSource_isPaused(v->source);
+    } else if(NixSource_isPaused(v->source)){
+        STNixSourceCounters c;
+        memset(&c, 0, sizeof(c));
+        r = (NixSource_getCounters(v->source, &c) && c.framesQueued > 0 && c.framesPlayed >= c.framesQueued);
     }
     return r;
 }
 
+void NixOneShots_tick(STNixOneShots* obj){
+    NIX_RT_MUTEX_LOCK(obj->mutex);
+    {
+        NixUI32 i = 0;
+        while(i < obj->use){
+            STNixOneShot* v = &obj->arr[i];
+            if(NixOneShots_isEnded_(v)){
+                NixOneShots_removeAtLocked_(obj, i);
+            } else {
+                i++;
+            }
+        }
+    }
+    NixMutex_unlock(obj->mutex);
+}
+
 //STNixPCMBuffer (API, common)
 
 STNixBufferRef  nixPCMBuffer_alloc(STNixContextRef ctx, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 void            nixPCMBuffer_free(STNixBufferRef ref);
 NixBOOL         nixPCMBuffer_setData(STNixBufferRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 NixBOOL         nixPCMBuffer_fillWithZeroes(STNixBufferRef ref);
+NixUI8*         nixPCMBuffer_getData(STNixBufferRef ref, NixUI32* optDstUse, NixUI32* optDstSz);
+NixBOOL         nixPCMBuffer_setDataUse(STNixBufferRef ref, const NixUI32 bytes);
 
 NixBOOL NixPCMBuffer_getApiItf(STNixBufferItf* dst){
     NixBOOL r = NIX_FALSE;
@@ -973,6 +2479,8 @@ NixBOOL NixPCMBuffer_getApiItf(STNixBufferItf* dst){
         dst->free       = nixPCMBuffer_free;
         dst->setData    = nixPCMBuffer_setData;
         dst->fillWithZeroes = nixPCMBuffer_fillWithZeroes;
+        dst->getData    = nixPCMBuffer_getData;
+        dst->setDataUse = nixPCMBuffer_setDataUse;
         //
         NixBufferItf_fillMissingMembers(dst);
         //
@@ -1012,12 +2520,12 @@ STNixBufferRef nixPCMBuffer_alloc(STNixContextRef ctx, const STNixAudioDesc* aud
         }
         //release (if not consumed)
         if(itf != NULL){
-            NixContext_mfree(ctx, itf);
+            NIX_RT_MFREE(ctx, itf);
             itf = NULL;
         }
         if(obj != NULL){
             NixPCMBuffer_destroy(obj);
-            NixContext_mfree(ctx, obj);
+            NIX_RT_MFREE(ctx, obj);
             obj = NULL;
         }
     }
@@ -1063,6 +2571,310 @@ NixBOOL nixPCMBuffer_fillWithZeroes(STNixBufferRef pObj){
     return r;
 }
 
+NixUI8* nixPCMBuffer_getData(STNixBufferRef pObj, NixUI32* optDstUse, NixUI32* optDstSz){
+    NixUI8* r = NULL;
+    NixUI32 use = 0, sz = 0;
+    if(pObj.ptr != NULL){
+        STNixPCMBuffer* obj = (STNixPCMBuffer*)NixSharedPtr_getOpq(pObj.ptr);
+        r   = obj->ptr;
+        use = obj->use;
+        sz  = obj->sz;
+    }
+    if(optDstUse != NULL) *optDstUse = use;
+    if(optDstSz != NULL) *optDstSz = sz;
+    return r;
+}
+
+NixBOOL nixPCMBuffer_setDataUse(STNixBufferRef pObj, const NixUI32 bytes){
+    NixBOOL r = NIX_FALSE;
+    if(pObj.ptr != NULL){
+        STNixPCMBuffer* obj = (STNixPCMBuffer*)NixSharedPtr_getOpq(pObj.ptr);
+        r = NixPCMBuffer_setDataUse(obj, bytes);
+    }
+    return r;
+}
+
+//------
+//BufferPool
+//------
+
+struct STNixBufferPool_;
+
+typedef struct STNixBufferPoolItm_ {
+    STNixPCMBuffer          buff;       //must be first member, the buffer API casts the opaque to STNixPCMBuffer
+    struct STNixBufferPool_* pool;
+    STNixAudioDesc          desc;       //key
+    NixUI32                 capacity;   //key
+} STNixBufferPoolItm;
+
+typedef struct STNixBufferPoolFmt_ {
+    STNixAudioDesc          desc;
+    NixUI32                 capacity;
+    struct STNixSharedPtr_** arr;       //idle buffers (retainCount is zero)
+    NixUI32                 use;
+    NixUI32                 sz;
+} STNixBufferPoolFmt;
+
+typedef struct STNixBufferPool_ {
+    STNixContextRef         ctx;
+    STNixMutexRef           mutex;
+    STNixBufferItf          itf;        //shared by all buffers, 'free' returns the buffer to the pool
+    STNixBufferPoolRef      self;       //weak
+    STNixBufferPoolFmt*     fmts;
+    NixUI32                 fmtsUse;
+    NixUI32                 fmtsSz;
+    NixUI32                 maxIdlePerFmt;
+} STNixBufferPool;
+
+void nixBufferPool_itmFree_(STNixBufferRef ref);
+
+void NixBufferPool_itmDestroy_(struct STNixSharedPtr_* ptr){
+    STNixBufferPoolItm* itm = (STNixBufferPoolItm*)NixSharedPtr_getOpq(ptr);
+    NixSharedPtr_free(ptr);
+    if(itm != NULL){
+        STNixMemoryItf memItf = itm->buff.ctx.itf->mem; //use a copy, in case the Context get destroyed
+        NixPCMBuffer_destroy(&itm->buff);
+        if(memItf.free != NULL){
+            (*memItf.free)(itm);
+        }
+    }
+}
+
+STNixBufferPoolFmt* NixBufferPool_getFmtLocked_(STNixBufferPool* obj, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes, const NixBOOL createIfNecesary){
+    STNixBufferPoolFmt* r = NULL;
+    NixUI32 i; for(i = 0; i < obj->fmtsUse; i++){
+        STNixBufferPoolFmt* f = &obj->fmts[i];
+        if(f->capacity == capacityBytes && STNixAudioDesc_isEqual(&f->desc, audioDesc)){
+            r = f;
+            break;
+        }
+    }
+    if(r == NULL && createIfNecesary){
+        //resize array (if necesary)
+        if(obj->fmtsUse >= obj->fmtsSz){
+            const NixUI32 szN = obj->fmtsUse + 4;
+            STNixBufferPoolFmt* arrN = (STNixBufferPoolFmt*)NixContext_mrealloc(obj->ctx, obj->fmts, sizeof(STNixBufferPoolFmt) * szN, "STNixBufferPool::fmtsN");
+            if(arrN != NULL){
+                obj->fmts = arrN;
+                obj->fmtsSz = szN;
+            }
+        }
+        //add
+        if(obj->fmtsUse < obj->fmtsSz){
+            r = &obj->fmts[obj->fmtsUse++];
+            memset(r, 0, sizeof(*r));
+            r->desc     = *audioDesc;
+            r->capacity = capacityBytes;
+        }
+    }
+    return r;
+}
+
+//Creates a new buffer (retainCount is one)
+struct STNixSharedPtr_* NixBufferPool_itmCreate_(STNixBufferPool* obj, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes){
+    struct STNixSharedPtr_* r = NULL;
+    STNixBufferPoolItm* itm = (STNixBufferPoolItm*)NixContext_malloc(obj->ctx, sizeof(STNixBufferPoolItm), "STNixBufferPoolItm");
+    if(itm == NULL){
+        NIX_PRINTF_ERROR("NixBufferPool_itmCreate_::NixContext_malloc failed.\n");
+    } else {
+        memset(itm, 0, sizeof(*itm));
+        NixPCMBuffer_init(obj->ctx, &itm->buff);
+        itm->pool       = obj;
+        itm->desc       = *audioDesc;
+        itm->capacity   = capacityBytes;
+        if(!NixPCMBuffer_setData(&itm->buff, audioDesc, NULL, capacityBytes)){
+            NIX_PRINTF_ERROR("NixBufferPool_itmCreate_::NixPCMBuffer_setData failed.\n");
+        } else if(NULL == (r = NixSharedPtr_alloc(obj->ctx.itf, itm, "NixBufferPool_itmCreate_"))){
+            NIX_PRINTF_ERROR("NixBufferPool_itmCreate_::NixSharedPtr_alloc failed.\n");
+        } else {
+            itm->buff.use = 0;
+            itm = NULL; //consume
+        }
+        //release (if not consumed)
+        if(itm != NULL){
+            NixPCMBuffer_destroy(&itm->buff);
+            NIX_RT_MFREE(obj->ctx, itm);
+            itm = NULL;
+        }
+    }
+    return r;
+}
+
+//Adds an idle buffer (retainCount must be zero)
+NixBOOL NixBufferPool_pushIdleLocked_(STNixBufferPool* obj, struct STNixSharedPtr_* ptr){
+    NixBOOL r = NIX_FALSE;
+    STNixBufferPoolItm* itm = (STNixBufferPoolItm*)NixSharedPtr_getOpq(ptr);
+    //buffer could be reformatted with NixBuffer_setData
+    if(itm->buff.sz >= itm->capacity && STNixAudioDesc_isEqual(&itm->buff.desc, &itm->desc)){
+        STNixBufferPoolFmt* f = NixBufferPool_getFmtLocked_(obj, &itm->desc, itm->capacity, NIX_TRUE);
+        if(f != NULL && f->use < obj->maxIdlePerFmt){
+            //resize array (if necesary)
+            if(f->use >= f->sz){
+                const NixUI32 szN = f->use + 4;
+                struct STNixSharedPtr_** arrN = (struct STNixSharedPtr_**)NixContext_mrealloc(obj->ctx, f->arr, sizeof(struct STNixSharedPtr_*) * szN, "STNixBufferPoolFmt::arrN");
+                if(arrN != NULL){
+                    f->arr = arrN;
+                    f->sz = szN;
+                }
+            }
+            //add
+            if(f->use < f->sz){
+                f->arr[f->use++] = ptr;
+                r = NIX_TRUE;
+            }
+        }
+    }
+    return r;
+}
+
+void NixBufferPool_destroy_(STNixBufferPool* obj){
+    if(obj->fmts != NULL){
+        NixUI32 i; for(i = 0; i < obj->fmtsUse; i++){
+            STNixBufferPoolFmt* f = &obj->fmts[i];
+            if(f->arr != NULL){
+                NixUI32 j; for(j = 0; j < f->use; j++){
+                    NixBufferPool_itmDestroy_(f->arr[j]);
+                }
+                NIX_RT_MFREE(obj->ctx, f->arr);
+                f->arr = NULL;
+            }
+            f->use = f->sz = 0;
+        }
+        NIX_RT_MFREE(obj->ctx, obj->fmts);
+        obj->fmts = NULL;
+    }
+    obj->fmtsUse = obj->fmtsSz = 0;
+    NixMutex_free(&obj->mutex);
+    NixContext_release(&obj->ctx);
+    NixContext_null(&obj->ctx);
+}
+
+STNixBufferPoolRef NixBufferPool_alloc(STNixContextRef ctx, const NixUI32 maxIdlePerFmt){
+    STNixBufferPoolRef r = STNixBufferPoolRef_Zero;
+    STNixBufferPool* obj = (STNixBufferPool*)NixContext_malloc(ctx, sizeof(STNixBufferPool), "STNixBufferPool");
+    if(obj == NULL){
+        NIX_PRINTF_ERROR("NixBufferPool_alloc::NixContext_malloc failed.\n");
+    } else {
+        memset(obj, 0, sizeof(*obj));
+        NixContext_set(&obj->ctx, ctx);
+        obj->mutex          = NixContext_mutex_alloc(obj->ctx);
+        obj->maxIdlePerFmt  = maxIdlePerFmt;
+        if(!NixPCMBuffer_getApiItf(&obj->itf)){
+            NIX_PRINTF_ERROR("NixBufferPool_alloc::NixPCMBuffer_getApiItf failed.\n");
+        } else if(NULL == (r.ptr = NixSharedPtr_alloc(ctx.itf, obj, "NixBufferPool_alloc"))){
+            NIX_PRINTF_ERROR("NixBufferPool_alloc::NixSharedPtr_alloc failed.\n");
+        } else {
+            obj->itf.free = nixBufferPool_itmFree_;
+            obj->self = r;
+            obj = NULL; //consume
+        }
+        //release (if not consumed)
+        if(obj != NULL){
+            NixBufferPool_destroy_(obj);
+            NIX_RT_MFREE(ctx, obj);
+            obj = NULL;
+        }
+    }
+    return r;
+}
+
+void NixBufferPool_retain(STNixBufferPoolRef ref){
+    NixSharedPtr_retain(ref.ptr);
+}
+
+void NixBufferPool_release(STNixBufferPoolRef* ref){
+    if(ref != NULL && ref->ptr != NULL){
+        if(0 == NixSharedPtr_release(ref->ptr)){
+            STNixBufferPool* obj = (STNixBufferPool*)NixSharedPtr_getOpq(ref->ptr);
+            NixSharedPtr_free(ref->ptr);
+            if(obj != NULL){
+                STNixMemoryItf memItf = obj->ctx.itf->mem; //use a copy, in case the Context get destroyed
+                NixBufferPool_destroy_(obj);
+                if(memItf.free != NULL){
+                    (*memItf.free)(obj);
+                }
+            }
+        }
+    }
+}
+
+NixUI32 NixBufferPool_prepare(STNixBufferPoolRef ref, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes, const NixUI32 count){
+    NixUI32 r = 0;
+    STNixBufferPool* obj = (STNixBufferPool*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && audioDesc != NULL && audioDesc->blockAlign > 0){
+        while(r < count){
+            struct STNixSharedPtr_* ptr = NixBufferPool_itmCreate_(obj, audioDesc, capacityBytes);
+            if(ptr == NULL){
+                break;
+            } else {
+                NixBOOL added = NIX_FALSE;
+                NixSharedPtr_release(ptr); //idle buffers have no owner
+                NIX_RT_MUTEX_LOCK(obj->mutex);
+                {
+                    added = NixBufferPool_pushIdleLocked_(obj, ptr);
+                }
+                NixMutex_unlock(obj->mutex);
+                if(!added){
+                    NixBufferPool_itmDestroy_(ptr);
+                    break;
+                }
+            }
+            ++r;
+        }
+    }
+    return r;
+}
+
+STNixBufferRef NixBufferPool_acquire(STNixBufferPoolRef ref, const STNixAudioDesc* audioDesc, const NixUI32 capacityBytes){
+    STNixBufferRef r = STNixBufferRef_Zero;
+    STNixBufferPool* obj = (STNixBufferPool*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && audioDesc != NULL && audioDesc->blockAlign > 0){
+        struct STNixSharedPtr_* ptr = NULL;
+        //reuse
+        NIX_RT_MUTEX_LOCK(obj->mutex);
+        {
+            STNixBufferPoolFmt* f = NixBufferPool_getFmtLocked_(obj, audioDesc, capacityBytes, NIX_FALSE);
+            if(f != NULL && f->use > 0){
+                ptr = f->arr[--f->use];
+                NixSharedPtr_revive_(ptr);
+            }
+        }
+        NixMutex_unlock(obj->mutex);
+        //create
+        if(ptr == NULL){
+            ptr = NixBufferPool_itmCreate_(obj, audioDesc, capacityBytes);
+        }
+        //result (each buffer in use retains the pool)
+        if(ptr != NULL){
+            STNixBufferPoolItm* itm = (STNixBufferPoolItm*)NixSharedPtr_getOpq(ptr);
+            itm->buff.use = 0;
+            NixBufferPool_retain(obj->self);
+            r.ptr = ptr;
+            r.itf = &obj->itf;
+        }
+    }
+    return r;
+}
+
+void nixBufferPool_itmFree_(STNixBufferRef ref){
+    if(ref.ptr != NULL){
+        STNixBufferPoolItm* itm = (STNixBufferPoolItm*)NixSharedPtr_getOpq(ref.ptr);
+        STNixBufferPool* obj = itm->pool;
+        STNixBufferPoolRef pool = obj->self;
+        NixBOOL added = NIX_FALSE;
+        NIX_RT_MUTEX_LOCK(obj->mutex);
+        {
+            added = NixBufferPool_pushIdleLocked_(obj, ref.ptr);
+        }
+        NixMutex_unlock(obj->mutex);
+        if(!added){
+            NixBufferPool_itmDestroy_(ref.ptr);
+        }
+        //release the pool (could be destroyed)
+        NixBufferPool_release(&pool);
+    }
+}
+
 #define NIX_FMT_CONVERTER_FREQ_PRECISION    512 //fixed point-denominator
 #define NIX_FMT_CONVERTER_CHANNELS_MAX      2
 
@@ -1093,6 +2905,8 @@ typedef struct STNixFmtConv_ {
             NixSI32     accumSI32[NIX_FMT_CONVERTER_CHANNELS_MAX];
         };
     } samplesAccum;
+    //stats (optional)
+    STNixEngineStatsState* stats;
 } STNixFmtConv;
 
 void* NixFmtConverter_alloc(STNixContextRef ctx){
@@ -1108,7 +2922,7 @@ void NixFmtConverter_free(void* pObj){
         STNixContextRef ctxCpy = obj->ctx;
         {
             NixContext_null(&obj->ctx);
-            NixContext_mfree(ctxCpy, obj);
+            NIX_RT_MFREE(ctxCpy, obj);
         }
         NixContext_release(&ctxCpy); //release ctx after memory is freed
         //
@@ -1204,19 +3018,35 @@ NixBOOL NixFmtConverter_convertSameFreq_(STNixFmtConv* obj, const NixUI32 srcBlo
 NixBOOL NixFmtConverter_convertIncFreq_(STNixFmtConv* obj, const NixUI32 srcBlocks, NixUI32 dstBlocks, NixUI32* dstAmmBlocksRead, NixUI32* dstAmmBlocksWritten);
 NixBOOL NixFmtConverter_convertDecFreq_(STNixFmtConv* obj, const NixUI32 srcBlocks, NixUI32 dstBlocks, NixUI32* dstAmmBlocksRead, NixUI32* dstAmmBlocksWritten);
 
+void NixFmtConverter_setStats(void* pObj, STNixEngineStatsState* stats){
+    STNixFmtConv* obj = (STNixFmtConv*)pObj;
+    if(obj != NULL){
+        obj->stats = stats;
+    }
+}
+
 NixBOOL NixFmtConverter_convert(void* pObj, const NixUI32 srcBlocks, NixUI32 dstBlocks, NixUI32* dstAmmBlocksRead, NixUI32* dstAmmBlocksWritten){
     NixBOOL r = NIX_FALSE;
     STNixFmtConv* obj = (STNixFmtConv*)pObj;
     if(obj != NULL){
+        const NixUI64 nsStart = (obj->stats != NULL ? NixClock_getMonotonicNs() : 0);
+        NixUI32 read = 0;
+        NIX_TRACE_BEGIN(trConv);
         if(obj->src.desc.samplerate == obj->dst.desc.samplerate){
             //same freq
-            r = NixFmtConverter_convertSameFreq_(obj, srcBlocks, dstBlocks, dstAmmBlocksRead, dstAmmBlocksWritten);
+            r = NixFmtConverter_convertSameFreq_(obj, srcBlocks, dstBlocks, &read, dstAmmBlocksWritten);
         } else if(obj->src.desc.samplerate < obj->dst.desc.samplerate){
             //increasing freq
-            r = NixFmtConverter_convertIncFreq_(obj, srcBlocks, dstBlocks, dstAmmBlocksRead, dstAmmBlocksWritten);
+            r = NixFmtConverter_convertIncFreq_(obj, srcBlocks, dstBlocks, &read, dstAmmBlocksWritten);
         } else {
             //decreasing freq
-            r = NixFmtConverter_convertDecFreq_(obj, srcBlocks, dstBlocks, dstAmmBlocksRead, dstAmmBlocksWritten);
+            r = NixFmtConverter_convertDecFreq_(obj, srcBlocks, dstBlocks, &read, dstAmmBlocksWritten);
+        }
+        if(r && dstAmmBlocksRead != NULL) *dstAmmBlocksRead = read;
+        NIX_TRACE_END(trConv, "convert", obj);
+        //stats
+        if(obj->stats != NULL){
+            NixEngineStats_addConv(obj->stats, (NixUI64)read * obj->src.desc.blockAlign, NixClock_getMonotonicNs() - nsStart);
         }
     }
     return r;
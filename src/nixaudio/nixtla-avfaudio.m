@@ -28,6 +28,8 @@
 #include <AVFAudio/AVAudioFormat.h>
 #include <AVFAudio/AVAudioChannelLayout.h>
 #include <AVFAudio/AVAudioConverter.h>
+#include <AVFAudio/AVAudioTime.h>
+#include <mach/mach_time.h>     //mach_absolute_time()
 
 //------
 //API Itf
@@ -47,6 +49,15 @@ void            nixAVAudioEngine_tick(STNixEngineRef ref);
 STNixSourceRef  nixAVAudioEngine_allocSource(STNixEngineRef ref);
 STNixBufferRef  nixAVAudioEngine_allocBuffer(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 STNixRecorderRef nixAVAudioEngine_allocRecorder(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
+//One-shots
+NixBOOL         nixAVAudioEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+NixBOOL         nixAVAudioEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal);
+//Batch
+void            nixAVAudioEngine_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+//Clock
+NixUI64         nixAVAudioEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec);
+//Stats
+NixBOOL         nixAVAudioEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst);
 //Source
 STNixSourceRef  nixAVAudioSource_alloc(STNixEngineRef eng);
 void            nixAVAudioSource_free(STNixSourceRef ref);
@@ -65,6 +76,14 @@ NixBOOL         nixAVAudioSource_queueBuffer(STNixSourceRef ref, STNixBufferRef
 NixBOOL         nixAVAudioSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset); //relative to first buffer in queue
 NixUI32         nixAVAudioSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);   //all buffer queue
 NixUI32         nixAVAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //relative to first buffer in queue
+//Scheduling
+NixBOOL         nixAVAudioSource_playAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         nixAVAudioSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames);
+//Counters
+NixBOOL         nixAVAudioSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst);
+NixBOOL         nixAVAudioSource_getClock(STNixSourceRef ref, STNixSourceClock* dst);
+//Low watermark
+NixBOOL         nixAVAudioSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
 //Recorder
 STNixRecorderRef nixAVAudioRecorder_alloc(STNixEngineRef eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
 void            nixAVAudioRecorder_free(STNixRecorderRef ref);
@@ -74,6 +93,7 @@ NixBOOL         nixAVAudioRecorder_stop(STNixRecorderRef ref);
 NixBOOL         nixAVAudioRecorder_flush(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying);
 NixBOOL         nixAVAudioRecorder_isCapturing(STNixRecorderRef ref);
 NixUI32         nixAVAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);
+NixBOOL         nixAVAudioRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst);
 
 NixBOOL nixAVAudioEngine_getApiItf(STNixApiItf* dst){
     NixBOOL r = NIX_FALSE;
@@ -90,6 +110,15 @@ NixBOOL nixAVAudioEngine_getApiItf(STNixApiItf* dst){
         dst->engine.allocSource = nixAVAudioEngine_allocSource;
         dst->engine.allocBuffer = nixAVAudioEngine_allocBuffer;
         dst->engine.allocRecorder = nixAVAudioEngine_allocRecorder;
+        //One-shots
+        dst->engine.playOneShot = nixAVAudioEngine_playOneShot;
+        dst->engine.setOneShotsLimit = nixAVAudioEngine_setOneShotsLimit;
+        //Batch
+        dst->engine.playSources = nixAVAudioEngine_playSources;
+        //Clock
+        dst->engine.getFrameTime = nixAVAudioEngine_getFrameTime;
+        //Stats
+        dst->engine.getStats = nixAVAudioEngine_getStats;
         //PCMBuffer
         NixPCMBuffer_getApiItf(&dst->buffer);
         //Source
@@ -110,6 +139,14 @@ NixBOOL nixAVAudioEngine_getApiItf(STNixApiItf* dst){
         dst->source.setBufferOffset = nixAVAudioSource_setBufferOffset; //relative to first buffer in queue
         dst->source.getBuffersCount = nixAVAudioSource_getBuffersCount; //all buffer queue
         dst->source.getBlocksOffset = nixAVAudioSource_getBlocksOffset; //relative to first buffer in queue
+        //Scheduling
+        dst->source.playAt      = nixAVAudioSource_playAt;
+        dst->source.getStartError = nixAVAudioSource_getStartError;
+        //Counters
+        dst->source.getCounters = nixAVAudioSource_getCounters;
+        dst->source.getClock    = nixAVAudioSource_getClock;
+        //Low watermark
+        dst->source.setLowWatermark = nixAVAudioSource_setLowWatermark;
         //Recorder
         dst->recorder.alloc     = nixAVAudioRecorder_alloc;
         dst->recorder.free      = nixAVAudioRecorder_free;
@@ -119,6 +156,7 @@ NixBOOL nixAVAudioEngine_getApiItf(STNixApiItf* dst){
         dst->recorder.flush     = nixAVAudioRecorder_flush;
         dst->recorder.isCapturing = nixAVAudioRecorder_isCapturing;
         dst->recorder.getBuffersFilledCount = nixAVAudioRecorder_getBuffersFilledCount;
+        dst->recorder.getCounters = nixAVAudioRecorder_getCounters;
         //
         r = NIX_TRUE;
     }
@@ -140,6 +178,9 @@ struct STNixAVAudioRecorder_;
 typedef struct STNixAVAudioEngine_ {
     STNixContextRef ctx;
     STNixApiItf     apiItf;
+    STNixOneShots   oneShots;   //fire-and-forget voices
+    STNixEngineClock clock;     //timeline of the scheduling calls
+    STNixEngineStatsState stats;
     //srcs
     struct {
         STNixMutexRef   mutex;
@@ -215,6 +256,18 @@ typedef struct STNixAVAudioSource_ {
         NixUI32             pendBlockIdx;  //current sample playing/filling
         NixUI32             pendScheduledCount;
     } queues;
+    //counters (protected by queues.mutex, frames of buffsFmt)
+    struct {
+        NixUI64             queued;
+        NixUI64             played;     //rendered buffers (buffer granularity)
+        STNixPosInterp      clock;      //NixSource_getClock interpolation
+    } counters;
+    STNixSourceWatermark    wmark;      //low watermark (protected by queues.mutex, checked by tick)
+    //sched
+    struct {
+        NixSI64             startErr;   //engine frames (positive is late)
+        NixBOOL             isStartErrSet;
+    } sched;
     //packed bools to reduce padding
     NixBOOL                 engStarted;
     NixUI8                  stateBits;  //packed bools to reduce padding, NIX_AVAudioSource_BIT_
@@ -226,6 +279,7 @@ void NixAVAudioSource_scheduleEnqueuedBuffers(STNixAVAudioSource* obj);
 NixBOOL NixAVAudioSource_queueBufferForOutput(STNixAVAudioSource* obj, STNixBufferRef buff);
 NixBOOL NixAVAudioSource_pendPopOldestBuffLocked_(STNixAVAudioSource* obj);
 NixBOOL NixAVAudioSource_pendPopAllBuffsLocked_(STNixAVAudioSource* obj);
+NixUI32 NixAVAudioSource_getQueuedBlocksLocked_(STNixAVAudioSource* obj); //frames of buffers not rendered yet (buffsFmt, buffer granularity)
 
 #define NIX_AVAudioSource_BIT_isStatic   (0x1 << 0)  //source expects only one buffer, repeats or pauses after playing it
 #define NIX_AVAudioSource_BIT_isChanging (0x1 << 1)  //source is changing state after a call to request*()
@@ -260,6 +314,7 @@ typedef struct STNixAVAudioRecorder_ {
     NixBOOL                 engStarted;
     STNixEngineRef          engRef;
     STNixRecorderRef        selfRef;
+    STNixEngineStatsState*  stats;  //engine's ('engRef' is retained)
     AVAudioEngine*          eng;    //AVAudioEngine
     //callback
     struct {
@@ -283,6 +338,10 @@ typedef struct STNixAVAudioRecorder_ {
             NixSI32         iCurSample; //at first buffer in 'reuse'
         } filling;
     } queues;
+    //counters (protected by queues.mutex, frames of cfg.fmt)
+    struct {
+        NixUI64             captured;
+    } counters;
 } STNixAVAudioRecorder;
 
 void NixAVAudioRecorder_init(STNixContextRef ctx,STNixAVAudioRecorder* obj);
@@ -310,6 +369,18 @@ void NixAVAudioEngine_init(STNixContextRef ctx, STNixAVAudioEngine* obj){
     //
     NixContext_set(&obj->ctx, ctx);
     nixAVAudioEngine_getApiItf(&obj->apiItf);
+    //oneShots
+    {
+        NixOneShots_init(obj->ctx, &obj->oneShots);
+    }
+    //clock
+    {
+        NixEngineClock_init(&obj->clock, NIX_ENGINE_CLOCK_RATE);
+    }
+    //stats
+    {
+        NixEngineStats_init(&obj->stats);
+    }
     //srcs
     {
         obj->srcs.mutex = NixContext_mutex_alloc(obj->ctx);
@@ -317,6 +388,8 @@ void NixAVAudioEngine_init(STNixContextRef ctx, STNixAVAudioEngine* obj){
 }
 
 void NixAVAudioEngine_destroy(STNixAVAudioEngine* obj){
+    //oneShots (released before sources cleanup)
+    NixOneShots_destroy(&obj->oneShots);
     //srcs
     {
         //cleanup
@@ -325,7 +398,7 @@ void NixAVAudioEngine_destroy(STNixAVAudioEngine* obj){
         }
         //
         if(obj->srcs.arr != NULL){
-            NixContext_mfree(obj->ctx, obj->srcs.arr);
+            NIX_RT_MFREE(obj->ctx, obj->srcs.arr);
             obj->srcs.arr = NULL;
         }
         NixMutex_free(&obj->srcs.mutex);
@@ -341,7 +414,7 @@ void NixAVAudioEngine_destroy(STNixAVAudioEngine* obj){
 NixBOOL NixAVAudioEngine_srcsAdd(STNixAVAudioEngine* obj, struct STNixAVAudioSource_* src){
     NixBOOL r = NIX_FALSE;
     if(obj != NULL){
-        NixMutex_lock(obj->srcs.mutex);
+        NIX_RT_MUTEX_LOCK(obj->srcs.mutex);
         {
             //resize array (if necesary)
             if(obj->srcs.use >= obj->srcs.sz){
@@ -370,7 +443,7 @@ void NixAVAudioEngine_removeSrcRecordLocked_(STNixAVAudioEngine* obj, NixSI32* i
     STNixAVAudioSource* src = obj->srcs.arr[*idx];
     if(src != NULL){
         NixAVAudioSource_destroy(src);
-        NixContext_mfree(obj->ctx, src);
+        NIX_RT_MFREE(obj->ctx, src);
     }
     //fill gap
     --obj->srcs.use;
@@ -387,7 +460,7 @@ void NixAVAudioEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNi
     if(src->queues.notify.use > 0){
         NixSI32 i; for(i = 0; i < src->queues.notify.use; i++){
             STNixAVAudioQueuePair* pair = &src->queues.notify.arr[i];
-            if(!NixNotifQueue_addBuff(notifs, src->self, src->queues.callback, pair->org)){
+            if(!NixNotifQueue_addBuffMove(notifs, src->self, src->queues.callback, &pair->org)){
                 NIX_ASSERT(NIX_FALSE); //program logic error
             }
         }
@@ -399,11 +472,14 @@ void NixAVAudioEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNi
     
 void NixAVAudioEngine_tick(STNixAVAudioEngine* obj, const NixBOOL isFinalCleanup){
     if(obj != NULL){
+        const NixUI64 nsStart = NixClock_getMonotonicNs();
+        NixUI32 buffsNotified = 0;
+        NIX_TRACE_BEGIN(trTick);
         //srcs
         {
             STNixNotifQueue notifs;
             NixNotifQueue_init(obj->ctx, &notifs);
-            NixMutex_lock(obj->srcs.mutex);
+            NIX_RT_MUTEX_LOCK(obj->srcs.mutex);
             if(obj->srcs.arr != NULL && obj->srcs.use > 0){
                 NixUI32 changingStateCount = 0;
                 //NIX_PRINTF_INFO("NixAVAudioEngine_tick::%d sources.\n", obj->srcs.use);
@@ -435,9 +511,17 @@ void NixAVAudioEngine_tick(STNixAVAudioEngine* obj, const NixBOOL isFinalCleanup
                         if(src != NULL){
                             //add to notify queue
                             {
-                                NixMutex_lock(src->queues.mutex);
+                                NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                 {
                                     NixAVAudioEngine_tick_addQueueNotifSrcLocked_(&notifs, src);
+                                    //low watermark
+                                    if(!NixAVAudioSource_isStatic(src) && NixSourceWatermark_isEnabled(&src->wmark) && NixAVAudioSource_isPlaying(src) && !NixAVAudioSource_isPaused(src)){
+                                        const NixUI32 queued = NixAVAudioSource_getQueuedBlocksLocked_(src);
+                                        NixUI32 deficit = 0;
+                                        if(NixSourceWatermark_check(&src->wmark, &src->buffsFmt, queued, &deficit)){
+                                            NixNotifQueue_addNeedsData(&notifs, src->self, &src->wmark, queued, deficit);
+                                        }
+                                    }
                                 }
                                 NixMutex_unlock(src->queues.mutex);
                             }
@@ -455,8 +539,20 @@ void NixAVAudioEngine_tick(STNixAVAudioEngine* obj, const NixBOOL isFinalCleanup
                     STNixSourceNotif* n = &notifs.arr[i];
                     //NIX_PRINTF_INFO("NixAVAudioEngine_tick::notify(#%d/%d).\n", i + 1, notifs.use);
                     if(n->callback.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*n->callback.func)(&n->source, n->buffs, n->buffsUse, n->callback.data);
+                        NIX_TRACE_END(trCall, "srcCallback", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
+                    }
+                    if(n->needs.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
+                        (*n->needs.func)(&n->source, n->needs.queued, n->needs.deficit, n->needs.data);
+                        NIX_TRACE_END(trCall, "srcNeedsData", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
                     }
+                    buffsNotified += n->buffsUse;
                 }
             }
             //NIX_PRINTF_INFO("NixAVAudioEngine_tick::NixNotifQueue_destroy.\n");
@@ -466,6 +562,11 @@ void NixAVAudioEngine_tick(STNixAVAudioEngine* obj, const NixBOOL isFinalCleanup
         if(obj->rec != NULL){
             NixAVAudioRecorder_notifyBuffers(obj->rec, NIX_FALSE);
         }
+        NIX_TRACE_END(trTick, "tick", obj);
+        //stats
+        NixEngineStats_addTick(&obj->stats, NixClock_getMonotonicNs() - nsStart, buffsNotified);
+        //log (messages queued by this tick and the device threads)
+        NixLog_flush();
     }
 }
 
@@ -489,9 +590,10 @@ void NixAVAudioQueuePair_destroy(STNixAVAudioQueuePair* obj){
 }
 
 void NixAVAudioQueuePair_moveOrg(STNixAVAudioQueuePair* obj, STNixAVAudioQueuePair* to){
-    NixBuffer_set(&to->org, obj->org);
-    NixBuffer_release(&obj->org);
-    NixBuffer_null(&obj->org);
+    if(!NixBuffer_isNull(to->org)){
+        NixBuffer_release(&to->org);
+    }
+    to->org = NixBuffer_move(&obj->org);
 }
 
 void NixAVAudioQueuePair_moveCnv(STNixAVAudioQueuePair* obj, STNixAVAudioQueuePair* to){
@@ -518,7 +620,7 @@ void NixAVAudioQueue_destroy(STNixAVAudioQueue* obj){
             STNixAVAudioQueuePair* b = &obj->arr[i];
             NixAVAudioQueuePair_destroy(b);
         }
-        NixContext_mfree(obj->ctx, obj->arr);
+        NIX_RT_MFREE(obj->ctx, obj->arr);
         obj->arr = NULL;
     }
     obj->use = obj->sz = 0;
@@ -657,7 +759,8 @@ void NixAVAudioSource_destroy(STNixAVAudioSource* obj){
 }
 
 void NixAVAudioSource_queueBufferScheduleCallback_(STNixAVAudioSource* obj, AVAudioPCMBuffer* cnvBuff){
-    NixMutex_lock(obj->queues.mutex);
+    NIX_TRACE_BEGIN(trDevice);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NIX_ASSERT(obj->queues.pendScheduledCount > 0)
         if(obj->queues.pendScheduledCount > 0){
@@ -674,6 +777,9 @@ void NixAVAudioSource_queueBufferScheduleCallback_(STNixAVAudioSource* obj, AVAu
 #           endif*/
             --obj->queues.pendScheduledCount;
         }
+        if(obj->queues.pend.use > 0){
+            obj->counters.played += NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(obj->queues.pend.arr[0].org.ptr));
+        }
         if(NixAVAudioSource_isStatic(obj)){
             //schedule again
             if(NixAVAudioSource_isPlaying(obj) && !NixAVAudioSource_isPaused(obj) && NixAVAudioSource_isRepeat(obj) && !NixAVAudioSource_isOrphan(obj) && obj->queues.pend.use == 1 && obj->queues.pendScheduledCount == 0){
@@ -687,7 +793,7 @@ void NixAVAudioSource_queueBufferScheduleCallback_(STNixAVAudioSource* obj, AVAu
                         }
                     }];
                 }
-                NixMutex_lock(obj->queues.mutex);
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
             } else {
                 //pause
                 NixAVAudioSource_setIsPaused(obj, NIX_TRUE);
@@ -697,14 +803,19 @@ void NixAVAudioSource_queueBufferScheduleCallback_(STNixAVAudioSource* obj, AVAu
                 //remove from queue, to pend
             } else {
                 //buff moved from pend to reuse and notif
+                //underrun (queue drained while playing)
+                if(obj->queues.pend.use == 0 && NixAVAudioSource_isPlaying(obj) && !NixAVAudioSource_isPaused(obj) && obj->engp != NULL){
+                    NixEngineStats_addUnderrun(&obj->engp->stats);
+                }
             }
         }
     }
     NixMutex_unlock(obj->queues.mutex);
+    NIX_TRACE_END(trDevice, "deviceCompletion", obj->self.ptr);
 }
 
 void NixAVAudioSource_scheduleEnqueuedBuffers(STNixAVAudioSource* obj){
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     while(obj->queues.pendScheduledCount < obj->queues.pend.use){
         STNixAVAudioQueuePair* pair = &obj->queues.pend.arr[obj->queues.pendScheduledCount];
         NIX_ASSERT(pair->cnv != nil)
@@ -723,7 +834,7 @@ void NixAVAudioSource_scheduleEnqueuedBuffers(STNixAVAudioSource* obj){
                     }
                 }];
             }
-            NixMutex_lock(obj->queues.mutex);
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         }
     }
     NixMutex_unlock(obj->queues.mutex);
@@ -867,13 +978,18 @@ NixBOOL NixAVAudioSource_queueBufferForOutput(STNixAVAudioSource* obj, STNixBuff
         //add to queue
         if(r){
             NixBuffer_set(&pair.org, pBuff);
-            NixMutex_lock(obj->queues.mutex);
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
             {
                 if(!NixAVAudioQueue_pushOwning(&obj->queues.pend, &pair)){
                     NIX_PRINTF_ERROR("NixAVAudioSource_queueBufferForOutput::NixAVAudioQueue_pushOwning failed.\n");
                     r = NIX_FALSE;
                 } else {
                     //added to queue
+                    obj->counters.queued += NixPCMBuffer_getBlocks(buff);
+                    obj->wmark.isArmed = NIX_TRUE;
+                    if(obj->engp != NULL){
+                        NixEngineStats_addQueued(&obj->engp->stats, 1);
+                    }
                     NixAVAudioQueue_prepareForSz(&obj->queues.reuse, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
                     NixAVAudioQueue_prepareForSz(&obj->queues.notify, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
                     //this is the first buffer i the queue
@@ -938,6 +1054,17 @@ NixBOOL NixAVAudioSource_pendPopAllBuffsLocked_(STNixAVAudioSource* obj){
     return r;
 }
 
+NixUI32 NixAVAudioSource_getQueuedBlocksLocked_(STNixAVAudioSource* obj){
+    NixUI64 r = 0;
+    NixUI32 i; for(i = 0; i < obj->queues.pend.use; ++i){
+        const STNixAVAudioQueuePair* pair = &obj->queues.pend.arr[i];
+        if(!NixBuffer_isNull(pair->org)){
+            r += NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr));
+        }
+    }
+    return (NixUI32)r;
+}
+
 //------
 //Recorder
 //------
@@ -960,7 +1087,7 @@ void NixAVAudioRecorder_init(STNixContextRef ctx, STNixAVAudioRecorder* obj){
 void NixAVAudioRecorder_destroy(STNixAVAudioRecorder* obj){
     //queues
     {
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixAVAudioQueue_destroy(&obj->queues.notify);
             NixAVAudioQueue_destroy(&obj->queues.reuse);
@@ -994,8 +1121,9 @@ void NixAVAudioRecorder_destroy(STNixAVAudioRecorder* obj){
 }
 
 void NixAVAudioRecorder_consumeInputBuffer_(STNixAVAudioRecorder* obj, AVAudioPCMBuffer* buff){
+    NIX_TRACE_BEGIN(trConsume);
     if(obj->queues.conv != NULL){
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixUI32 inIdx = 0;
             const NixUI32 inSz = [buff frameLength];
@@ -1007,6 +1135,13 @@ void NixAVAudioRecorder_consumeInputBuffer_(STNixAVAudioRecorder* obj, AVAudioPC
                         NIX_ASSERT(NIX_FALSE);
                         break;
                     }
+                    //overrun (its frames are lost)
+                    if(obj->stats != NULL && !NixBuffer_isNull(obj->queues.reuse.arr[0].org)){
+                        const STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(obj->queues.reuse.arr[0].org.ptr);
+                        if(org->desc.blockAlign > 0){
+                            NixEngineStats_addRecOverrun(obj->stats, org->use / org->desc.blockAlign);
+                        }
+                    }
                 } else {
                     STNixAVAudioQueuePair* pair = &obj->queues.reuse.arr[0];
                     STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1069,6 +1204,7 @@ void NixAVAudioRecorder_consumeInputBuffer_(STNixAVAudioRecorder* obj, AVAudioPC
                             } else {
                                 inIdx += ammBlocksRead;
                                 obj->queues.filling.iCurSample += ammBlocksWritten;
+                                obj->counters.captured += ammBlocksWritten;
                                 org->use = (obj->queues.filling.iCurSample * org->desc.blockAlign); NIX_ASSERT(org->use <= org->sz)
                             }
                         }
@@ -1087,12 +1223,13 @@ void NixAVAudioRecorder_consumeInputBuffer_(STNixAVAudioRecorder* obj, AVAudioPC
         }
         NixMutex_unlock(obj->queues.mutex);
     }
+    NIX_TRACE_END(trConsume, "recConsume", obj->selfRef.ptr);
 }
 
 
 NixBOOL NixAVAudioRecorder_prepare(STNixAVAudioRecorder* obj, STNixAVAudioEngine* eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer){
     NixBOOL r = NIX_FALSE;
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.conv == NULL && audioDesc->blockAlign > 0){
         obj->eng = [[AVAudioEngine alloc] init];
         {
@@ -1125,6 +1262,8 @@ NixBOOL NixAVAudioRecorder_prepare(STNixAVAudioRecorder* obj, STNixAVAudioEngine
                 } else {
                     r = NIX_TRUE;
                     //prepared
+                    obj->stats = &eng->stats;
+                    NixFmtConverter_setStats(conv, obj->stats);
                     obj->queues.filling.iCurSample = 0;
                     obj->queues.conv = conv; conv = NULL; //consume
                     //cfg
@@ -1140,7 +1279,7 @@ NixBOOL NixAVAudioRecorder_prepare(STNixAVAudioRecorder* obj, STNixAVAudioEngine
                             //printf("AVFAudio recorder buffer with %d samples (%d samples in memory).\n", [buffer frameLength], obj->in.samples.cur);
                         }];
                     }
-                    NixMutex_lock(obj->queues.mutex);
+                    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
                     [obj->eng prepare];
                 }
             }
@@ -1192,7 +1331,7 @@ NixBOOL NixAVAudioRecorder_stop(STNixAVAudioRecorder* obj){
 NixBOOL NixAVAudioRecorder_flush(STNixAVAudioRecorder* obj){
     NixBOOL r = NIX_TRUE;
     //move filling buffer to notify (if data is available)
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.reuse.use > 0){
         STNixAVAudioQueuePair* pair = &obj->queues.reuse.arr[0];
         if(!NixBuffer_isNull(pair->org) && ((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr))->use > 0){
@@ -1208,7 +1347,7 @@ NixBOOL NixAVAudioRecorder_flush(STNixAVAudioRecorder* obj){
 }
 
 void NixAVAudioRecorder_notifyBuffers(STNixAVAudioRecorder* obj, const NixBOOL discardWithoutNotifying){
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         const NixUI32 maxProcess = obj->queues.notify.use;
         NixUI32 ammProcessed = 0;
@@ -1224,9 +1363,15 @@ void NixAVAudioRecorder_notifyBuffers(STNixAVAudioRecorder* obj, const NixBOOL d
                     STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair.org.ptr);
                     NixMutex_unlock(obj->queues.mutex);
                     {
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*obj->callback.func)(&obj->engRef, &obj->selfRef, org->desc, org->ptr, org->use, (org->use / org->desc.blockAlign), obj->callback.data);
+                        NIX_TRACE_END(trCall, "recCallback", obj->selfRef.ptr);
+                        if(obj->stats != NULL){
+                            NixEngineStats_addCallback(obj->stats, NixClock_getMonotonicNs() - nsCall);
+                        }
                     }
-                    NixMutex_lock(obj->queues.mutex);
+                    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
                 }
                 //move to reuse
                 if(!NixAVAudioQueue_pushOwning(&obj->queues.reuse, &pair)){
@@ -1260,7 +1405,7 @@ STNixEngineRef nixAVAudioEngine_alloc(STNixContextRef ctx){
         //release (if not consumed)
         if(obj != NULL){
             NixAVAudioEngine_destroy(obj);
-            NixContext_mfree(ctx, obj);
+            NIX_RT_MFREE(ctx, obj);
             obj = NULL;
         }
     }
@@ -1317,6 +1462,7 @@ NixBOOL nixAVAudioEngine_ctxDeactivate(STNixEngineRef pObj){
 void nixAVAudioEngine_tick(STNixEngineRef pObj){
     STNixAVAudioEngine* obj = (STNixAVAudioEngine*)NixSharedPtr_getOpq(pObj.ptr);
     if(obj != NULL){
+        NixOneShots_tick(&obj->oneShots);
         NixAVAudioEngine_tick(obj, NIX_FALSE);
     }
 }
@@ -1350,6 +1496,93 @@ STNixRecorderRef nixAVAudioEngine_allocRecorder(STNixEngineRef ref, const STNixA
     return r;
 }
 
+//One-shots
+
+NixBOOL nixAVAudioEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority){
+    NixBOOL r = NIX_FALSE;
+    STNixAVAudioEngine* obj = (STNixAVAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_play(&obj->oneShots, ref, buff, vol, priority);
+    }
+    return r;
+}
+
+NixBOOL nixAVAudioEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal){
+    NixBOOL r = NIX_FALSE;
+    STNixAVAudioEngine* obj = (STNixAVAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_setLimit(&obj->oneShots, maxConcurrent, steal);
+    }
+    return r;
+}
+
+//Batch
+
+void nixAVAudioEngine_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz){
+    STNixAVAudioEngine* eng = (STNixAVAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(eng != NULL && srcs != NULL){
+        //common start time (sample-aligned between player nodes)
+        AVAudioTime* when = [AVAudioTime timeWithHostTime:(mach_absolute_time() + [AVAudioTime hostTimeForSeconds:((NSTimeInterval)NIX_SOURCES_SYNC_START_US / 1000000.0)])];
+        NixUI32 i; for(i = 0; i < srcsSz; i++){
+            const STNixSourceRef src = srcs[i];
+            if(src.itf != &eng->apiItf.source){
+                //not from this engine
+                NixSource_play(src);
+            } else if(src.ptr != NULL){
+                STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(src.ptr);
+                NixAVAudioSource_setIsPlaying(obj, NIX_TRUE);
+                NixAVAudioSource_setIsPaused(obj, NIX_FALSE);
+                NixAVAudioSource_scheduleEnqueuedBuffers(obj);
+                if(obj->eng != nil && [obj->eng isRunning]){
+                    [obj->src playAtTime:when];
+                } else {
+                    [obj->src play];
+                }
+            }
+        }
+    }
+}
+
+//Clock
+
+NixUI64 nixAVAudioEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec){
+    NixUI64 r = 0;
+    STNixAVAudioEngine* obj = (STNixAVAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixEngineClock_getFrame(&obj->clock);
+    }
+    if(optDstFramesPerSec != NULL){
+        *optDstFramesPerSec = (obj != NULL ? obj->clock.rate : 0);
+    }
+    return r;
+}
+
+//Stats
+
+NixBOOL nixAVAudioEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixAVAudioEngine* obj = (STNixAVAudioEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        NixEngineStats_get(&obj->stats, dst);
+        //sources
+        NIX_RT_MUTEX_LOCK(obj->srcs.mutex);
+        {
+            NixUI32 i; for(i = 0; i < obj->srcs.use; ++i){
+                STNixAVAudioSource* src = obj->srcs.arr[i];
+                if(!NixAVAudioSource_isOrphan(src)){
+                    dst->sourcesTotal++;
+                    if(NixAVAudioSource_isPlaying(src) && !NixAVAudioSource_isPaused(src)){
+                        dst->sourcesActive++;
+                    }
+                }
+            }
+        }
+        NixMutex_unlock(obj->srcs.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
 //------
 //Source API
 //------
@@ -1381,7 +1614,7 @@ STNixSourceRef nixAVAudioSource_alloc(STNixEngineRef pEng){
                         NIX_PRINTF_ERROR("nixAVAudioSource_create, AVAudioEngine::startAndReturnError failed: '%s'.\n", err == nil ? "unknown" : [[err description] UTF8String]);
                         [obj->src release]; obj->src = nil;
                         [obj->eng release]; obj->eng = nil;
-                        NixContext_mfree(eng->ctx, obj);
+                        NIX_RT_MFREE(eng->ctx, obj);
                         obj = NULL;
                     } else {
                         obj->engStarted = NIX_TRUE;
@@ -1402,7 +1635,7 @@ STNixSourceRef nixAVAudioSource_alloc(STNixEngineRef pEng){
         //release (if not consumed)
         if(obj != NULL){
             NixAVAudioSource_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            NIX_RT_MFREE(eng->ctx, obj);
             obj = NULL;
         }
     }
@@ -1440,7 +1673,7 @@ void nixAVAudioSource_removeAllBuffersAndNotify_(STNixAVAudioSource* obj){
     STNixNotifQueue notifs;
     NixNotifQueue_init(obj->ctx, &notifs);
     //move all pending buffers to notify
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixAVAudioSource_pendPopAllBuffsLocked_(obj);
         NixAVAudioEngine_tick_addQueueNotifSrcLocked_(&notifs, obj);
@@ -1607,6 +1840,9 @@ NixBOOL nixAVAudioSource_setBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
                 NIX_PRINTF_ERROR("nixAVAudioSource_queueBuffer, nixAVAudioSource_createConverter failed.\n");
             } else {
                 //set format
+                if(obj->engp != NULL){
+                    NixFmtConverter_setStats(obj->queues.conv, &obj->engp->stats);
+                }
                 obj->buffsFmt = buff->desc;
                 NixAVAudioSource_setIsStatic(obj, NIX_TRUE);
                 if(!NixAVAudioSource_queueBufferForOutput(obj, pBuff)){
@@ -1643,6 +1879,9 @@ NixBOOL nixAVAudioSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff)
                 //error, converter creation failed
             } else {
                 //set format
+                if(obj->engp != NULL){
+                    NixFmtConverter_setStats(obj->queues.conv, &obj->engp->stats);
+                }
                 obj->buffsFmt = buff->desc;
             }
         }
@@ -1666,7 +1905,7 @@ NixBOOL nixAVAudioSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetTy
     NixBOOL r = NIX_FALSE;
     if(ref.ptr != NULL){
         STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->queues.pend.use > 0){
             STNixAVAudioQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1698,7 +1937,7 @@ NixUI32 nixAVAudioSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstByte
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixUI32 i; for(i = 0; i < obj->queues.pend.use; i++){
                 STNixAVAudioQueuePair* pair = &obj->queues.pend.arr[0];
@@ -1724,7 +1963,7 @@ NixUI32 nixAVAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstByte
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->src != nil && obj->queues.pend.use > 0){
             STNixAVAudioQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1749,6 +1988,112 @@ NixUI32 nixAVAudioSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstByte
     return r;
 }
 
+//Scheduling
+
+NixBOOL nixAVAudioSource_playAt(STNixSourceRef ref, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->engp != NULL){
+            const NixUI64 usAt = NixEngineClock_frameToUs(&obj->engp->clock, engFrame);
+            const NixUI64 usNow = NixClock_getMonotonicUs();
+            NixAVAudioSource_setIsPlaying(obj, NIX_TRUE);
+            NixAVAudioSource_setIsPaused(obj, NIX_FALSE);
+            NixAVAudioSource_scheduleEnqueuedBuffers(obj);
+            if(usAt > usNow && obj->eng != nil && [obj->eng isRunning]){
+                //sample-accurate start by the player node
+                AVAudioTime* when = [AVAudioTime timeWithHostTime:(mach_absolute_time() + [AVAudioTime hostTimeForSeconds:((NSTimeInterval)(usAt - usNow) / 1000000.0)])];
+                [obj->src playAtTime:when];
+                obj->sched.startErr = 0;
+            } else {
+                //already due
+                [obj->src play];
+                obj->sched.startErr = (usAt < usNow ? NixEngineClock_usToFrames(&obj->engp->clock, (NixSI64)(usNow - usAt)) : 0);
+            }
+            obj->sched.isStartErrSet = NIX_TRUE;
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+NixBOOL nixAVAudioSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->sched.isStartErrSet){
+            if(dstFrames != NULL){
+                *dstFrames = obj->sched.startErr;
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+//Counters
+
+NixBOOL nixAVAudioSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesQueued   = obj->counters.queued;
+            dst->framesPlayed   = obj->counters.played;
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL nixAVAudioSource_getClock(STNixSourceRef ref, STNixSourceClock* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        const NixUI64 usNow = NixClock_getMonotonicUs();
+        NixUI64 latencyUs = 0;
+        if(obj->eng != nil){
+            if(@available(macOS 10.13, iOS 11.0, *)){
+                const NSTimeInterval secs = obj->eng.outputNode.presentationLatency;
+                latencyUs = (secs > 0 ? (NixUI64)(secs * 1000000.0) : 0);
+            }
+        }
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            //interpolate up to the end of the buffer being rendered
+            const NixBOOL isRunning = (NixAVAudioSource_isPlaying(obj) && !NixAVAudioSource_isPaused(obj) && obj->queues.pendScheduledCount > 0);
+            const NixUI64 maxAhead = (isRunning && obj->queues.pend.use > 0 ? NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(obj->queues.pend.arr[0].org.ptr)) : 0);
+            dst->framesPlayed   = NixPosInterp_get(&obj->counters.clock, obj->counters.played, obj->buffsFmt.samplerate, maxAhead, usNow);
+            dst->latencyUs      = latencyUs;
+            dst->timeUs         = usNow;
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//Low watermark
+
+NixBOOL nixAVAudioSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixAVAudioSource* obj = (STNixAVAudioSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(!NixAVAudioSource_isStatic(obj)){
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                NixSourceWatermark_set(&obj->wmark, type, amount, callback, callbackData);
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
 //------
 //NixFmtConverter API
 //------
@@ -1807,7 +2152,7 @@ STNixRecorderRef nixAVAudioRecorder_alloc(STNixEngineRef pEng, const STNixAudioD
         //release (if not consumed)
         if(obj != NULL){
             NixAVAudioRecorder_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            NIX_RT_MFREE(eng->ctx, obj);
             obj = NULL;
         }
     }
@@ -1884,7 +2229,7 @@ NixUI32 nixAVAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32*
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     STNixAVAudioRecorder* obj = (STNixAVAudioRecorder*)NixSharedPtr_getOpq(ref.ptr);
     //calculate filled buffers
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixUI32 i; for(i = 0; i < obj->queues.notify.use; i++){
             STNixAVAudioQueuePair* pair = &obj->queues.notify.arr[0];
@@ -1905,3 +2250,18 @@ NixUI32 nixAVAudioRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32*
     return r;
 }
 
+NixBOOL nixAVAudioRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixAVAudioRecorder* obj = (STNixAVAudioRecorder*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesCaptured = obj->counters.captured;
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
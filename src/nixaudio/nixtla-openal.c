@@ -22,6 +22,7 @@
 #include "nixaudio/nixtla-audio.h"
 #include "nixtla-openal.h"
 #include <string.h> //for memset()
+#include <stdlib.h> //for qsort()
 
 #ifdef __MAC_OS_X_VERSION_MAX_ALLOWED
 #   include <OpenAL/al.h>
@@ -33,10 +34,48 @@
 
 #define NIX_OPENAL_NULL     AL_NONE
 
+#ifndef AL_APIENTRY
+#   define AL_APIENTRY
+#endif
+
+//AL_SOFT_events (OpenAL-Soft extension, declared here because 'alext.h' could be old or missing)
+#ifndef AL_SOFT_events
+#   define AL_SOFT_events                           1
+#   define AL_EVENT_CALLBACK_FUNCTION_SOFT          0x19A2
+#   define AL_EVENT_CALLBACK_USER_PARAM_SOFT        0x19A3
+#   define AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT      0x19A4
+#   define AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT  0x19A5
+#   define AL_EVENT_TYPE_DISCONNECTED_SOFT          0x19A6
+typedef void (AL_APIENTRY*ALEVENTPROCSOFT)(ALenum eventType, ALuint object, ALuint param, ALsizei length, const ALchar* message, void* userParam);
+typedef void (AL_APIENTRY*LPALEVENTCONTROLSOFT)(ALsizei count, const ALenum* types, ALboolean enable);
+typedef void (AL_APIENTRY*LPALEVENTCALLBACKSOFT)(ALEVENTPROCSOFT callback, void* userParam);
+#endif
+
+//AL_SOFT_source_latency (OpenAL-Soft extension, declared here because 'alext.h' could be old or missing)
+#ifndef AL_SOFT_source_latency
+#   define AL_SOFT_source_latency                   1
+#   define AL_SAMPLE_OFFSET_LATENCY_SOFT            0x1200
+#   define AL_SEC_OFFSET_LATENCY_SOFT               0x1201
+typedef long long ALint64SOFT;
+typedef void (AL_APIENTRY*LPALGETSOURCEI64VSOFT)(ALuint source, ALenum param, ALint64SOFT* values);
+#endif
+
+//AL_SOFT_callback_buffer (OpenAL-Soft extension, declared here because 'alext.h' could be old or missing)
+#ifndef AL_SOFT_callback_buffer
+#   define AL_SOFT_callback_buffer                  1
+#   define AL_BUFFER_CALLBACK_FUNCTION_SOFT         0x19A0
+#   define AL_BUFFER_CALLBACK_USER_PARAM_SOFT       0x19A1
+typedef ALsizei (AL_APIENTRY*ALBUFFERCALLBACKTYPESOFT)(ALvoid* userptr, ALvoid* sampledata, ALsizei numbytes);
+typedef void (AL_APIENTRY*LPALBUFFERCALLBACKSOFT)(ALuint buffer, ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, ALvoid* userptr);
+#endif
+
+//errors (counted for NixEngine_getStats, process-wide since AL errors are per-context-thread state)
+static volatile NixUI32 NixOpenAL_errorsCount_ = 0;
+
 #ifdef NIX_ASSERTS_ACTIVATED
-#   define NIX_OPENAL_ERR_VERIFY(nomFunc)   { ALenum idErrorAL=alGetError(); if(idErrorAL != AL_NO_ERROR){ NIX_PRINTF_ERROR("'%s' (#%d) en %s\n", alGetString(idErrorAL), idErrorAL, nomFunc);} NIX_ASSERT(idErrorAL == AL_NO_ERROR);}
+#   define NIX_OPENAL_ERR_VERIFY(nomFunc)   { ALenum idErrorAL=alGetError(); if(idErrorAL != AL_NO_ERROR){ NIX_ATOMIC_ADD32(&NixOpenAL_errorsCount_, 1); NIX_PRINTF_ERROR("'%s' (#%d) en %s\n", alGetString(idErrorAL), idErrorAL, nomFunc);} NIX_ASSERT(idErrorAL == AL_NO_ERROR);}
 #else
-#   define NIX_OPENAL_ERR_VERIFY(nomFunc)   { }
+#   define NIX_OPENAL_ERR_VERIFY(nomFunc)   { if(alGetError() != AL_NO_ERROR){ NIX_ATOMIC_ADD32(&NixOpenAL_errorsCount_, 1); } }
 #endif
 
 //------
@@ -57,6 +96,18 @@ void            nixOpenALEngine_tick(STNixEngineRef ref);
 STNixSourceRef  nixOpenALEngine_allocSource(STNixEngineRef ref);
 STNixBufferRef  nixOpenALEngine_allocBuffer(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI8* audioDataPCM, const NixUI32 audioDataPCMBytes);
 STNixRecorderRef nixOpenALEngine_allocRecorder(STNixEngineRef ref, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
+//One-shots
+NixBOOL         nixOpenALEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority);
+NixBOOL         nixOpenALEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal);
+//Voices
+NixBOOL         nixOpenALEngine_setVoicesLimit(STNixEngineRef ref, const NixUI32 maxReal);
+//Batch
+void            nixOpenALEngine_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+void            nixOpenALEngine_stopSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz);
+//Clock
+NixUI64         nixOpenALEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec);
+//Stats
+NixBOOL         nixOpenALEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst);
 //Source
 STNixSourceRef  nixOpenALSource_alloc(STNixEngineRef eng);
 void            nixOpenALSource_free(STNixSourceRef ref);
@@ -72,9 +123,23 @@ NixBOOL         nixOpenALSource_isRepeat(STNixSourceRef ref);
 NixFLOAT        nixOpenALSource_getVolume(STNixSourceRef ref);
 NixBOOL         nixOpenALSource_setBuffer(STNixSourceRef ref, STNixBufferRef buff);  //static-source
 NixBOOL         nixOpenALSource_queueBuffer(STNixSourceRef ref, STNixBufferRef buff); //stream-source
+NixBOOL         nixOpenALSource_queueBufferMove(STNixSourceRef ref, STNixBufferRef* buff); //stream-source
+NixUI32         nixOpenALSource_queueBuffers(STNixSourceRef ref, const STNixBufferRef* buffs, const NixUI32 buffsSz); //stream-source
 NixBOOL         nixOpenALSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset); //relative to first buffer in queue
 NixUI32         nixOpenALSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //all buffer queue
 NixUI32         nixOpenALSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);  //relative to first buffer in queue
+NixBOOL         nixOpenALSource_setPriority(STNixSourceRef ref, const NixUI8 priority);
+NixBOOL         nixOpenALSource_isVirtual(STNixSourceRef ref);
+NixBOOL         nixOpenALSource_playAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         nixOpenALSource_stopAt(STNixSourceRef ref, const NixUI64 engFrame);
+NixBOOL         nixOpenALSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames);
+//Counters
+NixBOOL         nixOpenALSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst);
+NixBOOL         nixOpenALSource_getClock(STNixSourceRef ref, STNixSourceClock* dst);
+//Low watermark
+NixBOOL         nixOpenALSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData);
+//Render
+NixBOOL         nixOpenALSource_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData);
 //Recorder
 STNixRecorderRef nixOpenALRecorder_alloc(STNixEngineRef eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer);
 void            nixOpenALRecorder_free(STNixRecorderRef ref);
@@ -84,6 +149,7 @@ NixBOOL         nixOpenALRecorder_stop(STNixRecorderRef ref);
 NixBOOL         nixOpenALRecorder_flush(STNixRecorderRef ref, const NixBOOL includeCurrentPartialBuff, const NixBOOL discardWithoutNotifying);
 NixBOOL         nixOpenALRecorder_isCapturing(STNixRecorderRef ref);
 NixUI32         nixOpenALRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* optDstBytesCount, NixUI32* optDstBlocksCount, NixUI32* optDstMsecsCount);
+NixBOOL         nixOpenALRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst);
 
 NixBOOL nixOpenALEngine_getApiItf(STNixApiItf* dst){
     NixBOOL r = NIX_FALSE;
@@ -100,6 +166,18 @@ NixBOOL nixOpenALEngine_getApiItf(STNixApiItf* dst){
         dst->engine.allocSource = nixOpenALEngine_allocSource;
         dst->engine.allocBuffer = nixOpenALEngine_allocBuffer;
         dst->engine.allocRecorder = nixOpenALEngine_allocRecorder;
+        //One-shots
+        dst->engine.playOneShot = nixOpenALEngine_playOneShot;
+        dst->engine.setOneShotsLimit = nixOpenALEngine_setOneShotsLimit;
+        //Voices
+        dst->engine.setVoicesLimit = nixOpenALEngine_setVoicesLimit;
+        //Batch
+        dst->engine.playSources = nixOpenALEngine_playSources;
+        dst->engine.stopSources = nixOpenALEngine_stopSources;
+        //Clock
+        dst->engine.getFrameTime = nixOpenALEngine_getFrameTime;
+        //Stats
+        dst->engine.getStats = nixOpenALEngine_getStats;
         //PCMBuffer
         NixPCMBuffer_getApiItf(&dst->buffer);
         //Source
@@ -117,9 +195,23 @@ NixBOOL nixOpenALEngine_getApiItf(STNixApiItf* dst){
         dst->source.getVolume   = nixOpenALSource_getVolume;
         dst->source.setBuffer   = nixOpenALSource_setBuffer;  //static-source
         dst->source.queueBuffer = nixOpenALSource_queueBuffer; //stream-source
+        dst->source.queueBufferMove = nixOpenALSource_queueBufferMove; //stream-source
+        dst->source.queueBuffers    = nixOpenALSource_queueBuffers; //stream-source
         dst->source.setBufferOffset = nixOpenALSource_setBufferOffset; //relative to first buffer in queue
         dst->source.getBuffersCount = nixOpenALSource_getBuffersCount; //all buffer queue
         dst->source.getBlocksOffset = nixOpenALSource_getBlocksOffset; //relative to first buffer in queue
+        dst->source.setPriority = nixOpenALSource_setPriority;
+        dst->source.isVirtual   = nixOpenALSource_isVirtual;
+        dst->source.playAt      = nixOpenALSource_playAt;
+        dst->source.stopAt      = nixOpenALSource_stopAt;
+        dst->source.getStartError = nixOpenALSource_getStartError;
+        //Counters
+        dst->source.getCounters = nixOpenALSource_getCounters;
+        dst->source.getClock    = nixOpenALSource_getClock;
+        //Low watermark
+        dst->source.setLowWatermark = nixOpenALSource_setLowWatermark;
+        //Render
+        dst->source.setRenderCallback = nixOpenALSource_setRenderCallback;
         //Recorder
         dst->recorder.alloc     = nixOpenALRecorder_alloc;
         dst->recorder.free      = nixOpenALRecorder_free;
@@ -129,6 +221,7 @@ NixBOOL nixOpenALEngine_getApiItf(STNixApiItf* dst){
         dst->recorder.flush     = nixOpenALRecorder_flush;
         dst->recorder.isCapturing = nixOpenALRecorder_isCapturing;
         dst->recorder.getBuffersFilledCount = nixOpenALRecorder_getBuffersFilledCount;
+        dst->recorder.getCounters = nixOpenALRecorder_getCounters;
         //
         r = NIX_TRUE;
     }
@@ -141,6 +234,44 @@ struct STNixOpenALQueue_;
 struct STNixOpenALQueuePair_;
 struct STNixOpenALRecorder_;
 
+//------
+//Event (AL_SOFT_events)
+//------
+
+typedef struct STNixOpenALEvent_ {
+    ALenum          type;       //AL_EVENT_TYPE_*
+    ALuint          idSourceAL; //object
+    ALuint          param;      //buffers completed or new state
+} STNixOpenALEvent;
+
+//------
+//Buffers pool (AL buffer names released by sources, reused by any source)
+//------
+
+typedef struct STNixOpenALBuffRec_ {
+    ALuint          idBufferAL;
+    ALenum          fmtAL;      //format of last data loaded
+    NixUI32         freq;       //samplerate of last data loaded
+    NixUI32         gen;        //tick-generation when released (not reused nor deleted in the same tick)
+} STNixOpenALBuffRec;
+
+//------
+//Sources snapshot (immutable, reference counted)
+//------
+
+typedef struct STNixOpenALSrcsSnap_ {
+    volatile NixUI32        retainCount;
+    NixUI32                 use;
+    struct STNixOpenALSource_**  arr;    //allocated after this header
+    //byAL (open-addressing index by 'idSourceAL', linear probing, allocated after 'arr')
+    struct {
+        struct STNixOpenALSource_** arr; //NULL slots are empty
+        NixUI32             mask;   //size - 1 (power of two)
+    } byAL;
+} STNixOpenALSrcsSnap;
+
+struct STNixOpenALSource_* NixOpenALSrcsSnap_findByAL(const STNixOpenALSrcsSnap* obj, const ALuint idSourceAL);
+
 //------
 //Engine
 //------
@@ -148,26 +279,94 @@ struct STNixOpenALRecorder_;
 typedef struct STNixOpenALEngine_ {
     STNixContextRef ctx;
     STNixApiItf     apiItf;
+    STNixOneShots   oneShots;   //fire-and-forget voices
+    STNixEngineClock clock;     //timeline of the scheduling calls
+    STNixEngineStatsState stats;
     NixUI32         maskCapabilities;
     NixBOOL         contextALIsCurrent;
     ALCcontext*     contextAL;
     ALCdevice*      deviceAL;
     ALCdevice*      idCaptureAL;                //OpenAL specific
     NixUI32         captureMainBufferBytesCount;    //OpenAL specific
-    //srcs
+    //srcs (published as immutable snapshots, replaced on add/remove)
+    struct {
+        volatile NixUI32 readers; //retains in progress (lock-free, writers wait for them before releasing a replaced snapshot)
+        struct STNixOpenALSrcsSnap_* cur;
+    } srcs;
+    //actv (sources with pending work, intrusive list; idle sources are not visited by tick)
+    struct {
+        STNixMutexRef   mutex;
+        struct STNixOpenALSource_* first;
+        NixUI32         use;
+        //tick (snapshot of the list, only accessed by tick)
+        struct {
+            struct STNixOpenALSource_** arr;
+            NixUI32     use;
+            NixUI32     sz;
+        } tick;
+    } actv;
+    //pool (released sources, reset and ready for reuse)
     struct {
         STNixMutexRef   mutex;
         struct STNixOpenALSource_** arr;
         NixUI32         use;
         NixUI32         sz;
-    } srcs;
+    } pool;
+    //virt (voices limit, only accessed by tick except 'maxReal')
+    struct {
+        volatile NixUI32 maxReal;   //zero is unlimited
+        NixBOOL         wasLimited; //virtual sources could remain from previous ticks
+        struct STNixOpenALSource_** arr; //tracked playing static sources (real and virtual), sorted by audibility each tick
+        NixUI32         use;
+        NixUI32         sz;
+    } virt;
+    //buffs (pool of unqueued AL buffers, deleted only when exceeding NIX_OPENAL_BUFFERS_POOL_MAX)
+    struct {
+        STNixMutexRef   mutex;
+        STNixOpenALBuffRec* arr;    //oldest first
+        NixUI32         use;
+        NixUI32         sz;
+        NixUI32         gen;        //incremented each tick
+    } buffs;
     struct STNixOpenALRecorder_* rec;
+    //events (AL_SOFT_events, single-producer single-consumer ring)
+    struct {
+        NixBOOL         isEnabled;
+        LPALEVENTCONTROLSOFT  alEventControlSOFT;
+        LPALEVENTCALLBACKSOFT alEventCallbackSOFT;
+        STNixOpenALEvent arr[NIX_OPENAL_EVENTS_QUEUE_SZ];
+        volatile NixUI32 iWrite;    //pushed by the AL event thread
+        volatile NixUI32 iRead;     //popped by tick
+        volatile NixUI32 overflows; //events lost, the next tick polls all sources
+    } events;
+    //latency (AL_SOFT_source_latency, optional)
+    struct {
+        LPALGETSOURCEI64VSOFT alGetSourcei64vSOFT;
+    } latency;
+    //render (AL_SOFT_callback_buffer, optional)
+    struct {
+        LPALBUFFERCALLBACKSOFT alBufferCallbackSOFT;
+    } render;
 } STNixOpenALEngine;
 
 void NixOpenALEngine_init(STNixContextRef ctx, STNixOpenALEngine* obj);
 void NixOpenALEngine_destroy(STNixOpenALEngine* obj);
 NixBOOL NixOpenALEngine_srcsAdd(STNixOpenALEngine* obj, struct STNixOpenALSource_* src);
+NixBOOL NixOpenALEngine_srcsRemove(STNixOpenALEngine* obj, struct STNixOpenALSource_* src);
+STNixOpenALSrcsSnap* NixOpenALEngine_srcsRetain(STNixOpenALEngine* obj);
+void NixOpenALEngine_srcsRelease(STNixOpenALEngine* obj, STNixOpenALSrcsSnap* snap);
+void NixOpenALEngine_actvAdd(STNixOpenALEngine* obj, struct STNixOpenALSource_* src);
+struct STNixOpenALSource_* NixOpenALEngine_poolPop(STNixOpenALEngine* obj);
+NixBOOL NixOpenALEngine_poolReturn(STNixOpenALEngine* obj, struct STNixOpenALSource_* src);
+NixUI32 NixOpenALEngine_poolGrow(STNixOpenALEngine* obj, const NixUI32 count);
+ALuint NixOpenALEngine_buffsAcquire(STNixOpenALEngine* obj, const ALenum fmtAL, const NixUI32 freq);
+void NixOpenALEngine_buffsRelease(STNixOpenALEngine* obj, const ALuint idBufferAL, const ALenum fmtAL, const NixUI32 freq);
+void NixOpenALEngine_buffsTrim(STNixOpenALEngine* obj, const NixUI32 maxUse);
 void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup);
+NixBOOL NixOpenALEngine_eventsEnable(STNixOpenALEngine* obj);
+void NixOpenALEngine_eventsDisable(STNixOpenALEngine* obj);
+void NixOpenALEngine_virtTrack_(STNixOpenALEngine* obj, struct STNixOpenALSource_* src); //tick only
+void NixOpenALEngine_virtUntrack_(STNixOpenALEngine* obj, struct STNixOpenALSource_* src); //tick only
 
 
 //------
@@ -230,18 +429,69 @@ typedef struct STNixOpenALSource_ {
         } conv;
         STNixSourceCallback callback;
         STNixOpenALQueue    notify; //buffers (consumed, pending to notify)
-        STNixOpenALQueue    reuse;  //buffers (conversion buffers)
-        STNixOpenALQueue    pend;   //to be played/filled
+        STNixOpenALQueue    pend;   //to be played/filled (unqueued AL buffers return to engine's pool)
         NixUI32             pendBlockIdx;  //current sample playing/filling
     } queues;
+    //counters (protected by queues.mutex, frames of buffsFmt)
+    struct {
+        NixUI64             queued;
+        volatile NixUI64    played;     //unqueued buffers and stopped positions (the current AL position is added when sampled), NIX_ATOMIC_ADD64 (also fed by the AL mixer thread)
+        STNixPosInterp      clock;      //NixSource_getClock interpolation
+    } counters;
+    STNixSourceWatermark    wmark;      //low watermark (protected by queues.mutex, checked by tick)
+    //render (pull-model, set once; fed by the AL mixer thread with AL_SOFT_callback_buffer, or by tick with a ring of AL buffers)
+    struct {
+        STNixSourceRender   core;
+        ALuint              idBufferCbAL;   //AL_SOFT_callback_buffer
+        ALuint              idsBuffersAL[NIX_OPENAL_RENDER_BUFFERS]; //ring
+        ALuint              idsFree[NIX_OPENAL_RENDER_BUFFERS]; //ring, unqueued (only accessed by tick once set)
+        NixUI32             idsFreeUse;
+        volatile NixUI32    flushPend;      //ring, stopped by the user; tick unqueues the buffers (not counted as played)
+        void*               pcm;            //ring, one buffer of srcFmt samples
+    } render;
     //props
     float                   volume;
     NixUI8                  stateBits;  //packed bools to reduce padding, NIX_OpenALSource_BIT_
+    //virt (static sources only, the AL source is paused while virtual)
+    struct {
+        NixUI8              priority;
+        NixBOOL             isTracked;  //at engine's 'virt.arr' (only accessed by tick)
+        NixUI32             blockStart; //AL_SAMPLE_OFFSET when virtualized
+        NixUI32             blocksLen;  //AL buffer's samples
+        NixUI64             usStart;    //clock when virtualized
+    } virt;
+    //sched (best effort, applied by the engine's tick while the source is in the active list; protected by queues.mutex)
+    struct {
+        NixUI64             startUs;    //pending start (NixClock_getMonotonicUs time), zero if none
+        NixUI64             stopUs;     //pending stop (NixClock_getMonotonicUs time), zero if none
+        NixSI64             startErr;   //achieved error of the last scheduled start (engine frames)
+        NixBOOL             isStartErrSet;
+    } sched;
+    //actv (link at engine's active list, protected by eng->actv.mutex)
+    struct {
+        struct STNixOpenALSource_* prev;
+        struct STNixOpenALSource_* next;
+        NixBOOL             isLinked;
+    } actv;
 } STNixOpenALSource;
 
 void NixOpenALSource_init(STNixContextRef ctx, STNixOpenALSource* obj);
 void NixOpenALSource_destroy(STNixOpenALSource* obj);
-NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBufferRef buff, const NixBOOL isStream);
+NixBOOL NixOpenALSource_reset(STNixOpenALSource* obj);
+void NixOpenALSource_virtDemote(STNixOpenALSource* obj, const NixUI64 usNow);
+void NixOpenALSource_virtPromote(STNixOpenALSource* obj, const NixUI64 usNow, const NixBOOL resume);
+NixBOOL NixOpenALSource_virtIsEnded(const STNixOpenALSource* obj, const NixUI64 usNow); //non-repeating virtual source reached its buffer's end
+void nixOpenALSource_removeAllBuffersAndNotify_(STNixOpenALSource* obj);
+NixUI64 NixOpenALSource_getPlayedOffsetLocked_(STNixOpenALSource* obj); //frames played of the AL queue (buffsFmt)
+NixUI64 NixOpenALSource_getPlayedOffsetAndLatencyLocked_(STNixOpenALSource* obj, NixUI64* dstLatencyUs); //AL_SOFT_source_latency if available
+NixUI32 NixOpenALSource_getQueuedBlocksLocked_(STNixOpenALSource* obj); //frames pending to be played (buffsFmt)
+void    NixOpenALSource_renderRelease_(STNixOpenALSource* obj); //the render buffers must be detached from the AL source
+void    NixOpenALSource_renderUnqueue_(STNixOpenALSource* obj, const NixBOOL countAsPlayed); //ring (tick only), returns processed buffers to 'idsFree'
+void    NixOpenALSource_renderRefill_(STNixOpenALSource* obj); //ring (tick only), renders and queues the free buffers
+#define NixOpenALSource_isRender(OBJ)          NixSourceRender_isSet(&(OBJ)->render.core)
+#define NixOpenALSource_isRenderRing(OBJ)      ((OBJ)->render.pcm != NULL)
+NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBufferRef buff, const NixBOOL isStream, const NixBOOL isMove); //isMove: the caller's reference is consumed on success
+NixUI32 NixOpenALSource_queueBuffersForOutput(STNixOpenALSource* obj, const STNixBufferRef* buffs, const NixUI32 buffsSz); //stream, returns the ammount queued
 NixBOOL NixOpenALSource_pendPopOldestBuffLocked_(STNixOpenALSource* obj);
 NixBOOL NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixOpenALSource* obj);
 
@@ -252,6 +502,7 @@ NixBOOL NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixOpenA
 #define NIX_OpenALSource_BIT_isPaused   (0x1 << 4)
 #define NIX_OpenALSource_BIT_isClosing  (0x1 << 5)
 #define NIX_OpenALSource_BIT_isOrphan   (0x1 << 6)  //source is waiting for close(), wait for the change of state and NixOpenALSource_release + free.
+#define NIX_OpenALSource_BIT_isVirtual  (0x1 << 7)  //playing without a real voice, the position advances with the clock
 //
 #define NixOpenALSource_isStatic(OBJ)          (((OBJ)->stateBits & NIX_OpenALSource_BIT_isStatic) != 0)
 #define NixOpenALSource_isChanging(OBJ)        (((OBJ)->stateBits & NIX_OpenALSource_BIT_isChanging) != 0)
@@ -260,6 +511,7 @@ NixBOOL NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixOpenA
 #define NixOpenALSource_isPaused(OBJ)          (((OBJ)->stateBits & NIX_OpenALSource_BIT_isPaused) != 0)
 #define NixOpenALSource_isClosing(OBJ)         (((OBJ)->stateBits & NIX_OpenALSource_BIT_isClosing) != 0)
 #define NixOpenALSource_isOrphan(OBJ)          (((OBJ)->stateBits & NIX_OpenALSource_BIT_isOrphan) != 0)
+#define NixOpenALSource_isVirtual(OBJ)         (((OBJ)->stateBits & NIX_OpenALSource_BIT_isVirtual) != 0)
 //
 #define NixOpenALSource_setIsStatic(OBJ, V)    (OBJ)->stateBits = (V ? (OBJ)->stateBits | NIX_OpenALSource_BIT_isStatic : (OBJ)->stateBits & ~NIX_OpenALSource_BIT_isStatic)
 #define NixOpenALSource_setIsChanging(OBJ, V)  (OBJ)->stateBits = (V ? (OBJ)->stateBits | NIX_OpenALSource_BIT_isChanging : (OBJ)->stateBits & ~NIX_OpenALSource_BIT_isChanging)
@@ -268,6 +520,7 @@ NixBOOL NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixOpenA
 #define NixOpenALSource_setIsPaused(OBJ, V)    (OBJ)->stateBits = (V ? (OBJ)->stateBits | NIX_OpenALSource_BIT_isPaused : (OBJ)->stateBits & ~NIX_OpenALSource_BIT_isPaused)
 #define NixOpenALSource_setIsClosing(OBJ)      (OBJ)->stateBits = ((OBJ)->stateBits | NIX_OpenALSource_BIT_isClosing)
 #define NixOpenALSource_setIsOrphan(OBJ)       (OBJ)->stateBits = ((OBJ)->stateBits | NIX_OpenALSource_BIT_isOrphan)
+#define NixOpenALSource_setIsVirtual(OBJ, V)   (OBJ)->stateBits = (V ? (OBJ)->stateBits | NIX_OpenALSource_BIT_isVirtual : (OBJ)->stateBits & ~NIX_OpenALSource_BIT_isVirtual)
 
 //------
 //Recorder
@@ -278,6 +531,7 @@ typedef struct STNixOpenALRecorder_ {
     NixBOOL                 engStarted;
     STNixEngineRef          engRef;
     STNixRecorderRef        selfRef;
+    STNixEngineStatsState*  stats;  //engine's ('engRef' is retained)
     ALuint                  idCaptureAL;
     STNixAudioDesc          capFmt;
     //callback
@@ -304,6 +558,10 @@ typedef struct STNixOpenALRecorder_ {
             NixSI32         iCurSample; //at first buffer in 'reuse'
         } filling;
     } queues;
+    //counters (protected by queues.mutex, frames of cfg.fmt)
+    struct {
+        NixUI64             captured;
+    } counters;
 } STNixOpenALRecorder;
 
 void NixOpenALRecorder_init(STNixContextRef ctx, STNixOpenALRecorder* obj);
@@ -326,28 +584,98 @@ void NixOpenALEngine_init(STNixContextRef ctx, STNixOpenALEngine* obj){
     //
     NixContext_set(&obj->ctx, ctx);
     nixOpenALEngine_getApiItf(&obj->apiItf);
+    //oneShots
+    {
+        NixOneShots_init(obj->ctx, &obj->oneShots);
+    }
+    //clock
+    {
+        NixEngineClock_init(&obj->clock, NIX_ENGINE_CLOCK_RATE);
+    }
+    //stats
+    {
+        NixEngineStats_init(&obj->stats);
+    }
     //
     obj->deviceAL = NIX_OPENAL_NULL;
     obj->contextAL = NIX_OPENAL_NULL;
-    //srcs
+    //actv
+    {
+        obj->actv.mutex = NixContext_mutex_alloc(obj->ctx);
+    }
+    //pool
+    {
+        obj->pool.mutex = NixContext_mutex_alloc(obj->ctx);
+    }
+    //virt
     {
-        obj->srcs.mutex = NixContext_mutex_alloc(obj->ctx);
+        obj->virt.maxReal = NIX_VOICES_MAX;
+    }
+    //buffs
+    {
+        obj->buffs.mutex = NixContext_mutex_alloc(obj->ctx);
     }
 }
   
 void NixOpenALEngine_destroy(STNixOpenALEngine* obj){
+    //oneShots (released before sources cleanup)
+    NixOneShots_destroy(&obj->oneShots);
+    //events
+    NixOpenALEngine_eventsDisable(obj);
     //srcs
     {
         //cleanup
-        while(obj->srcs.arr != NULL && obj->srcs.use > 0){
+        while(obj->srcs.cur != NULL && obj->srcs.cur->use > 0){
             NixOpenALEngine_tick(obj, NIX_TRUE);
         }
         //
-        if(obj->srcs.arr != NULL){
-            NixContext_mfree(obj->ctx, obj->srcs.arr);
-            obj->srcs.arr = NULL;
+        if(obj->srcs.cur != NULL){
+            NixOpenALEngine_srcsRelease(obj, obj->srcs.cur);
+            obj->srcs.cur = NULL;
+        }
+    }
+    //actv
+    {
+        NIX_ASSERT(obj->actv.first == NULL && obj->actv.use == 0) //all sources should be removed
+        if(obj->actv.tick.arr != NULL){
+            NIX_RT_MFREE(obj->ctx, obj->actv.tick.arr);
+            obj->actv.tick.arr = NULL;
+        }
+        obj->actv.tick.use = obj->actv.tick.sz = 0;
+        NixMutex_free(&obj->actv.mutex);
+    }
+    //pool
+    {
+        if(obj->pool.arr != NULL){
+            NixUI32 i; for(i = 0; i < obj->pool.use; ++i){
+                STNixOpenALSource* src = obj->pool.arr[i];
+                NixOpenALSource_destroy(src);
+                NIX_RT_MFREE(obj->ctx, src);
+            }
+            NIX_RT_MFREE(obj->ctx, obj->pool.arr);
+            obj->pool.arr = NULL;
+        }
+        obj->pool.use = obj->pool.sz = 0;
+        NixMutex_free(&obj->pool.mutex);
+    }
+    //virt
+    {
+        if(obj->virt.arr != NULL){
+            NIX_RT_MFREE(obj->ctx, obj->virt.arr);
+            obj->virt.arr = NULL;
+        }
+        obj->virt.use = obj->virt.sz = 0;
+    }
+    //buffs (sources were destroyed, names are not queued anymore)
+    {
+        ++obj->buffs.gen;
+        NixOpenALEngine_buffsTrim(obj, 0);
+        if(obj->buffs.arr != NULL){
+            NIX_RT_MFREE(obj->ctx, obj->buffs.arr);
+            obj->buffs.arr = NULL;
         }
-        NixMutex_free(&obj->srcs.mutex);
+        obj->buffs.use = obj->buffs.sz = 0;
+        NixMutex_free(&obj->buffs.mutex);
     }
     //api
     if(alcMakeContextCurrent(NULL) == AL_FALSE){
@@ -369,56 +697,657 @@ void NixOpenALEngine_destroy(STNixOpenALEngine* obj){
     NixContext_null(&obj->ctx);
 }
 
+STNixOpenALSrcsSnap* NixOpenALEngine_srcsRetain(STNixOpenALEngine* obj){
+    STNixOpenALSrcsSnap* r = NULL;
+    //lock-free; 'readers' keeps writers from releasing the loaded snapshot before it is retained
+    NIX_ATOMIC_ADD32(&obj->srcs.readers, 1);
+    {
+        r = (STNixOpenALSrcsSnap*)NIX_ATOMIC_LOADPTR(&obj->srcs.cur);
+        if(r != NULL){
+            NIX_ATOMIC_ADD32(&r->retainCount, 1);
+        }
+    }
+    NIX_ATOMIC_SUB32(&obj->srcs.readers, 1);
+    return r;
+}
+
+void NixOpenALEngine_srcsRelease(STNixOpenALEngine* obj, STNixOpenALSrcsSnap* snap){
+    if(snap != NULL){
+        if(NIX_ATOMIC_SUB32(&snap->retainCount, 1) == 0){
+            NIX_RT_MFREE(obj->ctx, snap);
+        }
+    }
+}
+
+#define NIX_OPENAL_SRCS_SNAP_HASH(ID_AL)    ((NixUI32)(ID_AL) * 2654435761u) //Knuth's multiplicative
+
+struct STNixOpenALSource_* NixOpenALSrcsSnap_findByAL(const STNixOpenALSrcsSnap* obj, const ALuint idSourceAL){
+    STNixOpenALSource* r = NULL;
+    if(obj != NULL && idSourceAL != NIX_OPENAL_NULL){
+        NixUI32 i = NIX_OPENAL_SRCS_SNAP_HASH(idSourceAL) & obj->byAL.mask;
+        while(obj->byAL.arr[i] != NULL){ //at least one empty slot (load factor <= 0.5)
+            if(obj->byAL.arr[i]->idSourceAL == idSourceAL){
+                r = obj->byAL.arr[i];
+                break;
+            }
+            i = (i + 1) & obj->byAL.mask;
+        }
+    }
+    return r;
+}
+
+//Power of two, at least twice the sources (load factor <= 0.5).
+NixUI32 NixOpenALSrcsSnap_hashSzFor_(const NixUI32 use){
+    NixUI32 r = 8;
+    while(r < (use * 2)){
+        r *= 2;
+    }
+    return r;
+}
+
+//Builds a copy of the current snapshot, with or without 'src' (if 'add'), and publishes it.
+//Lock-free: the copy is built outside any lock and swapped only if its base is still current.
+//Note: a source's 'idSourceAL' does not change while it is in a snapshot.
+NixBOOL NixOpenALEngine_srcsPublish_(STNixOpenALEngine* obj, struct STNixOpenALSource_* src, const NixBOOL add){
+    NixBOOL r = NIX_FALSE, isDone = NIX_FALSE;
+    while(!isDone){
+        STNixOpenALSrcsSnap* cur = NixOpenALEngine_srcsRetain(obj); //base of the copy (retained, can't be reused while compared)
+        const NixUI32 curUse = (cur != NULL ? cur->use : 0);
+        const NixUI32 szN = (add ? curUse + 1 : curUse);
+        const NixUI32 hashSz = NixOpenALSrcsSnap_hashSzFor_(szN);
+        STNixOpenALSrcsSnap* snapN = (STNixOpenALSrcsSnap*)NixContext_malloc(obj->ctx, sizeof(STNixOpenALSrcsSnap) + (sizeof(STNixOpenALSource*) * (szN + hashSz)), "STNixOpenALEngine::srcs.snapN");
+        if(snapN == NULL){
+            NIX_PRINTF_ERROR("NixOpenALEngine_srcsPublish_::NixContext_malloc failed.\n");
+            isDone = NIX_TRUE;
+        } else {
+            NixUI32 i;
+            NixBOOL isChanged = NIX_FALSE;
+            snapN->retainCount = 1; //owned by the engine
+            snapN->use = 0;
+            snapN->arr = (STNixOpenALSource**)(snapN + 1);
+            snapN->byAL.arr = snapN->arr + szN;
+            snapN->byAL.mask = hashSz - 1;
+            memset(snapN->byAL.arr, 0, sizeof(STNixOpenALSource*) * hashSz);
+            for(i = 0; i < curUse; ++i){
+                if(cur->arr[i] != src){
+                    snapN->arr[snapN->use++] = cur->arr[i];
+                }
+            }
+            if(add){
+                snapN->arr[snapN->use++] = src;
+            }
+            //index
+            for(i = 0; i < snapN->use; ++i){
+                STNixOpenALSource* srcI = snapN->arr[i];
+                NixUI32 iSlot = NIX_OPENAL_SRCS_SNAP_HASH(srcI->idSourceAL) & snapN->byAL.mask;
+                while(snapN->byAL.arr[iSlot] != NULL){
+                    iSlot = (iSlot + 1) & snapN->byAL.mask;
+                }
+                snapN->byAL.arr[iSlot] = srcI;
+            }
+            isChanged = (add || snapN->use < curUse); //read before the swap (other writers can replace and release it)
+            //publish (readers retaining 'cur' keep it alive until released)
+            if(!NIX_ATOMIC_CASPTR(&obj->srcs.cur, cur, snapN)){
+                //other writer published first, retry from its snapshot
+                NIX_RT_MFREE(obj->ctx, snapN);
+            } else {
+                r = isChanged;
+                //wait for readers that loaded 'cur' but did not retain it yet (RMW, ordered after the swap)
+                while(NIX_ATOMIC_ADD32(&obj->srcs.readers, 0) != 0){
+                    NIX_CPU_RELAX();
+                }
+                NixOpenALEngine_srcsRelease(obj, cur); //engine's reference
+                isDone = NIX_TRUE;
+            }
+        }
+        NixOpenALEngine_srcsRelease(obj, cur);
+    }
+    return r;
+}
+
 NixBOOL NixOpenALEngine_srcsAdd(STNixOpenALEngine* obj, struct STNixOpenALSource_* src){
     NixBOOL r = NIX_FALSE;
-    if(obj != NULL){
-        NixMutex_lock(obj->srcs.mutex);
+    if(obj != NULL && src != NULL){
+        r = NixOpenALEngine_srcsPublish_(obj, src, NIX_TRUE);
+    }
+    return r;
+}
+
+NixBOOL NixOpenALEngine_srcsRemove(STNixOpenALEngine* obj, struct STNixOpenALSource_* src){
+    NixBOOL r = NIX_FALSE;
+    if(obj != NULL && src != NULL){
+        r = NixOpenALEngine_srcsPublish_(obj, src, NIX_FALSE);
+    }
+    return r;
+}
+
+void NixOpenALEngine_actvRemoveLocked_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    if(src->actv.isLinked){
+        if(src->actv.prev != NULL){
+            src->actv.prev->actv.next = src->actv.next;
+        } else {
+            NIX_ASSERT(obj->actv.first == src) //program logic error
+            obj->actv.first = src->actv.next;
+        }
+        if(src->actv.next != NULL){
+            src->actv.next->actv.prev = src->actv.prev;
+        }
+        src->actv.prev = src->actv.next = NULL;
+        src->actv.isLinked = NIX_FALSE;
+        NIX_ASSERT(obj->actv.use > 0) //program logic error
+        --obj->actv.use;
+    }
+}
+
+void NixOpenALEngine_actvAddLocked_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    if(!src->actv.isLinked){
+        src->actv.prev = NULL;
+        src->actv.next = obj->actv.first;
+        if(obj->actv.first != NULL){
+            obj->actv.first->actv.prev = src;
+        }
+        obj->actv.first = src;
+        src->actv.isLinked = NIX_TRUE;
+        ++obj->actv.use;
+    }
+}
+
+void NixOpenALEngine_actvAdd(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
+    {
+        NixOpenALEngine_actvAddLocked_(obj, src);
+    }
+    NixMutex_unlock(obj->actv.mutex);
+}
+
+//Moves the active list to 'actv.tick.arr'; sources flagged while ticking are linked for the next tick.
+void NixOpenALEngine_actvTakeForTick_(STNixOpenALEngine* obj){
+    obj->actv.tick.use = 0;
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
+    {
+        //resize array (if necesary)
+        if(obj->actv.tick.sz < obj->actv.use){
+            const NixUI32 szN = obj->actv.use + 4;
+            STNixOpenALSource** arrN = (STNixOpenALSource**)NixContext_mrealloc(obj->ctx, obj->actv.tick.arr, sizeof(STNixOpenALSource*) * szN, "STNixOpenALEngine::actv.tick.arrN");
+            if(arrN != NULL){
+                obj->actv.tick.arr = arrN;
+                obj->actv.tick.sz = szN;
+            }
+        }
+        //move
+        while(obj->actv.first != NULL && obj->actv.tick.use < obj->actv.tick.sz){
+            STNixOpenALSource* src = obj->actv.first;
+            NixOpenALEngine_actvRemoveLocked_(obj, src);
+            obj->actv.tick.arr[obj->actv.tick.use++] = src;
+        }
+    }
+    NixMutex_unlock(obj->actv.mutex);
+}
+
+void NixOpenALEngine_removeSrc_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    //unlink (could be re-flagged as active while ticking)
+    NIX_RT_MUTEX_LOCK(obj->actv.mutex);
+    {
+        NixOpenALEngine_actvRemoveLocked_(obj, src);
+    }
+    NixMutex_unlock(obj->actv.mutex);
+    //voices set (tick only)
+    NixOpenALEngine_virtUntrack_(obj, src);
+    //remove record (only tick reads snapshots, no other thread will reach this source)
+    if(!NixOpenALEngine_srcsRemove(obj, src)){
+        NIX_ASSERT(NIX_FALSE) //program logic error
+    }
+    //reuse or destroy
+    if(!NixOpenALEngine_poolReturn(obj, src)){
+        NixOpenALSource_destroy(src);
+        NIX_RT_MFREE(obj->ctx, src);
+    }
+}
+
+//pool
+
+STNixOpenALSource* NixOpenALEngine_srcCreate_(STNixOpenALEngine* obj){
+    STNixOpenALSource* r = NULL;
+    STNixOpenALSource* src = (STNixOpenALSource*)NixContext_malloc(obj->ctx, sizeof(STNixOpenALSource), "STNixOpenALSource");
+    if(src == NULL){
+        NIX_PRINTF_ERROR("NixOpenALEngine_srcCreate_::NixContext_malloc returned NULL\n");
+    } else {
+        ALenum errorAL;
+        NixOpenALSource_init(obj->ctx, src);
+        src->eng = obj;
+        alGenSources(1, &src->idSourceAL);
+        if(AL_NO_ERROR != (errorAL = alGetError())){
+            NIX_PRINTF_ERROR("alGenSources failed with error #%d\n", (NixSI32)errorAL);
+            src->idSourceAL = NIX_OPENAL_NULL;
+        } else {
+            r = src;
+            src = NULL; //consume
+        }
+        //release (if not consumed)
+        if(src != NULL){
+            NixOpenALSource_destroy(src);
+            NIX_RT_MFREE(obj->ctx, src);
+            src = NULL;
+        }
+    }
+    return r;
+}
+
+NixBOOL NixOpenALEngine_poolPush_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    NixBOOL r = NIX_FALSE;
+    NIX_RT_MUTEX_LOCK(obj->pool.mutex);
+    if(obj->pool.use < NIX_SOURCES_POOL_MAX){
+        //resize array (if necesary)
+        if(obj->pool.use >= obj->pool.sz){
+            const NixUI32 szN = obj->pool.use + NIX_SOURCES_GROWTH;
+            STNixOpenALSource** arrN = (STNixOpenALSource**)NixContext_mrealloc(obj->ctx, obj->pool.arr, sizeof(STNixOpenALSource*) * szN, "STNixOpenALEngine::pool.arrN");
+            if(arrN != NULL){
+                obj->pool.arr = arrN;
+                obj->pool.sz = szN;
+            }
+        }
+        //add
+        if(obj->pool.use < obj->pool.sz){
+            obj->pool.arr[obj->pool.use++] = src;
+            r = NIX_TRUE;
+        }
+    }
+    NixMutex_unlock(obj->pool.mutex);
+    return r;
+}
+
+NixUI32 NixOpenALEngine_poolGrow(STNixOpenALEngine* obj, const NixUI32 count){
+    NixUI32 r = 0;
+    while(r < count){
+        //create (outside the lock, calls the driver)
+        STNixOpenALSource* src = NixOpenALEngine_srcCreate_(obj);
+        if(src == NULL){
+            break;
+        } else if(!NixOpenALEngine_poolPush_(obj, src)){
+            NixOpenALSource_destroy(src);
+            NIX_RT_MFREE(obj->ctx, src);
+            break;
+        }
+        ++r;
+    }
+    return r;
+}
+
+STNixOpenALSource* NixOpenALEngine_poolPop(STNixOpenALEngine* obj){
+    STNixOpenALSource* r = NULL;
+    NixBOOL isGrown = NIX_FALSE;
+    do {
+        NIX_RT_MUTEX_LOCK(obj->pool.mutex);
+        if(obj->pool.use > 0){
+            r = obj->pool.arr[--obj->pool.use];
+        }
+        NixMutex_unlock(obj->pool.mutex);
+        //grow (once)
+        if(r != NULL || isGrown || NixOpenALEngine_poolGrow(obj, NIX_SOURCES_GROWTH) == 0){
+            break;
+        }
+        isGrown = NIX_TRUE;
+    } while(NIX_TRUE);
+    return r;
+}
+
+NixBOOL NixOpenALEngine_poolReturn(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    NixBOOL r = NIX_FALSE;
+    if(!NixOpenALSource_reset(src)){
+        //could not be reused
+    } else if(!NixOpenALEngine_poolPush_(obj, src)){
+        //pool is full
+    } else {
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//virt
+
+//Higher priority first, then louder, then real voices (avoids swapping equally audible sources).
+int NixOpenALEngine_virtCompare_(const void* pA, const void* pB){
+    const STNixOpenALSource* a = *(const STNixOpenALSource* const*)pA;
+    const STNixOpenALSource* b = *(const STNixOpenALSource* const*)pB;
+    if(a->virt.priority != b->virt.priority){
+        return (a->virt.priority > b->virt.priority ? -1 : 1);
+    } else if(a->volume != b->volume){
+        return (a->volume > b->volume ? -1 : 1);
+    } else if(NixOpenALSource_isVirtual(a) != NixOpenALSource_isVirtual(b)){
+        return (NixOpenALSource_isVirtual(a) ? 1 : -1);
+    }
+    return (a < b ? -1 : a > b ? 1 : 0);
+}
+
+//Adds a playing static source to the voices set (tick only).
+void NixOpenALEngine_virtTrack_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    if(!src->virt.isTracked){
+        //resize array (if necesary)
+        if(obj->virt.use >= obj->virt.sz){
+            const NixUI32 szN = obj->virt.use + NIX_SOURCES_GROWTH;
+            STNixOpenALSource** arrN = (STNixOpenALSource**)NixContext_mrealloc(obj->ctx, obj->virt.arr, sizeof(STNixOpenALSource*) * szN, "STNixOpenALEngine::virt.arrN");
+            if(arrN != NULL){
+                obj->virt.arr = arrN;
+                obj->virt.sz = szN;
+            }
+        }
+        //add
+        if(obj->virt.use < obj->virt.sz){
+            obj->virt.arr[obj->virt.use++] = src;
+            src->virt.isTracked = NIX_TRUE;
+        }
+    }
+}
+
+//Removes a source from the voices set (tick only).
+void NixOpenALEngine_virtUntrack_(STNixOpenALEngine* obj, STNixOpenALSource* src){
+    if(src->virt.isTracked){
+        NixUI32 i; for(i = 0; i < obj->virt.use; ++i){
+            if(obj->virt.arr[i] == src){
+                //fill gap with last record (sorted again by next tick)
+                obj->virt.arr[i] = obj->virt.arr[--obj->virt.use];
+                break;
+            }
+        }
+        src->virt.isTracked = NIX_FALSE;
+    }
+}
+
+//Walks the tracked sources only (played sources are tracked by tick when flagged as active).
+void NixOpenALEngine_virtTick_(STNixOpenALEngine* obj){
+    const NixUI32 maxReal = NIX_ATOMIC_LOAD32(&obj->virt.maxReal);
+    //seed (limit just enabled, sources could be already playing)
+    if(maxReal > 0 && !obj->virt.wasLimited){
+        STNixOpenALSrcsSnap* srcs = NixOpenALEngine_srcsRetain(obj);
+        if(srcs != NULL){
+            NixUI32 i; for(i = 0; i < srcs->use; ++i){
+                STNixOpenALSource* src = srcs->arr[i];
+                if(NixOpenALSource_isStatic(src) && !NixOpenALSource_isOrphan(src) && NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src)){
+                    NixOpenALEngine_virtTrack_(obj, src);
+                }
+            }
+            NixOpenALEngine_srcsRelease(obj, srcs);
+            srcs = NULL;
+        }
+    }
+    if(maxReal > 0 || obj->virt.wasLimited){
+        const NixUI64 usNow = NixClock_getMonotonicUs();
+        //prune (stopped, paused, or ended while virtual)
+        {
+            NixUI32 i = 0;
+            while(i < obj->virt.use){
+                STNixOpenALSource* src = obj->virt.arr[i];
+                NixBOOL keep = NIX_FALSE;
+                if(!NixOpenALSource_isStatic(src) || NixOpenALSource_isOrphan(src) || !NixOpenALSource_isPlaying(src) || NixOpenALSource_isPaused(src)){
+                    //not a candidate
+                } else if(NixOpenALSource_isVirtual(src)){
+                    if(NixOpenALSource_virtIsEnded(src, usNow)){
+                        NixOpenALSource_virtPromote(src, usNow, NIX_FALSE); //stops it
+                    } else {
+                        keep = NIX_TRUE;
+                    }
+                } else if(src->idSourceAL != NIX_OPENAL_NULL){
+                    ALint stateAL = 0;
+                    alGetSourcei(src->idSourceAL, AL_SOURCE_STATE, &stateAL); NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
+                    keep = (stateAL == AL_PLAYING);
+                }
+                if(keep){
+                    i++;
+                } else {
+                    src->virt.isTracked = NIX_FALSE;
+                    obj->virt.arr[i] = obj->virt.arr[--obj->virt.use];
+                }
+            }
+        }
+        //apply (top sources get real voices)
+        if(obj->virt.use > 0){
+            NixUI32 i;
+            qsort(obj->virt.arr, obj->virt.use, sizeof(obj->virt.arr[0]), NixOpenALEngine_virtCompare_);
+            for(i = 0; i < obj->virt.use; ++i){
+                STNixOpenALSource* src = obj->virt.arr[i];
+                if(maxReal == 0 || i < maxReal){
+                    if(NixOpenALSource_isVirtual(src)){
+                        NixOpenALSource_virtPromote(src, usNow, NIX_TRUE);
+                    }
+                } else if(!NixOpenALSource_isVirtual(src)){
+                    NixOpenALSource_virtDemote(src, usNow);
+                }
+            }
+        }
+        //not limited, stop tracking (seeded again when the limit is enabled)
+        if(maxReal == 0){
+            while(obj->virt.use > 0){
+                obj->virt.arr[--obj->virt.use]->virt.isTracked = NIX_FALSE;
+            }
+        }
+        obj->virt.wasLimited = (maxReal > 0);
+    }
+}
+
+//sched
+
+//Applies the due schedules of an active source, returns NIX_TRUE if a schedule is still pending (keep it active).
+NixBOOL NixOpenALEngine_schedTickSrc_(STNixOpenALEngine* obj, STNixOpenALSource* src, const NixUI64 usNow){
+    NixBOOL r = NIX_FALSE, isStartDue = NIX_FALSE, isStopDue = NIX_FALSE;
+    NIX_RT_MUTEX_LOCK(src->queues.mutex);
+    {
+        if(src->sched.startUs != 0 && src->sched.startUs <= usNow){
+            src->sched.startErr = NixEngineClock_usToFrames(&obj->clock, (NixSI64)(usNow - src->sched.startUs));
+            src->sched.isStartErrSet = NIX_TRUE;
+            src->sched.startUs = 0;
+            isStartDue = NIX_TRUE;
+        }
+        if(src->sched.stopUs != 0 && src->sched.stopUs <= usNow){
+            isStopDue = NIX_TRUE;
+        }
+        r = (!isStopDue && (src->sched.startUs != 0 || src->sched.stopUs != 0));
+    }
+    NixMutex_unlock(src->queues.mutex);
+    if(isStartDue){
+        nixOpenALSource_play(src->self);
+    }
+    if(isStopDue){
+        nixOpenALSource_stop(src->self); //clears the schedule
+    }
+    return r;
+}
+
+//buffs
+
+ALuint NixOpenALEngine_buffsAcquire(STNixOpenALEngine* obj, const ALenum fmtAL, const NixUI32 freq){
+    ALuint r = NIX_OPENAL_NULL;
+    //reuse (oldest compatible, or oldest released before this tick)
+    NIX_RT_MUTEX_LOCK(obj->buffs.mutex);
+    {
+        NixSI32 i, iFound = -1, iAny = -1;
+        for(i = 0; i < (NixSI32)obj->buffs.use; ++i){
+            const STNixOpenALBuffRec* rec = &obj->buffs.arr[i];
+            if(rec->gen != obj->buffs.gen){
+                if(rec->fmtAL == fmtAL && rec->freq == freq){
+                    iFound = i;
+                    break;
+                } else if(iAny < 0){
+                    iAny = i;
+                }
+            }
+        }
+        if(iFound < 0){
+            iFound = iAny;
+        }
+        if(iFound >= 0){
+            r = obj->buffs.arr[iFound].idBufferAL;
+            //fill gap
+            --obj->buffs.use;
+            for(i = iFound; i < (NixSI32)obj->buffs.use; ++i){
+                obj->buffs.arr[i] = obj->buffs.arr[i + 1];
+            }
+        }
+    }
+    NixMutex_unlock(obj->buffs.mutex);
+    //create
+    if(r == NIX_OPENAL_NULL){
+        ALenum errorAL;
+        alGenBuffers(1, &r);
+        if(AL_NONE != (errorAL = alGetError())){
+            NIX_PRINTF_ERROR("alGenBuffers failed: #%d '%s' idBufferAL(%d)\n", errorAL, alGetString(errorAL), r);
+            r = NIX_OPENAL_NULL;
+        }
+    }
+    return r;
+}
+
+void NixOpenALEngine_buffsRelease(STNixOpenALEngine* obj, const ALuint idBufferAL, const ALenum fmtAL, const NixUI32 freq){
+    if(idBufferAL != NIX_OPENAL_NULL){
+        NixBOOL added = NIX_FALSE;
+        NIX_RT_MUTEX_LOCK(obj->buffs.mutex);
         {
             //resize array (if necesary)
-            if(obj->srcs.use >= obj->srcs.sz){
-                const NixUI32 szN = obj->srcs.use + 4;
-                STNixOpenALSource** arrN = (STNixOpenALSource**)NixContext_mrealloc(obj->ctx, obj->srcs.arr, sizeof(STNixOpenALSource*) * szN, "STNixOpenALEngine::srcsN");
+            if(obj->buffs.use >= obj->buffs.sz){
+                const NixUI32 szN = obj->buffs.use + 4;
+                STNixOpenALBuffRec* arrN = (STNixOpenALBuffRec*)NixContext_mrealloc(obj->ctx, obj->buffs.arr, sizeof(STNixOpenALBuffRec) * szN, "STNixOpenALEngine::buffs.arrN");
                 if(arrN != NULL){
-                    obj->srcs.arr = arrN;
-                    obj->srcs.sz = szN;
+                    obj->buffs.arr = arrN;
+                    obj->buffs.sz = szN;
                 }
             }
             //add
-            if(obj->srcs.use >= obj->srcs.sz){
-                NIX_PRINTF_ERROR("nixOpenALSource_create::STNixOpenALEngine::srcs failed (no allocated space).\n");
+            if(obj->buffs.use < obj->buffs.sz){
+                STNixOpenALBuffRec* rec = &obj->buffs.arr[obj->buffs.use++];
+                rec->idBufferAL = idBufferAL;
+                rec->fmtAL      = fmtAL;
+                rec->freq       = freq;
+                rec->gen        = obj->buffs.gen;
+                added = NIX_TRUE;
+            }
+        }
+        NixMutex_unlock(obj->buffs.mutex);
+        //delete (no space in pool)
+        if(!added){
+            ALuint idBufferAL2 = idBufferAL;
+            NIX_PRINTF_ERROR("NixOpenALEngine_buffsRelease failed (no allocated space), deleting buffer.\n");
+            alDeleteBuffers(1, &idBufferAL2); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
+        }
+    }
+}
+
+//Deletes the oldest buffers released before the current tick-generation until 'maxUse' remain.
+void NixOpenALEngine_buffsTrim(STNixOpenALEngine* obj, const NixUI32 maxUse){
+    NIX_RT_MUTEX_LOCK(obj->buffs.mutex);
+    if(obj->buffs.use > maxUse){
+        NixUI32 i, delCount = 0;
+        while(delCount < (obj->buffs.use - maxUse) && obj->buffs.arr[delCount].gen != obj->buffs.gen){
+            STNixOpenALBuffRec* rec = &obj->buffs.arr[delCount];
+            alDeleteBuffers(1, &rec->idBufferAL); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
+            rec->idBufferAL = NIX_OPENAL_NULL;
+            ++delCount;
+        }
+        //fill gap
+        if(delCount > 0){
+            obj->buffs.use -= delCount;
+            for(i = 0; i < obj->buffs.use; ++i){
+                obj->buffs.arr[i] = obj->buffs.arr[i + delCount];
+            }
+        }
+    }
+    NixMutex_unlock(obj->buffs.mutex);
+}
+
+//events
+
+void AL_APIENTRY NixOpenALEngine_eventCallback_(ALenum eventType, ALuint object, ALuint param, ALsizei length, const ALchar* message, void* userParam){
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)userParam;
+    if(obj != NULL && (eventType == AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT || eventType == AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT)){
+        //Note: called from the AL event thread, must not lock nor allocate.
+        const NixUI32 iWrite = NIX_ATOMIC_LOAD32(&obj->events.iWrite);
+        const NixUI32 iRead = NIX_ATOMIC_LOAD32(&obj->events.iRead);
+        if((iWrite - iRead) >= NIX_OPENAL_EVENTS_QUEUE_SZ){
+            NIX_ATOMIC_ADD32(&obj->events.overflows, 1);
+        } else {
+            STNixOpenALEvent* e = &obj->events.arr[iWrite & (NIX_OPENAL_EVENTS_QUEUE_SZ - 1)];
+            e->type         = eventType;
+            e->idSourceAL   = object;
+            e->param        = param;
+            NIX_ATOMIC_STORE32(&obj->events.iWrite, iWrite + 1);
+        }
+    }
+}
+
+NixBOOL NixOpenALEngine_eventsEnable(STNixOpenALEngine* obj){
+    NixBOOL r = NIX_FALSE;
+    if(obj->events.isEnabled){
+        r = NIX_TRUE;
+    } else if(alIsExtensionPresent("AL_SOFT_events") == AL_FALSE){
+        //not supported, tick will poll AL_BUFFERS_PROCESSED
+    } else {
+        obj->events.alEventControlSOFT  = (LPALEVENTCONTROLSOFT)alGetProcAddress("alEventControlSOFT");
+        obj->events.alEventCallbackSOFT = (LPALEVENTCALLBACKSOFT)alGetProcAddress("alEventCallbackSOFT");
+        if(obj->events.alEventControlSOFT == NULL || obj->events.alEventCallbackSOFT == NULL){
+            NIX_PRINTF_WARNING("NixOpenALEngine_eventsEnable::alGetProcAddress failed, polling sources instead.\n");
+        } else {
+            ALenum errorAL;
+            const ALenum types[] = { AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT };
+            obj->events.iWrite = obj->events.iRead = obj->events.overflows = 0;
+            (*obj->events.alEventCallbackSOFT)(NixOpenALEngine_eventCallback_, obj);
+            (*obj->events.alEventControlSOFT)((ALsizei)(sizeof(types) / sizeof(types[0])), types, AL_TRUE);
+            if(AL_NO_ERROR != (errorAL = alGetError())){
+                NIX_PRINTF_WARNING("NixOpenALEngine_eventsEnable::alEventControlSOFT failed: #%d '%s', polling sources instead.\n", errorAL, alGetString(errorAL));
+                (*obj->events.alEventCallbackSOFT)(NULL, NULL);
             } else {
-                //become the owner of the pair
-                obj->srcs.arr[obj->srcs.use++] = src;
+                obj->events.isEnabled = NIX_TRUE;
                 r = NIX_TRUE;
             }
         }
-        NixMutex_unlock(obj->srcs.mutex);
     }
     return r;
 }
 
-void NixOpenALEngine_removeSrcRecordLocked_(STNixOpenALEngine* obj, NixSI32* idx){
-    STNixOpenALSource* src = obj->srcs.arr[*idx];
-    if(src != NULL){
-        NixOpenALSource_destroy(src);
-        NixContext_mfree(obj->ctx, src);
+void NixOpenALEngine_eventsDisable(STNixOpenALEngine* obj){
+    if(obj->events.isEnabled){
+        const ALenum types[] = { AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT };
+        (*obj->events.alEventControlSOFT)((ALsizei)(sizeof(types) / sizeof(types[0])), types, AL_FALSE); NIX_OPENAL_ERR_VERIFY("alEventControlSOFT");
+        (*obj->events.alEventCallbackSOFT)(NULL, NULL); NIX_OPENAL_ERR_VERIFY("alEventCallbackSOFT");
+        obj->events.isEnabled = NIX_FALSE;
     }
-    //fill gap
-    --obj->srcs.use;
-    {
-        NixUI32 i2;
-        for(i2 = *idx; i2 < obj->srcs.use; ++i2){
-            obj->srcs.arr[i2] = obj->srcs.arr[i2 + 1];
+}
+
+//Flags as active the sources with events, or all of them if events were lost.
+void NixOpenALEngine_eventsDrain_(STNixOpenALEngine* obj, const STNixOpenALSrcsSnap* srcs){
+    NixBOOL r = NIX_TRUE;
+    if(obj->events.isEnabled){
+        const NixUI32 iWrite = NIX_ATOMIC_LOAD32(&obj->events.iWrite);
+        NixUI32 iRead = obj->events.iRead;
+        r = NIX_FALSE;
+        //overflows (events were lost)
+        if(NIX_ATOMIC_LOAD32(&obj->events.overflows) != 0){
+            NIX_ATOMIC_STORE32(&obj->events.overflows, 0);
+            r = NIX_TRUE;
+        }
+        //flag sources
+        while(iRead != iWrite){
+            const STNixOpenALEvent* e = &obj->events.arr[iRead & (NIX_OPENAL_EVENTS_QUEUE_SZ - 1)];
+            if(!r){
+                STNixOpenALSource* src = NixOpenALSrcsSnap_findByAL(srcs, e->idSourceAL);
+                if(src != NULL){
+                    NixOpenALEngine_actvAdd(obj, src);
+                }
+            }
+            ++iRead;
+        }
+        NIX_ATOMIC_STORE32(&obj->events.iRead, iRead);
+    }
+    //poll all (stream sources are linked after queueing buffers, this only covers lost events)
+    if(r && obj->events.isEnabled){
+        NixUI32 i; for(i = 0; i < srcs->use; ++i){
+            NixOpenALEngine_actvAdd(obj, srcs->arr[i]);
         }
     }
-    *idx = *idx - 1; //process record again
 }
 
 void NixOpenALEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNixOpenALSource* src){
     if(src->queues.notify.use > 0){
         NixSI32 i; for(i = 0; i < src->queues.notify.use; i++){
             STNixOpenALQueuePair* pair = &src->queues.notify.arr[i];
-            if(!NixNotifQueue_addBuff(notifs, src->self, src->queues.callback, pair->org)){
+            if(!NixNotifQueue_addBuffMove(notifs, src->self, src->queues.callback, &pair->org)){
                 NIX_ASSERT(NIX_FALSE); //program logic error
             }
         }
@@ -430,36 +1359,46 @@ void NixOpenALEngine_tick_addQueueNotifSrcLocked_(STNixNotifQueue* notifs, STNix
 
 void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup){
     if(obj != NULL){
+        const NixUI64 nsStart = NixClock_getMonotonicNs();
+        NixUI32 buffsNotified = 0;
+        NIX_TRACE_BEGIN(trTick);
         //srcs
         {
             STNixNotifQueue notifs;
             NixNotifQueue_init(obj->ctx, &notifs);
-            NixMutex_lock(obj->srcs.mutex);
-            if(obj->srcs.arr != NULL && obj->srcs.use > 0){
-                //NIX_PRINTF_INFO("NixOpenALEngine_tick::%d sources.\n", obj->srcs.use);
-                NixSI32 i; for(i = 0; i < (NixSI32)obj->srcs.use; ++i){
-                    STNixOpenALSource* src = obj->srcs.arr[i];
-                    //NIX_PRINTF_INFO("NixOpenALEngine_tick::source(#%d/%d).\n", i + 1, obj->srcs.use);
-                    if(NixOpenALSource_isOrphan(src)){
-                        //src
-                        if(src->idSourceAL != NIX_OPENAL_NULL){
-                            alSourceStop(src->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourceStop");
-                            alDeleteSources(1, &src->idSourceAL); NIX_OPENAL_ERR_VERIFY("alDeleteSources");
-                            src->idSourceAL = NIX_OPENAL_NULL;
+            //flag sources (snapshot, no lock is held while ticking)
+            {
+                STNixOpenALSrcsSnap* srcs = NixOpenALEngine_srcsRetain(obj);
+                if(srcs != NULL){
+                    NixOpenALEngine_eventsDrain_(obj, srcs);
+                    if(isFinalCleanup){
+                        NixUI32 i; for(i = 0; i < srcs->use; ++i){
+                            NixOpenALEngine_actvAdd(obj, srcs->arr[i]);
                         }
                     }
-                    if(src->idSourceAL == NIX_OPENAL_NULL){
-                        //remove
-                        //NIX_PRINTF_INFO("NixOpenALEngine_tick::source(#%d/%d); remove-NULL.\n", i + 1, obj->srcs.use);
-                        NixOpenALEngine_removeSrcRecordLocked_(obj, &i);
+                    NixOpenALEngine_srcsRelease(obj, srcs);
+                    srcs = NULL;
+                }
+            }
+            NixOpenALEngine_actvTakeForTick_(obj);
+            {
+                const NixUI64 usTick = NixClock_getMonotonicUs(); //for the schedules
+                //NIX_PRINTF_INFO("NixOpenALEngine_tick::%d sources.\n", obj->actv.tick.use);
+                NixUI32 i; for(i = 0; i < obj->actv.tick.use; ++i){
+                    STNixOpenALSource* src = obj->actv.tick.arr[i];
+                    //NIX_PRINTF_INFO("NixOpenALEngine_tick::source(#%d/%d).\n", i + 1, obj->actv.tick.use);
+                    if(NixOpenALSource_isOrphan(src) || src->idSourceAL == NIX_OPENAL_NULL){
+                        //remove (returned to engine's pool or destroyed)
+                        //NIX_PRINTF_INFO("NixOpenALEngine_tick::source(#%d/%d); remove.\n", i + 1, obj->actv.tick.use);
+                        NixOpenALEngine_removeSrc_(obj, src);
                         src = NULL;
-                    } else if(!NixOpenALSource_isOrphan(src)){
+                    } else {
                         //remove processed buffers
-                        if(src != NULL && !NixOpenALSource_isStatic(src)){
+                        if(src != NULL && !NixOpenALSource_isStatic(src) && !NixOpenALSource_isRender(src)){
                             ALint csmdAmm = 0;
                             alGetSourceiv(src->idSourceAL, AL_BUFFERS_PROCESSED, &csmdAmm); NIX_OPENAL_ERR_VERIFY("alGetSourceiv(AL_BUFFERS_PROCESSED)");
                             if(csmdAmm > 0){
-                                NixMutex_lock(src->queues.mutex);
+                                NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                 {
                                     NIX_ASSERT(csmdAmm <= src->queues.pend.use) //Just checking, this should be always be true
                                     while(csmdAmm > 0){
@@ -469,6 +1408,10 @@ void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup){
                                         }
                                         --csmdAmm;
                                     }
+                                    //underrun (queue drained while playing)
+                                    if(src->queues.pend.use == 0 && NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src)){
+                                        NixEngineStats_addUnderrun(&obj->stats);
+                                    }
                                 }
                                 NixMutex_unlock(src->queues.mutex);
                             }
@@ -477,17 +1420,54 @@ void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup){
                         if(src != NULL){
                             //add to notify queue
                             {
-                                NixMutex_lock(src->queues.mutex);
+                                NixBOOL isActive = NIX_FALSE;
+                                NIX_RT_MUTEX_LOCK(src->queues.mutex);
                                 {
                                     NixOpenALEngine_tick_addQueueNotifSrcLocked_(&notifs, src);
+                                    //keep polling stream sources if no events will be received
+                                    isActive = (!obj->events.isEnabled && !NixOpenALSource_isStatic(src) && src->queues.pend.use > 0);
+                                    //low watermark (polled while playing)
+                                    if(!NixOpenALSource_isStatic(src) && NixSourceWatermark_isEnabled(&src->wmark) && NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src)){
+                                        const NixUI32 queued = NixOpenALSource_getQueuedBlocksLocked_(src);
+                                        NixUI32 deficit = 0;
+                                        if(NixSourceWatermark_check(&src->wmark, &src->buffsFmt, queued, &deficit)){
+                                            NixNotifQueue_addNeedsData(&notifs, src->self, &src->wmark, queued, deficit);
+                                        }
+                                        isActive = NIX_TRUE;
+                                    }
                                 }
                                 NixMutex_unlock(src->queues.mutex);
+                                //render ring (only tick touches it: unqueued after stops, filled and started on play, refilled while playing, restarted if starved)
+                                if(NixOpenALSource_isRenderRing(src)){
+                                    if(NIX_ATOMIC_XCHG32(&src->render.flushPend, 0) != 0){
+                                        NixOpenALSource_renderUnqueue_(src, NIX_FALSE);
+                                    }
+                                    if(NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src)){
+                                        ALint sourceState = AL_STOPPED;
+                                        NixOpenALSource_renderRefill_(src);
+                                        alGetSourcei(src->idSourceAL, AL_SOURCE_STATE, &sourceState); NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
+                                        if(sourceState != AL_PLAYING){
+                                            alSourcePlay(src->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourcePlay");
+                                        }
+                                        isActive = NIX_TRUE;
+                                    }
+                                }
+                                //sched (scheduled starts/stops)
+                                if(!isFinalCleanup && NixOpenALEngine_schedTickSrc_(obj, src, usTick)){
+                                    isActive = NIX_TRUE;
+                                }
+                                if(isActive){
+                                    NixOpenALEngine_actvAdd(obj, src);
+                                }
+                                //voices limit (played static sources compete for real voices)
+                                if(NixOpenALSource_isStatic(src) && NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src) && NIX_ATOMIC_LOAD32(&obj->virt.maxReal) > 0){
+                                    NixOpenALEngine_virtTrack_(obj, src);
+                                }
                             }
                         }
                     }
                 }
             }
-            NixMutex_unlock(obj->srcs.mutex);
             //notify (unloked)
             if(notifs.use > 0){
                 //NIX_PRINTF_INFO("NixOpenALEngine_tick::notify %d.\n", notifs.use);
@@ -496,13 +1476,38 @@ void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup){
                     STNixSourceNotif* n = &notifs.arr[i];
                     //NIX_PRINTF_INFO("NixOpenALEngine_tick::notify(#%d/%d).\n", i + 1, notifs.use);
                     if(n->callback.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*n->callback.func)(&n->source, n->buffs, n->buffsUse, n->callback.data);
+                        NIX_TRACE_END(trCall, "srcCallback", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
+                    }
+                    if(n->needs.func != NULL){
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
+                        (*n->needs.func)(&n->source, n->needs.queued, n->needs.deficit, n->needs.data);
+                        NIX_TRACE_END(trCall, "srcNeedsData", n->source.ptr);
+                        NixEngineStats_addCallback(&obj->stats, NixClock_getMonotonicNs() - nsCall);
                     }
+                    buffsNotified += n->buffsUse;
                 }
             }
             //NIX_PRINTF_INFO("NixOpenALEngine_tick::NixNotifQueue_destroy.\n");
             NixNotifQueue_destroy(&notifs);
         }
+        //virt (voices limit)
+        if(!isFinalCleanup){
+            NixOpenALEngine_virtTick_(obj);
+        }
+        //buffs (names released in previous ticks are safe to reuse or delete)
+        {
+            NixOpenALEngine_buffsTrim(obj, (isFinalCleanup ? 0 : NIX_OPENAL_BUFFERS_POOL_MAX));
+            NIX_RT_MUTEX_LOCK(obj->buffs.mutex);
+            {
+                ++obj->buffs.gen;
+            }
+            NixMutex_unlock(obj->buffs.mutex);
+        }
         //recorder
         if(obj->rec != NULL){
             //Note: when the capture is stopped, ALC_CAPTURE_SAMPLES returns the maximun size instead of the captured-only size.
@@ -511,6 +1516,11 @@ void NixOpenALEngine_tick(STNixOpenALEngine* obj, const NixBOOL isFinalCleanup){
             }
             NixOpenALRecorder_notifyBuffers(obj->rec, NIX_FALSE);
         }
+        NIX_TRACE_END(trTick, "tick", obj);
+        //stats
+        NixEngineStats_addTick(&obj->stats, NixClock_getMonotonicNs() - nsStart, buffsNotified);
+        //log (messages queued by this tick and the device threads)
+        NixLog_flush();
     }
 }
 
@@ -537,9 +1547,10 @@ void NixOpenALQueuePair_destroy(STNixOpenALQueuePair* obj){
 }
 
 void NixOpenALQueuePair_moveOrg(STNixOpenALQueuePair* obj, STNixOpenALQueuePair* to){
-    NixBuffer_set(&to->org, obj->org);
-    NixBuffer_release(&obj->org);
-    NixBuffer_null(&obj->org);
+    if(!NixBuffer_isNull(to->org)){
+        NixBuffer_release(&to->org);
+    }
+    to->org = NixBuffer_move(&obj->org);
 }
 
 void NixOpenALQueuePair_moveCnv(STNixOpenALQueuePair* obj, STNixOpenALQueuePair* to){
@@ -566,7 +1577,7 @@ void NixOpenALQueue_destroy(STNixOpenALQueue* obj){
             STNixOpenALQueuePair* b = &obj->arr[i];
             NixOpenALQueuePair_destroy(b);
         }
-        NixContext_mfree(obj->ctx, obj->arr);
+        NIX_RT_MFREE(obj->ctx, obj->arr);
         obj->arr = NULL;
     }
     obj->use = obj->sz = 0;
@@ -682,8 +1693,8 @@ void NixOpenALSource_init(STNixContextRef ctx, STNixOpenALSource* obj){
         obj->queues.mutex = NixContext_mutex_alloc(obj->ctx);
         NixOpenALQueue_init(ctx, &obj->queues.notify);
         NixOpenALQueue_init(ctx, &obj->queues.pend);
-        NixOpenALQueue_init(ctx, &obj->queues.reuse);
     }
+    NixSourceRender_init(ctx, &obj->render.core);
 }
 
 void NixOpenALSource_destroy(STNixOpenALSource* obj){
@@ -697,7 +1708,7 @@ void NixOpenALSource_destroy(STNixOpenALSource* obj){
     {
         {
             if(obj->queues.conv.buff.ptr != NULL){
-                NixContext_mfree(obj->ctx, obj->queues.conv.buff.ptr);
+                NIX_RT_MFREE(obj->ctx, obj->queues.conv.buff.ptr);
                 obj->queues.conv.buff.ptr = NULL;
             }
             obj->queues.conv.buff.sz = 0;
@@ -706,17 +1717,134 @@ void NixOpenALSource_destroy(STNixOpenALSource* obj){
             NixFmtConverter_free(obj->queues.conv.obj);
             obj->queues.conv.obj = NULL;
         }
+        //return AL buffers to engine's pool (source was deleted, buffers are not attached anymore)
+        if(obj->eng != NULL){
+            NixUI32 i; for(i = 0; i < obj->queues.pend.use; i++){
+                STNixOpenALQueuePair* pair = &obj->queues.pend.arr[i];
+                NixOpenALEngine_buffsRelease(obj->eng, pair->idBufferAL, obj->srcFmtAL, obj->srcFmt.samplerate);
+                pair->idBufferAL = NIX_OPENAL_NULL;
+            }
+        }
         NixOpenALQueue_destroy(&obj->queues.pend);
-        NixOpenALQueue_destroy(&obj->queues.reuse);
         NixOpenALQueue_destroy(&obj->queues.notify);
         NixMutex_free(&obj->queues.mutex);
     }
+    //render
+    NixOpenALSource_renderRelease_(obj);
+    NixSourceRender_destroy(&obj->render.core);
     NixContext_release(&obj->ctx);
     NixContext_null(&obj->ctx);
 }
 
-NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBufferRef pBuff, const NixBOOL isStream){
+NixBOOL NixOpenALSource_reset(STNixOpenALSource* obj){
+    NixBOOL r = NIX_FALSE;
+    if(obj->idSourceAL != NIX_OPENAL_NULL){
+        ALenum errorAL;
+        alSourceStop(obj->idSourceAL);
+        alSourcei(obj->idSourceAL, AL_BUFFER, AL_NONE); //detaches static and queued buffers
+        alSourcei(obj->idSourceAL, AL_LOOPING, AL_FALSE);
+        alSourcef(obj->idSourceAL, AL_GAIN, 1.f);
+        alSourceRewind(obj->idSourceAL);
+        if(AL_NO_ERROR != (errorAL = alGetError())){
+            NIX_PRINTF_ERROR("NixOpenALSource_reset failed: #%d '%s'\n", errorAL, alGetString(errorAL));
+        } else {
+            //queues
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                //return AL buffers to engine's pool (detached above)
+                if(obj->eng != NULL){
+                    NixUI32 i; for(i = 0; i < obj->queues.pend.use; i++){
+                        STNixOpenALQueuePair* pair = &obj->queues.pend.arr[i];
+                        NixOpenALEngine_buffsRelease(obj->eng, pair->idBufferAL, obj->srcFmtAL, obj->srcFmt.samplerate);
+                        pair->idBufferAL = NIX_OPENAL_NULL;
+                    }
+                }
+                NixOpenALQueue_flush(&obj->queues.pend);
+                NixOpenALQueue_flush(&obj->queues.notify);
+                obj->queues.pendBlockIdx = 0;
+                memset(&obj->queues.callback, 0, sizeof(obj->queues.callback));
+                //conv
+                if(obj->queues.conv.buff.ptr != NULL){
+                    NIX_RT_MFREE(obj->ctx, obj->queues.conv.buff.ptr);
+                    obj->queues.conv.buff.ptr = NULL;
+                }
+                obj->queues.conv.buff.sz = 0;
+                if(obj->queues.conv.obj != NULL){
+                    NixFmtConverter_free(obj->queues.conv.obj);
+                    obj->queues.conv.obj = NULL;
+                }
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            //render (detached above)
+            NixOpenALSource_renderRelease_(obj);
+            //props
+            memset(&obj->buffsFmt, 0, sizeof(obj->buffsFmt));
+            memset(&obj->srcFmt, 0, sizeof(obj->srcFmt));
+            obj->srcFmtAL   = 0;
+            obj->volume     = 1.f;
+            obj->stateBits  = 0;
+            memset(&obj->virt, 0, sizeof(obj->virt));
+            memset(&obj->sched, 0, sizeof(obj->sched));
+            memset(&obj->counters, 0, sizeof(obj->counters));
+            memset(&obj->wmark, 0, sizeof(obj->wmark));
+            NixSource_null(&obj->self);
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+void NixOpenALSource_virtDemote(STNixOpenALSource* obj, const NixUI64 usNow){
+    if(obj->idSourceAL != NIX_OPENAL_NULL && !NixOpenALSource_isVirtual(obj)){
+        ALint offset = 0, bytes = 0, bits = 0, chans = 0;
+        alGetSourcei(obj->idSourceAL, AL_SAMPLE_OFFSET, &offset); NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SAMPLE_OFFSET)");
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        if(obj->queues.pend.use > 0 && obj->queues.pend.arr[0].idBufferAL != NIX_OPENAL_NULL){
+            const ALuint idBufferAL = obj->queues.pend.arr[0].idBufferAL;
+            alGetBufferi(idBufferAL, AL_SIZE, &bytes);
+            alGetBufferi(idBufferAL, AL_BITS, &bits);
+            alGetBufferi(idBufferAL, AL_CHANNELS, &chans);
+            NIX_OPENAL_ERR_VERIFY("alGetBufferi");
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        alSourcePause(obj->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourcePause");
+        obj->virt.blockStart = (NixUI32)(offset > 0 ? offset : 0);
+        obj->virt.blocksLen = (bits > 0 && chans > 0 ? (NixUI32)bytes / ((NixUI32)bits / 8 * (NixUI32)chans) : 0);
+        obj->virt.usStart   = usNow;
+        NixOpenALSource_setIsVirtual(obj, NIX_TRUE);
+    }
+}
+
+#define NixOpenALSource_virtBlocksAt_(OBJ, US_NOW)  ((OBJ)->virt.blockStart + ((US_NOW) - (OBJ)->virt.usStart) * (OBJ)->srcFmt.samplerate / 1000000ull)
+
+NixBOOL NixOpenALSource_virtIsEnded(const STNixOpenALSource* obj, const NixUI64 usNow){
+    return (NixOpenALSource_isVirtual(obj) && !NixOpenALSource_isRepeat(obj) && obj->virt.blocksLen > 0 && NixOpenALSource_virtBlocksAt_(obj, usNow) >= obj->virt.blocksLen);
+}
+
+void NixOpenALSource_virtPromote(STNixOpenALSource* obj, const NixUI64 usNow, const NixBOOL resume){
+    if(NixOpenALSource_isVirtual(obj)){
+        //advance position with the clock
+        const NixUI64 blocks = NixOpenALSource_virtBlocksAt_(obj, usNow);
+        NixOpenALSource_setIsVirtual(obj, NIX_FALSE);
+        if(obj->idSourceAL == NIX_OPENAL_NULL || obj->virt.blocksLen == 0){
+            //nothing to resume
+        } else if(blocks >= obj->virt.blocksLen && !NixOpenALSource_isRepeat(obj)){
+            //ended while virtual
+            alSourceStop(obj->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourceStop");
+            NixOpenALSource_setIsPlaying(obj, NIX_FALSE);
+        } else {
+            alSourcei(obj->idSourceAL, AL_SAMPLE_OFFSET, (ALint)(blocks % obj->virt.blocksLen)); NIX_OPENAL_ERR_VERIFY("alSourcei(AL_SAMPLE_OFFSET)");
+            if(resume){
+                alSourcePlay(obj->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourcePlay");
+            }
+        }
+    }
+}
+
+//Converts (if necesary) and uploads the buffer's data into a new or reused AL buffer.
+NixBOOL NixOpenALSource_fillPairForOutput_(STNixOpenALSource* obj, STNixBufferRef pBuff, STNixOpenALQueuePair* dst){
     NixBOOL r = NIX_FALSE;
+    NIX_TRACE_BEGIN(trUpload);
     if(pBuff.ptr != NULL){
         STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pBuff.ptr);
         if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
@@ -738,7 +1866,7 @@ NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBuffer
                     void* cnvBuffN = (void*)NixContext_malloc(obj->ctx, buffConvSz, "cnvBuffSzN");
                     if(cnvBuffN != NULL){
                         if(obj->queues.conv.buff.ptr != NULL){
-                            NixContext_mfree(obj->ctx, obj->queues.conv.buff.ptr);
+                            NIX_RT_MFREE(obj->ctx, obj->queues.conv.buff.ptr);
                             obj->queues.conv.buff.ptr = NULL;
                         }
                         obj->queues.conv.buff.ptr = cnvBuffN;
@@ -747,7 +1875,7 @@ NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBuffer
                 }
                 //convert
                 if(buffConvSz > obj->queues.conv.buff.sz){
-                    NIX_PRINTF_ERROR("NixOpenALSource_queueBufferForOutput, could not allocate conversion buffer.\n");
+                    NIX_PRINTF_ERROR("NixOpenALSource_fillPairForOutput_, could not allocate conversion buffer.\n");
                 } else if(!NixFmtConverter_setPtrAtSrcInterlaced(obj->queues.conv.obj, &buff->desc, buff->ptr, 0)){
                     NIX_PRINTF_ERROR("NixFmtConverter_setPtrAtSrcInterlaced, failed.\n");
                 } else if(!NixFmtConverter_setPtrAtDstInterlaced(obj->queues.conv.obj, &obj->srcFmt, obj->queues.conv.buff.ptr, 0)){
@@ -758,7 +1886,7 @@ NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBuffer
                     NixUI32 ammBlocksRead = 0;
                     NixUI32 ammBlocksWritten = 0;
                     if(!NixFmtConverter_convert(obj->queues.conv.obj, srcBlocks, dstBlocks, &ammBlocksRead, &ammBlocksWritten)){
-                        NIX_PRINTF_ERROR("NixOpenALSource_queueBufferForOutput::NixFmtConverter_convert failed from(%uhz, %uch, %dbit-%s) to(%uhz, %uch, %dbit-%s).\n"
+                        NIX_PRINTF_ERROR("NixOpenALSource_fillPairForOutput_::NixFmtConverter_convert failed from(%uhz, %uch, %dbit-%s) to(%uhz, %uch, %dbit-%s).\n"
                                          , obj->buffsFmt.samplerate
                                          , obj->buffsFmt.channels
                                          , obj->buffsFmt.bitsPerSample
@@ -777,97 +1905,178 @@ NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBuffer
             }
             //
             if(data != NULL && dataSz > 0){
-                STNixOpenALQueuePair pair;
-                NixOpenALQueuePair_init(&pair);
-                //reuse or create bufferAL
-                {
-                    STNixOpenALQueuePair reuse;
-                    if(!NixOpenALQueue_popOrphaning(&obj->queues.reuse, &reuse)){
-                        //no reusable buffer available, create new
-                        ALenum errorAL;
-                        alGenBuffers(1, &pair.idBufferAL);
-                        if(AL_NONE != (errorAL = alGetError())){
-                            NIX_PRINTF_ERROR("alGenBuffers failed: #%d '%s' idBufferAL(%d)\n", errorAL, alGetString(errorAL), pair.idBufferAL);
-                            pair.idBufferAL = NIX_OPENAL_NULL;
-                        }
-                    } else {
-                        //reuse buffer
-                        NIX_ASSERT(reuse.org.ptr == NULL) //program logic error
-                        NIX_ASSERT(reuse.idBufferAL != NIX_OPENAL_NULL) //program logic error
-                        if(reuse.idBufferAL == NIX_OPENAL_NULL){
-                            NIX_PRINTF_ERROR("NixOpenALSource_queueBufferForOutput::reuse.cnv should not be NULL.\n");
-                        } else {
-                            pair.idBufferAL = reuse.idBufferAL; reuse.idBufferAL = NIX_OPENAL_NULL; //consume
-                        }
-                        NixOpenALQueuePair_destroy(&reuse);
-                    }
-                }
+                //reuse or create bufferAL (engine's pool)
+                dst->idBufferAL = NixOpenALEngine_buffsAcquire(obj->eng, obj->srcFmtAL, dataFmt.samplerate);
                 //populate bufferAL
-                if(pair.idBufferAL != NIX_OPENAL_NULL){
+                if(dst->idBufferAL != NIX_OPENAL_NULL){
                     ALenum errorAL;
-                    alBufferData(pair.idBufferAL, obj->srcFmtAL, data, dataSz, dataFmt.samplerate);
+                    alBufferData(dst->idBufferAL, obj->srcFmtAL, data, dataSz, dataFmt.samplerate);
                     if(AL_NONE != (errorAL = alGetError())){
-                        NIX_PRINTF_ERROR("alBufferData failed: #%d '%s' idBufferAL(%d)\n", errorAL, alGetString(errorAL), pair.idBufferAL);
-                        alDeleteBuffers(1, &pair.idBufferAL); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
-                        pair.idBufferAL = NIX_OPENAL_NULL;
+                        NIX_PRINTF_ERROR("alBufferData failed: #%d '%s' idBufferAL(%d)\n", errorAL, alGetString(errorAL), dst->idBufferAL);
+                        alDeleteBuffers(1, &dst->idBufferAL); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
+                        dst->idBufferAL = NIX_OPENAL_NULL;
+                    } else {
+                        r = NIX_TRUE;
+                    }
+                }
+            }
+        }
+    }
+    NIX_TRACE_END(trUpload, "upload", obj->self.ptr);
+    return r;
+}
+
+NixBOOL NixOpenALSource_queueBufferForOutput(STNixOpenALSource* obj, STNixBufferRef pBuff, const NixBOOL isStream, const NixBOOL isMove){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALQueuePair pair;
+    NixOpenALQueuePair_init(&pair);
+    if(NixOpenALSource_fillPairForOutput_(obj, pBuff, &pair)){
+        r = NIX_TRUE;
+        //link buffer to source
+        {
+            if(isStream){
+                //queue buffer
+                ALenum errorAL;
+                alSourceQueueBuffers(obj->idSourceAL, 1, &pair.idBufferAL);
+                if(AL_NONE != (errorAL = alGetError())){
+                    r = NIX_FALSE;
+                } else if(NixOpenALSource_isPlaying(obj) && !NixOpenALSource_isPaused(obj)){
+                    //start playing if necesary
+                    ALint sourceState;
+                    alGetSourcei(obj->idSourceAL, AL_SOURCE_STATE, &sourceState);    NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
+                    if(sourceState != AL_PLAYING){
+                        alSourcePlay(obj->idSourceAL);
                     }
                 }
-                //
-                if(pair.idBufferAL != NIX_OPENAL_NULL){
+            } else {
+                //set buffer
+                ALenum errorAL;
+                alSourcei(obj->idSourceAL, AL_BUFFER, pair.idBufferAL);
+                if(AL_NONE != (errorAL = alGetError())){
+                    r = NIX_FALSE;
+                }
+            }
+        }
+        //
+        if(r){
+            const NixUI32 blocks = NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(pBuff.ptr));
+            if(isMove){
+                pair.org = pBuff; //take caller's reference
+            } else {
+                NixBuffer_set(&pair.org, pBuff);
+            }
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                if(!NixOpenALQueue_pushOwning(&obj->queues.pend, &pair)){
+                    NIX_PRINTF_ERROR("NixOpenALSource_queueBufferForOutput::NixOpenALQueue_pushOwning failed.\n");
+                    r = NIX_FALSE;
+                } else {
+                    //added to queue
+                    obj->counters.queued += blocks;
+                    obj->wmark.isArmed = NIX_TRUE;
+                    if(obj->eng != NULL){
+                        NixEngineStats_addQueued(&obj->eng->stats, 1);
+                    }
+                    NixOpenALQueue_prepareForSz(&obj->queues.notify, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
+                    //this is the first buffer i the queue
+                    if(obj->queues.pend.use == 1){
+                        obj->queues.pendBlockIdx = 0;
+                    }
                     r = NIX_TRUE;
-                    //link buffer to source
-                    {
-                        if(isStream){
-                            //queue buffer
-                            ALenum errorAL;
-                            alSourceQueueBuffers(obj->idSourceAL, 1, &pair.idBufferAL);
-                            if(AL_NONE != (errorAL = alGetError())){
-                                r = NIX_FALSE;
-                            } else if(NixOpenALSource_isPlaying(obj) && !NixOpenALSource_isPaused(obj)){
-                                //start playing if necesary
-                                ALint sourceState;
-                                alGetSourcei(obj->idSourceAL, AL_SOURCE_STATE, &sourceState);    NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
-                                if(sourceState != AL_PLAYING){
-                                    alSourcePlay(obj->idSourceAL);
-                                }
-                            }
-                        } else {
-                            //set buffer
-                            ALenum errorAL;
-                            alSourcei(obj->idSourceAL, AL_BUFFER, pair.idBufferAL);
-                            if(AL_NONE != (errorAL = alGetError())){
-                                r = NIX_FALSE;
-                            }
+                }
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            //flag for tick
+            if(r && obj->eng != NULL){
+                NixOpenALEngine_actvAdd(obj->eng, obj);
+            }
+        }
+    }
+    if(!r){
+        if(isMove){
+            NixBuffer_null(&pair.org); //caller keeps its reference
+        }
+        NixOpenALQueuePair_destroy(&pair);
+    }
+    return r;
+}
+
+NixUI32 NixOpenALSource_queueBuffersForOutput(STNixOpenALSource* obj, const STNixBufferRef* buffs, const NixUI32 buffsSz){
+    NixUI32 r = 0;
+    STNixOpenALQueuePair pairs[NIX_SOURCES_QUEUE_BATCH];
+    ALuint ids[NIX_SOURCES_QUEUE_BATCH];
+    NixBOOL isErr = NIX_FALSE;
+    while(!isErr && r < buffsSz){
+        NixUI32 i, pairsUse = 0;
+        //upload all first
+        while(pairsUse < NIX_SOURCES_QUEUE_BATCH && (r + pairsUse) < buffsSz){
+            STNixOpenALQueuePair* pair = &pairs[pairsUse];
+            NixOpenALQueuePair_init(pair);
+            if(!NixOpenALSource_fillPairForOutput_(obj, buffs[r + pairsUse], pair)){
+                NixOpenALQueuePair_destroy(pair);
+                isErr = NIX_TRUE;
+                break;
+            }
+            ids[pairsUse++] = pair->idBufferAL;
+        }
+        //then queue them with one AL call and one lock
+        if(pairsUse > 0){
+            NixBOOL isQueued = NIX_FALSE;
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                //reserve first, so pushOwning cannot fail after the AL call
+                if(!NixOpenALQueue_prepareForSz(&obj->queues.pend, obj->queues.pend.use + pairsUse)){
+                    NIX_PRINTF_ERROR("NixOpenALSource_queueBuffersForOutput::NixOpenALQueue_prepareForSz failed.\n");
+                } else {
+                    ALenum errorAL;
+                    alSourceQueueBuffers(obj->idSourceAL, (ALsizei)pairsUse, ids);
+                    if(AL_NONE != (errorAL = alGetError())){
+                        NIX_PRINTF_ERROR("NixOpenALSource_queueBuffersForOutput::alSourceQueueBuffers failed: #%d '%s'\n", errorAL, alGetString(errorAL));
+                    } else {
+                        //this is the first buffer i the queue
+                        if(obj->queues.pend.use == 0){
+                            obj->queues.pendBlockIdx = 0;
                         }
-                    }
-                    //
-                    if(r){
-                        NixBuffer_set(&pair.org, pBuff);
-                        NixMutex_lock(obj->queues.mutex);
-                        {
-                            if(!NixOpenALQueue_pushOwning(&obj->queues.pend, &pair)){
-                                NIX_PRINTF_ERROR("NixOpenALSource_queueBufferForOutput::NixOpenALQueue_pushOwning failed.\n");
-                                r = NIX_FALSE;
-                            } else {
-                                //added to queue
-                                NixOpenALQueue_prepareForSz(&obj->queues.reuse, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
-                                NixOpenALQueue_prepareForSz(&obj->queues.notify, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
-                                //this is the first buffer i the queue
-                                if(obj->queues.pend.use == 1){
-                                    obj->queues.pendBlockIdx = 0;
-                                }
-                                r = NIX_TRUE;
-                            }
+                        for(i = 0; i < pairsUse; i++){
+                            STNixOpenALQueuePair* pair = &pairs[i];
+                            NixBuffer_set(&pair->org, buffs[r + i]);
+                            NixOpenALQueue_pushOwning(&obj->queues.pend, pair);
+                            obj->counters.queued += NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(buffs[r + i].ptr));
+                        }
+                        NixOpenALQueue_prepareForSz(&obj->queues.notify, obj->queues.pend.use); //this ensures malloc wont be calle inside a callback
+                        obj->wmark.isArmed = NIX_TRUE;
+                        if(obj->eng != NULL){
+                            NixEngineStats_addQueued(&obj->eng->stats, pairsUse);
                         }
-                        NixMutex_unlock(obj->queues.mutex);
+                        isQueued = NIX_TRUE;
                     }
                 }
-                if(!r){
-                    NixOpenALQueuePair_destroy(&pair);
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            if(isQueued){
+                r += pairsUse;
+            } else {
+                for(i = 0; i < pairsUse; i++){
+                    NixOpenALQueuePair_destroy(&pairs[i]);
                 }
+                isErr = NIX_TRUE;
             }
         }
     }
+    if(r > 0){
+        //start playing if necesary
+        if(NixOpenALSource_isPlaying(obj) && !NixOpenALSource_isPaused(obj)){
+            ALint sourceState;
+            alGetSourcei(obj->idSourceAL, AL_SOURCE_STATE, &sourceState);    NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
+            if(sourceState != AL_PLAYING){
+                alSourcePlay(obj->idSourceAL);
+            }
+        }
+        //flag for tick
+        if(obj->eng != NULL){
+            NixOpenALEngine_actvAdd(obj->eng, obj);
+        }
+    }
     return r;
 }
 
@@ -878,7 +2087,7 @@ NixBOOL NixOpenALSource_pendPopOldestBuffLocked_(STNixOpenALSource* obj){
         if(!NixOpenALQueue_popOrphaning(&obj->queues.pend, &pair)){
             NIX_ASSERT(NIX_FALSE); //program logic error
         } else {
-            //move "cnv" to reusable queue
+            //move "cnv" to engine's pool
             if(pair.idBufferAL != NIX_OPENAL_NULL){
                 ALenum errorAL;
                 ALuint idBufferAL = pair.idBufferAL;
@@ -886,18 +2095,14 @@ NixBOOL NixOpenALSource_pendPopOldestBuffLocked_(STNixOpenALSource* obj){
                 if(AL_NO_ERROR != (errorAL = alGetError())){
                     NIX_PRINTF_ERROR("alSourceUnqueueBuffers failed: #%d '%s' idBufferAL(%d)\n", errorAL, alGetString(errorAL), pair.idBufferAL);
                 } else {
-                    STNixOpenALQueuePair reuse;
-                    NixOpenALQueuePair_init(&reuse);
-                    NixOpenALQueuePair_moveCnv(&pair, &reuse);
-                    if(!NixOpenALQueue_pushOwning(&obj->queues.reuse, &reuse)){
-                        NIX_PRINTF_ERROR("NixOpenALSource_pendPopOldestBuffLocked_::NixOpenALQueue_pushOwning(reuse) failed.\n");
-                        NixOpenALQueuePair_destroy(&reuse);
-                    }
+                    NixOpenALEngine_buffsRelease(obj->eng, pair.idBufferAL, obj->srcFmtAL, obj->srcFmt.samplerate);
+                    pair.idBufferAL = NIX_OPENAL_NULL; //consume
                 }
             }
-            //move "org" to notify queue
+            //move "org" to notify queue (unqueued buffers were fully played)
             if(!NixBuffer_isNull(pair.org)){
                 STNixOpenALQueuePair notif;
+                NIX_ATOMIC_ADD64(&obj->counters.played, NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(pair.org.ptr)));
                 NixOpenALQueuePair_init(&notif);
                 NixOpenALQueuePair_moveOrg(&pair, &notif);
                 if(!NixOpenALQueue_pushOwning(&obj->queues.notify, &notif)){
@@ -929,7 +2134,125 @@ NixBOOL NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(STNixOpenA
             }
         }
     }
-    return r;
+    return r;
+}
+
+NixUI64 NixOpenALSource_getPlayedOffsetLocked_(STNixOpenALSource* obj){
+    NixUI64 r = 0;
+    if(obj->idSourceAL != NIX_OPENAL_NULL && obj->queues.pend.use > 0 && obj->srcFmt.samplerate > 0){
+        ALint sampleOffset = 0;
+        alGetSourcei(obj->idSourceAL, AL_SAMPLE_OFFSET, &sampleOffset); NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SAMPLE_OFFSET)");
+        if(sampleOffset > 0){
+            r = (NixUI64)sampleOffset * obj->buffsFmt.samplerate / obj->srcFmt.samplerate;
+        }
+    }
+    return r;
+}
+
+NixUI64 NixOpenALSource_getPlayedOffsetAndLatencyLocked_(STNixOpenALSource* obj, NixUI64* dstLatencyUs){
+    NixUI64 r = 0, latencyUs = 0;
+    if(obj->eng == NULL || obj->eng->latency.alGetSourcei64vSOFT == NULL){
+        r = NixOpenALSource_getPlayedOffsetLocked_(obj);
+    } else if(obj->idSourceAL != NIX_OPENAL_NULL && obj->queues.pend.use > 0 && obj->srcFmt.samplerate > 0){
+        ALint64SOFT vals[2] = { 0, 0 }; //offset (32.32 fixed point) and latency (nanoseconds)
+        (*obj->eng->latency.alGetSourcei64vSOFT)(obj->idSourceAL, AL_SAMPLE_OFFSET_LATENCY_SOFT, vals);
+        if(AL_NO_ERROR == alGetError()){
+            if(vals[0] > 0){
+                r = (NixUI64)(vals[0] >> 32) * obj->buffsFmt.samplerate / obj->srcFmt.samplerate;
+            }
+            if(vals[1] > 0){
+                latencyUs = (NixUI64)vals[1] / 1000ull;
+            }
+        }
+    }
+    if(dstLatencyUs != NULL){
+        *dstLatencyUs = latencyUs;
+    }
+    return r;
+}
+
+NixUI32 NixOpenALSource_getQueuedBlocksLocked_(STNixOpenALSource* obj){
+    NixUI64 r = 0;
+    {
+        NixUI32 i; for(i = 0; i < obj->queues.pend.use; ++i){
+            const STNixOpenALQueuePair* pair = &obj->queues.pend.arr[i];
+            if(!NixBuffer_isNull(pair->org)){
+                r += NixPCMBuffer_getBlocks((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr));
+            }
+        }
+    }
+    {
+        const NixUI64 played = NixOpenALSource_getPlayedOffsetLocked_(obj);
+        r = (played < r ? r - played : 0);
+    }
+    return (NixUI32)r;
+}
+
+//Render
+
+ALsizei AL_APIENTRY NixOpenALSource_renderCallback_(ALvoid* userptr, ALvoid* sampledata, ALsizei numbytes){
+    STNixOpenALSource* obj = (STNixOpenALSource*)userptr;
+    if(obj->srcFmt.blockAlign > 0 && numbytes > 0){
+        const NixUI32 blocks = (NixUI32)numbytes / obj->srcFmt.blockAlign;
+        NixSourceRender_fill(&obj->render.core, &obj->self, sampledata, blocks);
+        NIX_ATOMIC_ADD64(&obj->counters.played, blocks); //AL mixer thread, must not lock
+    }
+    return numbytes; //always full, silence on user's underruns
+}
+
+void NixOpenALSource_renderRelease_(STNixOpenALSource* obj){
+    if(obj->render.idBufferCbAL != NIX_OPENAL_NULL){
+        alDeleteBuffers(1, &obj->render.idBufferCbAL); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
+        obj->render.idBufferCbAL = NIX_OPENAL_NULL;
+    }
+    {
+        NixUI32 i; for(i = 0; i < NIX_OPENAL_RENDER_BUFFERS; i++){
+            if(obj->render.idsBuffersAL[i] != NIX_OPENAL_NULL){
+                if(obj->eng != NULL){
+                    NixOpenALEngine_buffsRelease(obj->eng, obj->render.idsBuffersAL[i], obj->srcFmtAL, obj->srcFmt.samplerate);
+                } else {
+                    alDeleteBuffers(1, &obj->render.idsBuffersAL[i]); NIX_OPENAL_ERR_VERIFY("alDeleteBuffers");
+                }
+                obj->render.idsBuffersAL[i] = NIX_OPENAL_NULL;
+            }
+        }
+        obj->render.idsFreeUse = 0;
+    }
+    if(obj->render.pcm != NULL){
+        NIX_RT_MFREE(obj->ctx, obj->render.pcm);
+        obj->render.pcm = NULL;
+    }
+    if(NixOpenALSource_isRender(obj)){
+        NixSourceRender_destroy(&obj->render.core);
+        NixSourceRender_init(obj->ctx, &obj->render.core);
+    }
+}
+
+void NixOpenALSource_renderUnqueue_(STNixOpenALSource* obj, const NixBOOL countAsPlayed){
+    ALint csmdAmm = 0;
+    alGetSourceiv(obj->idSourceAL, AL_BUFFERS_PROCESSED, &csmdAmm); NIX_OPENAL_ERR_VERIFY("alGetSourceiv(AL_BUFFERS_PROCESSED)");
+    while(csmdAmm > 0 && obj->render.idsFreeUse < NIX_OPENAL_RENDER_BUFFERS){
+        ALuint idBufferAL = NIX_OPENAL_NULL;
+        alSourceUnqueueBuffers(obj->idSourceAL, 1, &idBufferAL); NIX_OPENAL_ERR_VERIFY("alSourceUnqueueBuffers");
+        obj->render.idsFree[obj->render.idsFreeUse++] = idBufferAL;
+        if(countAsPlayed){
+            NIX_ATOMIC_ADD64(&obj->counters.played, NIX_SOURCES_RENDER_BLOCKS);
+        }
+        --csmdAmm;
+    }
+}
+
+void NixOpenALSource_renderRefill_(STNixOpenALSource* obj){
+    NIX_TRACE_BEGIN(trRefill);
+    NixOpenALSource_renderUnqueue_(obj, NIX_TRUE);
+    while(obj->render.idsFreeUse > 0){
+        const ALuint idBufferAL = obj->render.idsFree[obj->render.idsFreeUse - 1];
+        NixSourceRender_fill(&obj->render.core, &obj->self, obj->render.pcm, NIX_SOURCES_RENDER_BLOCKS);
+        alBufferData(idBufferAL, obj->srcFmtAL, obj->render.pcm, (ALsizei)(NIX_SOURCES_RENDER_BLOCKS * obj->srcFmt.blockAlign), (ALsizei)obj->srcFmt.samplerate); NIX_OPENAL_ERR_VERIFY("alBufferData");
+        alSourceQueueBuffers(obj->idSourceAL, 1, &idBufferAL); NIX_OPENAL_ERR_VERIFY("alSourceQueueBuffers");
+        --obj->render.idsFreeUse;
+    }
+    NIX_TRACE_END(trRefill, "renderRefill", obj->self.ptr);
 }
 
 //------
@@ -955,7 +2278,7 @@ void NixOpenALRecorder_init(STNixContextRef ctx, STNixOpenALRecorder* obj){
 void NixOpenALRecorder_destroy(STNixOpenALRecorder* obj){
     //queues
     {
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixOpenALQueue_destroy(&obj->queues.notify);
             NixOpenALQueue_destroy(&obj->queues.reuse);
@@ -966,7 +2289,7 @@ void NixOpenALRecorder_destroy(STNixOpenALRecorder* obj){
             //tmp
             {
                 if(obj->queues.filling.tmp != NULL){
-                    NixContext_mfree(obj->ctx, obj->queues.filling.tmp);
+                    NIX_RT_MFREE(obj->ctx, obj->queues.filling.tmp);
                     obj->queues.filling.tmp = NULL;
                 }
                 obj->queues.filling.tmpSz = 0;
@@ -1000,7 +2323,7 @@ void NixOpenALRecorder_destroy(STNixOpenALRecorder* obj){
 
 NixBOOL NixOpenALRecorder_prepare(STNixOpenALRecorder* obj, STNixOpenALEngine* eng, const STNixAudioDesc* audioDesc, const NixUI16 buffersCount, const NixUI16 blocksPerBuffer){
     NixBOOL r = NIX_FALSE;
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.conv == NULL && audioDesc->blockAlign > 0){
         STNixAudioDesc inDesc = STNixAudioDesc_Zero;
         ALenum apiFmt = AL_UNDETERMINED;
@@ -1060,7 +2383,7 @@ NixBOOL NixOpenALRecorder_prepare(STNixOpenALRecorder* obj, STNixOpenALEngine* e
                 //tmp
                 {
                     if(obj->queues.filling.tmp != NULL){
-                        NixContext_mfree(obj->ctx, obj->queues.filling.tmp);
+                        NIX_RT_MFREE(obj->ctx, obj->queues.filling.tmp);
                         obj->queues.filling.tmp = NULL;
                     }
                     obj->queues.filling.tmpSz = 0;
@@ -1094,6 +2417,8 @@ NixBOOL NixOpenALRecorder_prepare(STNixOpenALRecorder* obj, STNixOpenALEngine* e
                             NIX_PRINTF_ERROR("NixOpenALRecorder_prepare::no reusable buffer could be allocated.\n");
                         } else {
                             //prepared
+                            obj->stats = &eng->stats;
+                            NixFmtConverter_setStats(conv, obj->stats);
                             obj->queues.filling.iCurSample = 0;
                             obj->queues.conv = conv; conv = NULL; //consume
                             obj->queues.filling.tmp = tmpBuff; tmpBuff = NULL; //consume
@@ -1115,7 +2440,7 @@ NixBOOL NixOpenALRecorder_prepare(STNixOpenALRecorder* obj, STNixOpenALEngine* e
                 }
                 //release (if not consumed)
                 if(tmpBuff != NULL){
-                    NixContext_mfree(obj->ctx, tmpBuff);
+                    NIX_RT_MFREE(obj->ctx, tmpBuff);
                     tmpBuff = NULL;
                 }
                 obj->idCaptureAL = capDev;
@@ -1170,7 +2495,7 @@ NixBOOL NixOpenALRecorder_stop(STNixOpenALRecorder* obj){
 NixBOOL NixOpenALRecorder_flush(STNixOpenALRecorder* obj){
     NixBOOL r = NIX_TRUE;
     //move filling buffer to notify (if data is available)
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     if(obj->queues.reuse.use > 0){
         STNixOpenALQueuePair* pair = &obj->queues.reuse.arr[0];
         if(!NixBuffer_isNull(pair->org) && ((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr))->use > 0){
@@ -1186,6 +2511,7 @@ NixBOOL NixOpenALRecorder_flush(STNixOpenALRecorder* obj){
 }
 
 void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
+    NIX_TRACE_BEGIN(trConsume);
     if(obj->queues.conv != NULL && obj->idCaptureAL != NIX_OPENAL_NULL){
         NixUI32 inIdx = 0;
         ALCint inSz = 0;
@@ -1194,7 +2520,7 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
             ALenum errorAL;
             alcGetIntegerv(obj->idCaptureAL, ALC_CAPTURE_SAMPLES, (ALCsizei)sizeof(inSz), &inSz);
             if(AL_NO_ERROR != (errorAL = alGetError())){
-                NIX_PRINTF_ERROR("alcGetIntegerv(ALC_CAPTURE_SAMPLES) failed with error #%d\n", (NixSI32)errorAL, alGetString(errorAL));
+                NIX_PRINTF_ERROR("alcGetIntegerv(ALC_CAPTURE_SAMPLES) failed with error #%d '%s'\n", (NixSI32)errorAL, alGetString(errorAL));
                 inSz = 0;
             } else {
                 NIX_ASSERT(inSz >= 0)
@@ -1205,7 +2531,7 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
                 if(inSz > 0){
                     alcCaptureSamples(obj->idCaptureAL, (ALCvoid *)obj->queues.filling.tmp, inSz);
                     if(AL_NO_ERROR != (errorAL = alGetError())){
-                        NIX_PRINTF_ERROR("alcCaptureSamples failed with error #%d\n", (NixSI32)errorAL, alGetString(errorAL));
+                        NIX_PRINTF_ERROR("alcCaptureSamples failed with error #%d '%s'\n", (NixSI32)errorAL, alGetString(errorAL));
                         inSz = 0;
                     } else {
                         //
@@ -1213,7 +2539,7 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
                 }
             }
         }
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             //process
             while(inIdx < inSz){
@@ -1224,6 +2550,13 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
                         NIX_ASSERT(NIX_FALSE);
                         break;
                     }
+                    //overrun (its frames are lost)
+                    if(obj->stats != NULL && !NixBuffer_isNull(obj->queues.reuse.arr[0].org)){
+                        const STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(obj->queues.reuse.arr[0].org.ptr);
+                        if(org->desc.blockAlign > 0){
+                            NixEngineStats_addRecOverrun(obj->stats, org->use / org->desc.blockAlign);
+                        }
+                    }
                 } else {
                     STNixOpenALQueuePair* pair = &obj->queues.reuse.arr[0];
                     if(NixBuffer_isNull(pair->org) || ((STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr))->desc.blockAlign <= 0){
@@ -1256,6 +2589,7 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
                             } else {
                                 inIdx += ammBlocksRead;
                                 obj->queues.filling.iCurSample += ammBlocksWritten;
+                                obj->counters.captured += ammBlocksWritten;
                                 org->use = (obj->queues.filling.iCurSample * org->desc.blockAlign); NIX_ASSERT(org->use <= org->sz)
                             }
                         }
@@ -1274,10 +2608,11 @@ void NixOpenALRecorder_consumeInputBuffer(STNixOpenALRecorder* obj){
         }
         NixMutex_unlock(obj->queues.mutex);
     }
+    NIX_TRACE_END(trConsume, "recConsume", obj->selfRef.ptr);
 }
 
 void NixOpenALRecorder_notifyBuffers(STNixOpenALRecorder* obj, const NixBOOL discardWithoutNotifying){
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         const NixUI32 maxProcess = obj->queues.notify.use;
         NixUI32 ammProcessed = 0;
@@ -1293,9 +2628,15 @@ void NixOpenALRecorder_notifyBuffers(STNixOpenALRecorder* obj, const NixBOOL dis
                     STNixPCMBuffer* org = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair.org.ptr);
                     NixMutex_unlock(obj->queues.mutex);
                     {
+                        const NixUI64 nsCall = NixClock_getMonotonicNs();
+                        NIX_TRACE_BEGIN(trCall);
                         (*obj->callback.func)(&obj->engRef, &obj->selfRef, org->desc, org->ptr, org->use, (org->use / org->desc.blockAlign), obj->callback.data);
+                        NIX_TRACE_END(trCall, "recCallback", obj->selfRef.ptr);
+                        if(obj->stats != NULL){
+                            NixEngineStats_addCallback(obj->stats, NixClock_getMonotonicNs() - nsCall);
+                        }
                     }
-                    NixMutex_lock(obj->queues.mutex);
+                    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
                 }
                 //move to reuse
                 if(!NixOpenALQueue_pushOwning(&obj->queues.reuse, &pair)){
@@ -1340,6 +2681,20 @@ STNixEngineRef nixOpenALEngine_alloc(STNixContextRef ctx){
                     obj->maskCapabilities   |= (alcIsExtensionPresent(obj->deviceAL, "ALC_EXT_CAPTURE") != ALC_FALSE || alcIsExtensionPresent(obj->deviceAL, "ALC_EXT_capture") != ALC_FALSE) ? NIX_CAP_AUDIO_CAPTURE : 0;
                     obj->maskCapabilities   |= (alIsExtensionPresent("AL_EXT_STATIC_BUFFER") != AL_FALSE) ? NIX_CAP_AUDIO_STATIC_BUFFERS : 0;
                     obj->maskCapabilities   |= (alIsExtensionPresent("AL_EXT_OFFSET") != AL_FALSE) ? NIX_CAP_AUDIO_SOURCE_OFFSETS : 0;
+                    //events (optional, fallbacks to polling)
+                    NixOpenALEngine_eventsEnable(obj);
+                    //latency (optional, fallbacks to interpolation)
+                    if(alIsExtensionPresent("AL_SOFT_source_latency") != AL_FALSE){
+                        obj->latency.alGetSourcei64vSOFT = (LPALGETSOURCEI64VSOFT)alGetProcAddress("alGetSourcei64vSOFT");
+                    }
+                    //render (optional, fallbacks to a ring of buffers refilled by tick)
+                    if(alIsExtensionPresent("AL_SOFT_callback_buffer") != AL_FALSE){
+                        obj->render.alBufferCallbackSOFT = (LPALBUFFERCALLBACKSOFT)alGetProcAddress("alBufferCallbackSOFT");
+                    }
+                    //pool (pre-warm)
+                    if(NixOpenALEngine_poolGrow(obj, NIX_SOURCES_POOL_INIT) < NIX_SOURCES_POOL_INIT){
+                        NIX_PRINTF_WARNING("nixOpenALEngine_alloc::NixOpenALEngine_poolGrow could not pre-allocate all sources.\n");
+                    }
                     //
                     r.itf = &obj->apiItf.engine;
                     obj = NULL; //consume
@@ -1349,7 +2704,7 @@ STNixEngineRef nixOpenALEngine_alloc(STNixContextRef ctx){
         //release (if not consumed)
         if(obj != NULL){
             NixOpenALEngine_destroy(obj);
-            NixContext_mfree(ctx, obj);
+            NIX_RT_MFREE(ctx, obj);
             obj = NULL;
         }
     }
@@ -1398,6 +2753,7 @@ void nixOpenALEngine_printCaps(STNixEngineRef pObj){
         printf("EXTCaptura:       %s\n", (obj->maskCapabilities & NIX_CAP_AUDIO_CAPTURE)?"supported":"unsupported");
         printf("EXTBuffEstaticos: %s\n", (obj->maskCapabilities & NIX_CAP_AUDIO_STATIC_BUFFERS)?"supported":"unsupported");
         printf("EXTOffsets:       %s\n", (obj->maskCapabilities & NIX_CAP_AUDIO_SOURCE_OFFSETS)?"supported":"unsupported");
+        printf("EXTEvents:        %s\n", obj->events.isEnabled ? "supported" : "unsupported (polling)");
         printf("Extensions AL:    '%s'\n", strAlExtensions);
         printf("Extensions ALC:   '%s'\n", strAlcExtensions);
         //List sound devices
@@ -1472,6 +2828,7 @@ NixBOOL nixOpenALEngine_ctxDeactivate(STNixEngineRef pObj){
 void nixOpenALEngine_tick(STNixEngineRef pObj){
     STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(pObj.ptr);
     if(obj != NULL){
+        NixOneShots_tick(&obj->oneShots);
         NixOpenALEngine_tick(obj, NIX_FALSE);
     }
 }
@@ -1505,6 +2862,172 @@ STNixRecorderRef nixOpenALEngine_allocRecorder(STNixEngineRef ref, const STNixAu
     return r;
 }
 
+//One-shots
+
+NixBOOL nixOpenALEngine_playOneShot(STNixEngineRef ref, STNixBufferRef buff, const NixFLOAT vol, const NixUI8 priority){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_play(&obj->oneShots, ref, buff, vol, priority);
+    }
+    return r;
+}
+
+NixBOOL nixOpenALEngine_setOneShotsLimit(STNixEngineRef ref, const NixUI32 maxConcurrent, const ENNixOneShotSteal steal){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixOneShots_setLimit(&obj->oneShots, maxConcurrent, steal);
+    }
+    return r;
+}
+
+//Voices
+
+NixBOOL nixOpenALEngine_setVoicesLimit(STNixEngineRef ref, const NixUI32 maxReal){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        NIX_ATOMIC_STORE32(&obj->virt.maxReal, maxReal); //applied by next tick
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//Batch
+
+//Clock
+
+NixUI64 nixOpenALEngine_getFrameTime(STNixEngineRef ref, NixUI32* optDstFramesPerSec){
+    NixUI64 r = 0;
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL){
+        r = NixEngineClock_getFrame(&obj->clock);
+    }
+    if(optDstFramesPerSec != NULL){
+        *optDstFramesPerSec = (obj != NULL ? obj->clock.rate : 0);
+    }
+    return r;
+}
+
+//Stats
+
+NixBOOL nixOpenALEngine_getStats(STNixEngineRef ref, STNixEngineStats* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALEngine* obj = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        NixEngineStats_get(&obj->stats, dst);
+        dst->backendErrors = NIX_ATOMIC_LOAD32(&NixOpenAL_errorsCount_);
+        //sources (snapshot)
+        {
+            STNixOpenALSrcsSnap* srcs = NixOpenALEngine_srcsRetain(obj);
+            if(srcs != NULL){
+                NixUI32 i; for(i = 0; i < srcs->use; ++i){
+                    STNixOpenALSource* src = srcs->arr[i];
+                    if(NixOpenALSource_isPlaying(src) && !NixOpenALSource_isPaused(src)){
+                        dst->sourcesActive++;
+                    }
+                }
+                dst->sourcesTotal = srcs->use; //pooled sources are not in the snapshot
+                NixOpenALEngine_srcsRelease(obj, srcs);
+            }
+        }
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+void nixOpenALEngine_playSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz){
+    STNixOpenALEngine* eng = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(eng != NULL && srcs != NULL){
+        const NixUI64 usNow = NixClock_getMonotonicUs();
+        ALuint ids[NIX_SOURCES_PLAY_BATCH];
+        NixUI32 i = 0;
+        while(i < srcsSz){
+            ALsizei idsUse = 0;
+            while(i < srcsSz && idsUse < NIX_SOURCES_PLAY_BATCH){
+                const STNixSourceRef src = srcs[i++];
+                if(src.itf != &eng->apiItf.source){
+                    //not from this engine
+                    NixSource_play(src);
+                } else if(src.ptr != NULL){
+                    STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(src.ptr);
+                    NixOpenALSource_virtPromote(obj, usNow, NIX_FALSE);
+                    if(obj->idSourceAL != NIX_OPENAL_NULL){
+                        if(NixOpenALSource_isRenderRing(obj)){
+                            NixOpenALEngine_actvAdd(eng, obj); //filled and started by tick (owns the ring)
+                        } else {
+                            if(NixOpenALSource_isStatic(obj) && NIX_ATOMIC_LOAD32(&eng->virt.maxReal) > 0){
+                                NixOpenALEngine_actvAdd(eng, obj); //voices limit, tracked by tick
+                            }
+                            ids[idsUse++] = obj->idSourceAL;
+                        }
+                    }
+                    NixOpenALSource_setIsPlaying(obj, NIX_TRUE);
+                    NixOpenALSource_setIsPaused(obj, NIX_FALSE);
+                }
+            }
+            //start together
+            if(idsUse > 0){
+                alSourcePlayv(idsUse, ids); NIX_OPENAL_ERR_VERIFY("alSourcePlayv");
+            }
+        }
+    }
+}
+
+void nixOpenALEngine_stopSources(STNixEngineRef ref, const STNixSourceRef* srcs, const NixUI32 srcsSz){
+    STNixOpenALEngine* eng = (STNixOpenALEngine*)NixSharedPtr_getOpq(ref.ptr);
+    if(eng != NULL && srcs != NULL){
+        ALuint ids[NIX_SOURCES_PLAY_BATCH];
+        NixUI32 i = 0, iFirst;
+        while(i < srcsSz){
+            ALsizei idsUse = 0;
+            iFirst = i;
+            while(i < srcsSz && idsUse < NIX_SOURCES_PLAY_BATCH){
+                const STNixSourceRef src = srcs[i++];
+                if(src.itf != &eng->apiItf.source){
+                    //not from this engine
+                    NixSource_stop(src);
+                } else if(src.ptr != NULL){
+                    STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(src.ptr);
+                    NixOpenALSource_setIsVirtual(obj, NIX_FALSE);
+                    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+                    {
+                        obj->sched.startUs = obj->sched.stopUs = 0;
+                        //keep the played position (the flushed buffers are not counted as played)
+                        if(obj->idSourceAL != NIX_OPENAL_NULL){
+                            NIX_ATOMIC_ADD64(&obj->counters.played, NixOpenALSource_getPlayedOffsetLocked_(obj));
+                        }
+                    }
+                    NixMutex_unlock(obj->queues.mutex);
+                    if(obj->idSourceAL != NIX_OPENAL_NULL){
+                        ids[idsUse++] = obj->idSourceAL;
+                    }
+                }
+            }
+            //stop together
+            if(idsUse > 0){
+                alSourceStopv(idsUse, ids); NIX_OPENAL_ERR_VERIFY("alSourceStopv");
+            }
+            //flush all pending buffers
+            for(; iFirst < i; iFirst++){
+                const STNixSourceRef src = srcs[iFirst];
+                if(src.itf == &eng->apiItf.source && src.ptr != NULL){
+                    STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(src.ptr);
+                    NixOpenALSource_setIsPlaying(obj, NIX_FALSE);
+                    NixOpenALSource_setIsPaused(obj, NIX_FALSE);
+                    //render ring (unqueued by tick, stopped buffers are not counted as played)
+                    if(NixOpenALSource_isRenderRing(obj)){
+                        NIX_ATOMIC_STORE32(&obj->render.flushPend, 1);
+                        NixOpenALEngine_actvAdd(eng, obj);
+                    }
+                    nixOpenALSource_removeAllBuffersAndNotify_(obj);
+                }
+            }
+        }
+    }
+}
+
 //------
 //Source API
 //------
@@ -1515,36 +3038,26 @@ STNixSourceRef nixOpenALSource_alloc(STNixEngineRef pEng){
     if(eng == NULL){
         NIX_PRINTF_ERROR("nixOpenALSource_alloc::NixSharedPtr_getOpq returned NULL\n");
     } else {
-        STNixOpenALSource* obj = (STNixOpenALSource*)NixContext_malloc(eng->ctx, sizeof(STNixOpenALSource), "STNixOpenALSource");
+        STNixOpenALSource* obj = NixOpenALEngine_poolPop(eng);
         if(obj == NULL){
-            NIX_PRINTF_ERROR("nixOpenALSource_alloc::NixContext_malloc returned NULL\n");
+            NIX_PRINTF_ERROR("nixOpenALSource_alloc::NixOpenALEngine_poolPop returned NULL\n");
+        } else if(!NixOpenALEngine_srcsAdd(eng, obj)){
+            //add to engine
+            NIX_PRINTF_ERROR("nixOpenALSource_create::NixOpenALEngine_srcsAdd failed.\n");
+        } else if(NULL == (r.ptr = NixSharedPtr_alloc(eng->ctx.itf, obj, "nixOpenALSource_alloc"))){
+            NIX_PRINTF_ERROR("nixAAudioEngine_create::NixSharedPtr_alloc failed.\n");
+            NixOpenALEngine_srcsRemove(eng, obj);
         } else {
-            NixOpenALSource_init(eng->ctx, obj);
-            obj->eng = eng;
-            //
-            ALenum errorAL;
-            alGenSources(1, &obj->idSourceAL);
-            if(AL_NO_ERROR != (errorAL = alGetError())){
-                NIX_PRINTF_ERROR("alGenSources failed with error #%d\n", (NixSI32)errorAL);
-                obj->idSourceAL = NIX_OPENAL_NULL;
-            } else {
-                obj->idSourceAL = obj->idSourceAL;
-                //add to engine
-                if(!NixOpenALEngine_srcsAdd(eng, obj)){
-                    NIX_PRINTF_ERROR("nixOpenALSource_create::NixOpenALEngine_srcsAdd failed.\n");
-                } else if(NULL == (r.ptr = NixSharedPtr_alloc(eng->ctx.itf, obj, "nixOpenALSource_alloc"))){
-                    NIX_PRINTF_ERROR("nixAAudioEngine_create::NixSharedPtr_alloc failed.\n");
-                } else {
-                    r.itf = &eng->apiItf.source;
-                    obj->self = r;
-                    obj = NULL; //consume
-                }
-            }
+            r.itf = &eng->apiItf.source;
+            obj->self = r;
+            obj = NULL; //consume
         }
         //release (if not consumed)
         if(obj != NULL){
-            NixOpenALSource_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            if(!NixOpenALEngine_poolReturn(eng, obj)){
+                NixOpenALSource_destroy(obj);
+                NIX_RT_MFREE(eng->ctx, obj);
+            }
             obj = NULL;
         }
     }
@@ -1555,7 +3068,7 @@ void nixOpenALSource_removeAllBuffersAndNotify_(STNixOpenALSource* obj){
     STNixNotifQueue notifs;
     NixNotifQueue_init(obj->ctx, &notifs);
     //move all pending buffers to notify
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixOpenALSource_pendMoveAllBuffsToNotifyWithoutPoppingLocked_(obj);
         NixOpenALEngine_tick_addQueueNotifSrcLocked_(&notifs, obj);
@@ -1598,6 +3111,8 @@ void nixOpenALSource_free(STNixSourceRef pObj){ //orphans the source, will autom
                 }
                 nixOpenALSource_removeAllBuffersAndNotify_(obj);
             }
+            //flag for tick (cleanup)
+            NixOpenALEngine_actvAdd(obj->eng, obj);
         }
     }
 }
@@ -1640,8 +3155,16 @@ NixBOOL nixOpenALSource_setRepeat(STNixSourceRef pObj, const NixBOOL isRepeat){
 void nixOpenALSource_play(STNixSourceRef pObj){
     if(pObj.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
+        NixOpenALSource_virtPromote(obj, NixClock_getMonotonicUs(), NIX_FALSE);
         if(obj->idSourceAL != NIX_OPENAL_NULL){
-            alSourcePlay(obj->idSourceAL);    NIX_OPENAL_ERR_VERIFY("alSourcePlay");
+            if(NixOpenALSource_isRenderRing(obj)){
+                NixOpenALEngine_actvAdd(obj->eng, obj); //filled and started by tick (owns the ring)
+            } else {
+                if(NixOpenALSource_isStatic(obj) && obj->eng != NULL && NIX_ATOMIC_LOAD32(&obj->eng->virt.maxReal) > 0){
+                    NixOpenALEngine_actvAdd(obj->eng, obj); //voices limit, tracked by tick
+                }
+                alSourcePlay(obj->idSourceAL);    NIX_OPENAL_ERR_VERIFY("alSourcePlay");
+            }
         }
         NixOpenALSource_setIsPlaying(obj, NIX_TRUE);
         NixOpenALSource_setIsPaused(obj, NIX_FALSE);
@@ -1651,6 +3174,7 @@ void nixOpenALSource_play(STNixSourceRef pObj){
 void nixOpenALSource_pause(STNixSourceRef pObj){
     if(pObj.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
+        NixOpenALSource_virtPromote(obj, NixClock_getMonotonicUs(), NIX_FALSE);
         if(obj->idSourceAL != NULL){
             alSourcePause(obj->idSourceAL);    NIX_OPENAL_ERR_VERIFY("alSourcePause");
         }
@@ -1661,8 +3185,23 @@ void nixOpenALSource_pause(STNixSourceRef pObj){
 void nixOpenALSource_stop(STNixSourceRef pObj){
     if(pObj.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
+        NixOpenALSource_setIsVirtual(obj, NIX_FALSE);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            obj->sched.startUs = obj->sched.stopUs = 0;
+            //keep the played position (the flushed buffers are not counted as played)
+            if(obj->idSourceAL != NIX_OPENAL_NULL){
+                NIX_ATOMIC_ADD64(&obj->counters.played, NixOpenALSource_getPlayedOffsetLocked_(obj));
+            }
+        }
+        NixMutex_unlock(obj->queues.mutex);
         if(obj->idSourceAL != NIX_OPENAL_NULL){
             alSourceStop(obj->idSourceAL); NIX_OPENAL_ERR_VERIFY("alSourceStop");
+            //render ring (unqueued by tick, stopped buffers are not counted as played)
+            if(NixOpenALSource_isRenderRing(obj)){
+                NIX_ATOMIC_STORE32(&obj->render.flushPend, 1);
+                NixOpenALEngine_actvAdd(obj->eng, obj);
+            }
         }
         NixOpenALSource_setIsPlaying(obj, NIX_FALSE);
         NixOpenALSource_setIsPaused(obj, NIX_FALSE);
@@ -1675,7 +3214,9 @@ NixBOOL nixOpenALSource_isPlaying(STNixSourceRef pObj){
     NixBOOL r = NIX_FALSE;
     if(pObj.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
-        if(obj->idSourceAL != NIX_OPENAL_NULL){
+        if(NixOpenALSource_isVirtual(obj)){
+            r = NIX_TRUE; //paused at AL, playing for the user
+        } else if(obj->idSourceAL != NIX_OPENAL_NULL){
             ALint sourceState;
             alGetSourcei(obj->idSourceAL, AL_SOURCE_STATE, &sourceState);    NIX_OPENAL_ERR_VERIFY("alGetSourcei(AL_SOURCE_STATE)");
             r = sourceState == AL_PLAYING ? NIX_TRUE : NIX_FALSE;
@@ -1773,6 +3314,9 @@ NixBOOL nixOpenALSource_prepareSourceForFmtAndSz_(STNixOpenALSource* obj, const
                     obj->queues.conv.buff.ptr = (void*)NixContext_malloc(obj->ctx, cnvBytes, "obj->queues.conv.buff.ptr");
                     if(obj->queues.conv.buff.ptr != NULL){
                         obj->queues.conv.buff.sz = cnvBytes;
+                        if(obj->eng != NULL){
+                            NixFmtConverter_setStats(conv, &obj->eng->stats);
+                        }
                         obj->queues.conv.obj = conv; conv = NULL;
                         obj->buffsFmt   = *fmt;
                         obj->srcFmtAL   = fmtAL;
@@ -1808,13 +3352,15 @@ NixBOOL nixOpenALSource_setBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){  /
             NIX_PRINTF_ERROR("nixOpenALSource_setBuffer, source already has buffer.\n");
         } else if(NixOpenALSource_isStatic(obj)){
             NIX_PRINTF_ERROR("nixOpenALSource_setBuffer, source is already static.\n");
+        } else if(NixOpenALSource_isRender(obj)){
+            NIX_PRINTF_ERROR("nixOpenALSource_setBuffer, source is a render source.\n");
         } else if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
             NIX_PRINTF_ERROR("nixOpenALSource_setBuffer, new buffer doesnt match first buffer's format.\n");
         } else {
             NixOpenALSource_setIsStatic(obj, NIX_TRUE);
             //schedule
             NixBOOL isStream = NIX_FALSE;
-            if(!NixOpenALSource_queueBufferForOutput(obj, pBuff, isStream)){
+            if(!NixOpenALSource_queueBufferForOutput(obj, pBuff, isStream, NIX_FALSE)){
                 NIX_PRINTF_ERROR("nixOpenALSource_setBuffer, NixOpenALSource_queueBufferForOutput failed.\n");
             } else {
                 r = NIX_TRUE;
@@ -1824,7 +3370,7 @@ NixBOOL nixOpenALSource_setBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){  /
     return r;
 }
 
-NixBOOL nixOpenALSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
+NixBOOL nixOpenALSource_queueBuffer_(STNixSourceRef pObj, STNixBufferRef pBuff, const NixBOOL isMove){
     NixBOOL r = NIX_FALSE;
     if(pObj.ptr != NULL && pBuff.ptr != NULL){
         STNixOpenALSource* obj    = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
@@ -1839,12 +3385,14 @@ NixBOOL nixOpenALSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
             NIX_PRINTF_ERROR("nixOpenALSource_queueBuffer, no source available.\n");
         } else if(NixOpenALSource_isStatic(obj)){
             NIX_PRINTF_ERROR("nixOpenALSource_queueBuffer, source is static.\n");
+        } else if(NixOpenALSource_isRender(obj)){
+            NIX_PRINTF_ERROR("nixOpenALSource_queueBuffer, source is a render source.\n");
         } else if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
             NIX_PRINTF_ERROR("nixOpenALSource_queueBuffer, new buffer doesnt match first buffer's format.\n");
         } else {
             //schedule
             NixBOOL isStream = NIX_TRUE;
-            if(!NixOpenALSource_queueBufferForOutput(obj, pBuff, isStream)){
+            if(!NixOpenALSource_queueBufferForOutput(obj, pBuff, isStream, isMove)){
                 NIX_PRINTF_ERROR("nixOpenALSource_queueBuffer, NixOpenALSource_queueBufferForOutput failed.\n");
             } else {
                 r = NIX_TRUE;
@@ -1854,11 +3402,51 @@ NixBOOL nixOpenALSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
     return r;
 }
 
+NixBOOL nixOpenALSource_queueBuffer(STNixSourceRef pObj, STNixBufferRef pBuff){
+    return nixOpenALSource_queueBuffer_(pObj, pBuff, NIX_FALSE);
+}
+
+NixBOOL nixOpenALSource_queueBufferMove(STNixSourceRef pObj, STNixBufferRef* pBuff){
+    NixBOOL r = NIX_FALSE;
+    if(pBuff != NULL && nixOpenALSource_queueBuffer_(pObj, *pBuff, NIX_TRUE)){
+        NixBuffer_null(pBuff); //consumed
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixUI32 nixOpenALSource_queueBuffers(STNixSourceRef pObj, const STNixBufferRef* buffs, const NixUI32 buffsSz){
+    NixUI32 r = 0;
+    if(pObj.ptr != NULL && buffs != NULL && buffsSz > 0 && buffs[0].ptr != NULL){
+        STNixOpenALSource* obj    = (STNixOpenALSource*)NixSharedPtr_getOpq(pObj.ptr);
+        STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(buffs[0].ptr);
+        if(obj->buffsFmt.blockAlign == 0){
+            if(!nixOpenALSource_prepareSourceForFmtAndSz_(obj, &buff->desc, buff->sz)){
+                //error
+            }
+        }
+        //
+        if(obj->idSourceAL == NIX_OPENAL_NULL){
+            NIX_PRINTF_ERROR("nixOpenALSource_queueBuffers, no source available.\n");
+        } else if(NixOpenALSource_isStatic(obj)){
+            NIX_PRINTF_ERROR("nixOpenALSource_queueBuffers, source is static.\n");
+        } else if(NixOpenALSource_isRender(obj)){
+            NIX_PRINTF_ERROR("nixOpenALSource_queueBuffers, source is a render source.\n");
+        } else if(!STNixAudioDesc_isEqual(&obj->buffsFmt, &buff->desc)){
+            NIX_PRINTF_ERROR("nixOpenALSource_queueBuffers, new buffer doesnt match first buffer's format.\n");
+        } else {
+            //schedule (stops at the first buffer that cannot be queued)
+            r = NixOpenALSource_queueBuffersForOutput(obj, buffs, buffsSz);
+        }
+    }
+    return r;
+}
+
 NixBOOL nixOpenALSource_setBufferOffset(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 offset){ //relative to first buffer in queue
     NixBOOL r = NIX_FALSE;
     if(ref.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->queues.pend.use > 0){
             STNixOpenALQueuePair* pair = &obj->queues.pend.arr[0];
             STNixPCMBuffer* buff = (STNixPCMBuffer*)NixSharedPtr_getOpq(pair->org.ptr);
@@ -1890,7 +3478,7 @@ NixUI32 nixOpenALSource_getBuffersCount(STNixSourceRef ref, NixUI32* optDstBytes
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         {
             NixUI32 i; for(i = 0; i < obj->queues.pend.use; i++){
                 STNixOpenALQueuePair* pair = &obj->queues.pend.arr[0];
@@ -1916,7 +3504,7 @@ NixUI32 nixOpenALSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytes
     NixUI32 r = 0, bytesCount = 0, blocksCount = 0, msecsCount = 0;
     if(ref.ptr != NULL){
         STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
-        NixMutex_lock(obj->queues.mutex);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
         if(obj->idSourceAL != NIX_OPENAL_NULL && obj->queues.pend.use > 0 && obj->srcFmt.samplerate > 0){
             ALint processedBuffers = 0, sampleOffset = 0;
             alGetSourcei(obj->idSourceAL, AL_BUFFERS_PROCESSED, &processedBuffers);
@@ -1940,6 +3528,235 @@ NixUI32 nixOpenALSource_getBlocksOffset(STNixSourceRef ref, NixUI32* optDstBytes
     return r;
 }
 
+NixBOOL nixOpenALSource_setPriority(STNixSourceRef ref, const NixUI8 priority){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        obj->virt.priority = priority;
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL nixOpenALSource_isVirtual(STNixSourceRef ref){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        r = NixOpenALSource_isVirtual(obj);
+    }
+    return r;
+}
+
+NixBOOL nixOpenALSource_playAt(STNixSourceRef ref, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->eng != NULL){
+            const NixUI64 usAt = NixEngineClock_frameToUs(&obj->eng->clock, engFrame);
+            const NixUI64 usNow = NixClock_getMonotonicUs();
+            if(usAt <= usNow){
+                //already due
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+                {
+                    obj->sched.startUs = 0;
+                    obj->sched.startErr = NixEngineClock_usToFrames(&obj->eng->clock, (NixSI64)(usNow - usAt));
+                    obj->sched.isStartErrSet = NIX_TRUE;
+                }
+                NixMutex_unlock(obj->queues.mutex);
+                nixOpenALSource_play(ref);
+            } else {
+                //applied by tick
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+                {
+                    obj->sched.startUs = usAt;
+                    obj->sched.isStartErrSet = NIX_FALSE;
+                }
+                NixMutex_unlock(obj->queues.mutex);
+                NixOpenALEngine_actvAdd(obj->eng, obj);
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+NixBOOL nixOpenALSource_stopAt(STNixSourceRef ref, const NixUI64 engFrame){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->eng != NULL){
+            const NixUI64 usAt = NixEngineClock_frameToUs(&obj->eng->clock, engFrame);
+            if(usAt <= NixClock_getMonotonicUs()){
+                //already due
+                nixOpenALSource_stop(ref);
+            } else {
+                //applied by tick
+                NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+                {
+                    obj->sched.stopUs = usAt;
+                }
+                NixMutex_unlock(obj->queues.mutex);
+                NixOpenALEngine_actvAdd(obj->eng, obj);
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+NixBOOL nixOpenALSource_getStartError(STNixSourceRef ref, NixSI64* dstFrames){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            if(obj->sched.isStartErrSet){
+                if(dstFrames != NULL){
+                    *dstFrames = obj->sched.startErr;
+                }
+                r = NIX_TRUE;
+            }
+        }
+        NixMutex_unlock(obj->queues.mutex);
+    }
+    return r;
+}
+
+//Counters
+
+NixBOOL nixOpenALSource_getCounters(STNixSourceRef ref, STNixSourceCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesQueued   = obj->counters.queued;
+            dst->framesPlayed   = NIX_ATOMIC_LOAD64(&obj->counters.played) + NixOpenALSource_getPlayedOffsetLocked_(obj);
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+NixBOOL nixOpenALSource_getClock(STNixSourceRef ref, STNixSourceClock* dst){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && dst != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            const NixUI64 usNow = NixClock_getMonotonicUs();
+            const NixBOOL isRunning = (NixOpenALSource_isPlaying(obj) && !NixOpenALSource_isPaused(obj) && !NixOpenALSource_isVirtual(obj));
+            const NixUI64 maxAhead = (isRunning ? (NixUI64)NIX_POS_INTERP_MAX_US * obj->buffsFmt.samplerate / 1000000ull : 0);
+            NixUI64 latencyUs = 0;
+            const NixUI64 reported = NIX_ATOMIC_LOAD64(&obj->counters.played) + NixOpenALSource_getPlayedOffsetAndLatencyLocked_(obj, &latencyUs);
+            dst->framesPlayed   = NixPosInterp_get(&obj->counters.clock, reported, obj->buffsFmt.samplerate, maxAhead, usNow);
+            dst->latencyUs      = latencyUs;
+            dst->timeUs         = usNow;
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
+
+//Low watermark
+
+NixBOOL nixOpenALSource_setLowWatermark(STNixSourceRef ref, const ENNixOffsetType type, const NixUI32 amount, NixSourceNeedsDataFnc callback, void* callbackData){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(!NixOpenALSource_isStatic(obj)){
+            NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+            {
+                NixSourceWatermark_set(&obj->wmark, type, amount, callback, callbackData);
+            }
+            NixMutex_unlock(obj->queues.mutex);
+            if(obj->eng != NULL && NixSourceWatermark_isEnabled(&obj->wmark)){
+                NixOpenALEngine_actvAdd(obj->eng, obj);
+            }
+            r = NIX_TRUE;
+        }
+    }
+    return r;
+}
+
+//Render
+
+NixBOOL nixOpenALSource_setRenderCallback(STNixSourceRef ref, const STNixAudioDesc* fmt, NixSourceRenderFnc callback, void* callbackData){
+    NixBOOL r = NIX_FALSE;
+    if(ref.ptr != NULL && fmt != NULL && fmt->blockAlign > 0 && fmt->samplerate > 0 && callback != NULL){
+        STNixOpenALSource* obj = (STNixOpenALSource*)NixSharedPtr_getOpq(ref.ptr);
+        if(obj->idSourceAL == NIX_OPENAL_NULL || obj->eng == NULL){
+            NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback, no source available.\n");
+        } else if(obj->buffsFmt.blockAlign != 0 || obj->queues.pend.use != 0 || NixOpenALSource_isStatic(obj) || NixOpenALSource_isRender(obj)){
+            NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback, source already has buffers.\n");
+        } else {
+            //device format (16-bits if not compatible with OpenAL)
+            STNixAudioDesc dstFmt = *fmt;
+            ALenum fmtAL = nixOpenALSource_alFormat(fmt);
+            if(fmtAL == AL_UNDETERMINED){
+                dstFmt.bitsPerSample    = 16;
+                dstFmt.samplesFormat    = ENNixSampleFmt_Int;
+                dstFmt.blockAlign       = (dstFmt.bitsPerSample / 8) * dstFmt.channels;
+                fmtAL = nixOpenALSource_alFormat(&dstFmt);
+            }
+            if(fmtAL == AL_UNDETERMINED){
+                NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback, OpenAL unsupported format.\n");
+            } else if(!NixSourceRender_prepare(&obj->render.core, fmt, &dstFmt, callback, callbackData)){
+                NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback, NixSourceRender_prepare failed.\n");
+            } else {
+                NixFmtConverter_setStats(obj->render.core.conv, &obj->eng->stats);
+                obj->buffsFmt   = *fmt;
+                obj->srcFmt     = dstFmt;
+                obj->srcFmtAL   = fmtAL;
+                if(obj->eng->render.alBufferCallbackSOFT != NULL){
+                    //callback buffer (called by the AL mixer)
+                    ALenum errorAL;
+                    alGenBuffers(1, &obj->render.idBufferCbAL);
+                    if(AL_NO_ERROR != (errorAL = alGetError())){
+                        NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback::alGenBuffers failed: #%d '%s'\n", errorAL, alGetString(errorAL));
+                        obj->render.idBufferCbAL = NIX_OPENAL_NULL;
+                    } else {
+                        (*obj->eng->render.alBufferCallbackSOFT)(obj->render.idBufferCbAL, fmtAL, (ALsizei)dstFmt.samplerate, NixOpenALSource_renderCallback_, obj);
+                        alSourcei(obj->idSourceAL, AL_BUFFER, (ALint)obj->render.idBufferCbAL);
+                        if(AL_NO_ERROR != (errorAL = alGetError())){
+                            NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback::alBufferCallbackSOFT failed: #%d '%s'\n", errorAL, alGetString(errorAL));
+                            alSourcei(obj->idSourceAL, AL_BUFFER, AL_NONE);
+                        } else {
+                            r = NIX_TRUE;
+                        }
+                    }
+                } else {
+                    //ring (refilled by tick)
+                    if(NULL == (obj->render.pcm = NixContext_malloc(obj->ctx, NIX_SOURCES_RENDER_BLOCKS * dstFmt.blockAlign, "STNixOpenALSource::render.pcm"))){
+                        NIX_PRINTF_ERROR("nixOpenALSource_setRenderCallback::NixContext_malloc failed.\n");
+                    } else {
+                        NixUI32 i; for(i = 0; i < NIX_OPENAL_RENDER_BUFFERS; i++){
+                            const ALuint idBufferAL = NixOpenALEngine_buffsAcquire(obj->eng, fmtAL, dstFmt.samplerate);
+                            if(idBufferAL == NIX_OPENAL_NULL){
+                                break;
+                            }
+                            obj->render.idsBuffersAL[i] = idBufferAL;
+                            obj->render.idsFree[obj->render.idsFreeUse++] = idBufferAL;
+                        }
+                        r = (i == NIX_OPENAL_RENDER_BUFFERS);
+                    }
+                }
+                //revert
+                if(!r){
+                    NixOpenALSource_renderRelease_(obj);
+                    memset(&obj->buffsFmt, 0, sizeof(obj->buffsFmt));
+                    memset(&obj->srcFmt, 0, sizeof(obj->srcFmt));
+                    obj->srcFmtAL = 0;
+                }
+            }
+        }
+    }
+    return r;
+}
+
 //------
 //Recorder API
 //------
@@ -1965,7 +3782,7 @@ STNixRecorderRef nixOpenALRecorder_alloc(STNixEngineRef pEng, const STNixAudioDe
         //release (if not consumed)
         if(obj != NULL){
             NixOpenALRecorder_destroy(obj);
-            NixContext_mfree(eng->ctx, obj);
+            NIX_RT_MFREE(eng->ctx, obj);
             obj = NULL;
         }
     }
@@ -2046,7 +3863,7 @@ NixUI32 nixOpenALRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* o
         NixOpenALRecorder_consumeInputBuffer(obj);
     }
     //calculate filled buffers
-    NixMutex_lock(obj->queues.mutex);
+    NIX_RT_MUTEX_LOCK(obj->queues.mutex);
     {
         NixUI32 i; for(i = 0; i < obj->queues.notify.use; i++){
             STNixOpenALQueuePair* pair = &obj->queues.notify.arr[0];
@@ -2066,3 +3883,22 @@ NixUI32 nixOpenALRecorder_getBuffersFilledCount(STNixRecorderRef ref, NixUI32* o
     if(optDstMsecsCount != NULL) *optDstMsecsCount = msecsCount;
     return r;
 }
+
+NixBOOL nixOpenALRecorder_getCounters(STNixRecorderRef ref, STNixRecorderCounters* dst){
+    NixBOOL r = NIX_FALSE;
+    STNixOpenALRecorder* obj = (STNixOpenALRecorder*)NixSharedPtr_getOpq(ref.ptr);
+    if(obj != NULL && dst != NULL){
+        //move samples to filled buffer
+        if(obj->engStarted){
+            NixOpenALRecorder_consumeInputBuffer(obj);
+        }
+        NIX_RT_MUTEX_LOCK(obj->queues.mutex);
+        {
+            dst->framesCaptured = obj->counters.captured;
+            dst->timeUs         = NixClock_getMonotonicUs();
+        }
+        NixMutex_unlock(obj->queues.mutex);
+        r = NIX_TRUE;
+    }
+    return r;
+}
@@ -0,0 +1,217 @@
+//
+//  testBufferPool.c
+//  NixtlaDemo
+//
+//  Created by Marcos Ortega on 20/07/25.
+//  Copyright (c) 2014 Marcos Ortega. All rights reserved.
+//
+
+//
+// This test acquires, releases and reformats buffers from a NixBufferPool,
+// validating the reuse by format and capacity, the idle limit, and that
+// the steady state makes no allocations (counted by the context's memory
+// interface). No audio device is required; returns zero on success.
+//
+
+#include "nixaudio/nixtla-audio.h"
+
+#include <stdio.h>  //printf
+#include <stdlib.h> //malloc, realloc, free
+#include <string.h> //memset
+
+#define NIX_TEST_POOL_MAX_IDLE      4       //idle buffers per format
+#define NIX_TEST_POOL_CAPACITY      4096    //bytes per buffer
+#define NIX_TEST_POOL_IN_USE        (NIX_TEST_POOL_MAX_IDLE + 2)
+
+#define NIX_TEST_POOL_CHECK(COND, ...) \
+    if(!(COND)){ printf("ERROR, line %d: ", __LINE__); printf(__VA_ARGS__); printf("\n"); errs++; }
+
+//memory counters
+
+static unsigned long gTestPoolAllocs    = 0;    //calls to malloc (and realloc of NULL)
+static long gTestPoolAlive              = 0;    //blocks not freed yet
+
+static void* NixTestPool_malloc(const NixUI32 newSz, const char* dbgHintStr){
+    void* r = malloc(newSz);
+    (void)dbgHintStr;
+    if(r != NULL){
+        gTestPoolAllocs++;
+        gTestPoolAlive++;
+    }
+    return r;
+}
+
+static void* NixTestPool_realloc(void* ptr, const NixUI32 newSz, const char* dbgHintStr){
+    void* r = realloc(ptr, newSz);
+    (void)dbgHintStr;
+    if(r != NULL && ptr == NULL){
+        gTestPoolAllocs++;
+        gTestPoolAlive++;
+    }
+    return r;
+}
+
+static void NixTestPool_free(void* ptr){
+    if(ptr != NULL){
+        gTestPoolAlive--;
+    }
+    free(ptr);
+}
+
+static NixBOOL NixTestPool_isUnique(const STNixBufferRef* arr, const NixUI32 use){
+    NixUI32 i, j;
+    for(i = 0; i < use; i++){
+        for(j = i + 1; j < use; j++){
+            if(NixBuffer_isSame(arr[i], arr[j])){
+                return NIX_FALSE;
+            }
+        }
+    }
+    return NIX_TRUE;
+}
+
+static NixBOOL NixTestPool_contains(const STNixBufferRef* arr, const NixUI32 use, STNixBufferRef buff){
+    NixUI32 i; for(i = 0; i < use; i++){
+        if(NixBuffer_isSame(arr[i], buff)){
+            return NIX_TRUE;
+        }
+    }
+    return NIX_FALSE;
+}
+
+int main(void){
+    unsigned long errs = 0;
+    STNixContextItf ctxItf;
+    memset(&ctxItf, 0, sizeof(ctxItf));
+    ctxItf.mem.malloc   = NixTestPool_malloc;
+    ctxItf.mem.realloc  = NixTestPool_realloc;
+    ctxItf.mem.free     = NixTestPool_free;
+    NixContextItf_fillMissingMembers(&ctxItf);
+    {
+        STNixContextRef ctx = NixContext_alloc(&ctxItf);
+        if(NixContext_isNull(ctx)){
+            printf("ERROR, NixContext_alloc failed.\n");
+            return -1;
+        } else {
+            STNixAudioDesc stereo = STNixAudioDesc_Zero, mono = STNixAudioDesc_Zero;
+            STNixBufferPoolRef pool = NixBufferPool_alloc(ctx, NIX_TEST_POOL_MAX_IDLE);
+            STNixBufferRef bufs[NIX_TEST_POOL_IN_USE], prev[NIX_TEST_POOL_IN_USE];
+            unsigned long allocsBefore; long aliveBefore;
+            NixUI32 i;
+            memset(bufs, 0, sizeof(bufs));
+            memset(prev, 0, sizeof(prev));
+            stereo.samplesFormat    = ENNixSampleFmt_Int;
+            stereo.channels         = 2;
+            stereo.bitsPerSample    = 16;
+            stereo.samplerate       = 44100;
+            stereo.blockAlign       = 4;
+            mono                    = stereo;
+            mono.channels           = 1;
+            mono.blockAlign         = 2;
+            NIX_TEST_POOL_CHECK(!NixBufferPool_isNull(pool), "NixBufferPool_alloc failed")
+            //prepare (limited by the idle limit)
+            {
+                const NixUI32 added = NixBufferPool_prepare(pool, &stereo, NIX_TEST_POOL_CAPACITY, NIX_TEST_POOL_MAX_IDLE + 3);
+                NIX_TEST_POOL_CHECK(added == NIX_TEST_POOL_MAX_IDLE, "prepare added %u, expected %u", added, NIX_TEST_POOL_MAX_IDLE)
+            }
+            //acquire prepared buffers (no allocations), then beyond the idle ones (allocations)
+            allocsBefore = gTestPoolAllocs;
+            for(i = 0; i < NIX_TEST_POOL_IN_USE; i++){
+                NixUI32 use = 1, sz = 0;
+                bufs[i] = NixBufferPool_acquire(pool, &stereo, NIX_TEST_POOL_CAPACITY);
+                NIX_TEST_POOL_CHECK(!NixBuffer_isNull(bufs[i]), "acquire #%u failed", i)
+                NIX_TEST_POOL_CHECK(NixBuffer_getData(bufs[i], &use, &sz) != NULL && use == 0 && sz >= NIX_TEST_POOL_CAPACITY, "acquire #%u returned use(%u) sz(%u)", i, use, sz)
+                if(i + 1 == NIX_TEST_POOL_MAX_IDLE){
+                    NIX_TEST_POOL_CHECK(gTestPoolAllocs == allocsBefore, "acquiring prepared buffers made %lu allocations", (gTestPoolAllocs - allocsBefore))
+                }
+            }
+            NIX_TEST_POOL_CHECK(gTestPoolAllocs > allocsBefore, "acquiring beyond the prepared buffers made no allocations")
+            NIX_TEST_POOL_CHECK(NixTestPool_isUnique(bufs, NIX_TEST_POOL_IN_USE), "same buffer acquired twice")
+            //fill in place
+            for(i = 0; i < NIX_TEST_POOL_IN_USE; i++){
+                NixUI32 sz = 0;
+                NixUI8* data = NixBuffer_getData(bufs[i], NULL, &sz);
+                if(data != NULL){
+                    memset(data, (int)i, sz);
+                }
+                NIX_TEST_POOL_CHECK(NixBuffer_setDataUse(bufs[i], NIX_TEST_POOL_CAPACITY / 2), "setDataUse #%u failed", i)
+            }
+            //release all (the first ones become idle, the ones above the idle limit are destroyed)
+            aliveBefore = gTestPoolAlive;
+            for(i = 0; i < NIX_TEST_POOL_IN_USE; i++){
+                prev[i] = bufs[i];
+                NixBuffer_release(&bufs[i]);
+                NixBuffer_null(&bufs[i]);
+            }
+            NIX_TEST_POOL_CHECK(gTestPoolAlive < aliveBefore, "buffers above the idle limit were not destroyed")
+            //steady state: acquire/release cycles reuse the idle buffers (empty) without allocations
+            allocsBefore = gTestPoolAllocs;
+            {
+                NixUI32 cycle; for(cycle = 0; cycle < 16; cycle++){
+                    for(i = 0; i < NIX_TEST_POOL_MAX_IDLE; i++){
+                        NixUI32 use = 1;
+                        bufs[i] = NixBufferPool_acquire(pool, &stereo, NIX_TEST_POOL_CAPACITY);
+                        NixBuffer_getData(bufs[i], &use, NULL);
+                        NIX_TEST_POOL_CHECK(use == 0, "reused buffer is not empty, use(%u)", use)
+                        NIX_TEST_POOL_CHECK(NixTestPool_contains(prev, NIX_TEST_POOL_MAX_IDLE, bufs[i]), "idle buffer was not reused")
+                        NixBuffer_setDataUse(bufs[i], NIX_TEST_POOL_CAPACITY);
+                    }
+                    for(i = 0; i < NIX_TEST_POOL_MAX_IDLE; i++){
+                        NixBuffer_release(&bufs[i]);
+                        NixBuffer_null(&bufs[i]);
+                    }
+                }
+            }
+            NIX_TEST_POOL_CHECK(gTestPoolAllocs == allocsBefore, "steady state made %lu allocations", (gTestPoolAllocs - allocsBefore))
+            //other format and other capacity are not mixed with the idle ones
+            bufs[0] = NixBufferPool_acquire(pool, &mono, NIX_TEST_POOL_CAPACITY);
+            bufs[1] = NixBufferPool_acquire(pool, &stereo, NIX_TEST_POOL_CAPACITY * 2);
+            NIX_TEST_POOL_CHECK(!NixBuffer_isNull(bufs[0]) && !NixTestPool_contains(prev, NIX_TEST_POOL_MAX_IDLE, bufs[0]), "other format got a stereo buffer")
+            NIX_TEST_POOL_CHECK(!NixBuffer_isNull(bufs[1]) && !NixTestPool_contains(prev, NIX_TEST_POOL_MAX_IDLE, bufs[1]), "other capacity got a smaller buffer")
+            prev[0] = bufs[0];
+            NixBuffer_release(&bufs[0]);
+            NixBuffer_release(&bufs[1]);
+            NixBuffer_null(&bufs[0]);
+            NixBuffer_null(&bufs[1]);
+            bufs[0] = NixBufferPool_acquire(pool, &mono, NIX_TEST_POOL_CAPACITY);
+            NIX_TEST_POOL_CHECK(NixBuffer_isSame(bufs[0], prev[0]), "mono buffer was not reused")
+            NixBuffer_release(&bufs[0]);
+            NixBuffer_null(&bufs[0]);
+            //reformatted buffers are destroyed instead of pooled
+            {
+                STNixBufferRef b = NixBufferPool_acquire(pool, &stereo, NIX_TEST_POOL_CAPACITY);
+                NIX_TEST_POOL_CHECK(NixBuffer_setData(b, &mono, NULL, NIX_TEST_POOL_CAPACITY / 4), "setData (reformat) failed")
+                aliveBefore = gTestPoolAlive;
+                NixBuffer_release(&b);
+                NixBuffer_null(&b);
+                NIX_TEST_POOL_CHECK(gTestPoolAlive < aliveBefore, "reformatted buffer was not destroyed")
+                //one idle stereo buffer less: the last acquire allocates
+                allocsBefore = gTestPoolAllocs;
+                for(i = 0; i < NIX_TEST_POOL_MAX_IDLE; i++){
+                    bufs[i] = NixBufferPool_acquire(pool, &stereo, NIX_TEST_POOL_CAPACITY);
+                    if(i + 2 == NIX_TEST_POOL_MAX_IDLE){
+                        NIX_TEST_POOL_CHECK(gTestPoolAllocs == allocsBefore, "idle stereo buffers made allocations")
+                    }
+                }
+                NIX_TEST_POOL_CHECK(gTestPoolAllocs > allocsBefore, "reformatted buffer is still in the pool")
+            }
+            //buffers in use keep the pool alive
+            NixBufferPool_release(&pool);
+            NixBufferPool_null(&pool);
+            for(i = 0; i < NIX_TEST_POOL_MAX_IDLE; i++){
+                NixUI32 sz = 0;
+                NixUI8* data = NixBuffer_getData(bufs[i], NULL, &sz);
+                if(data != NULL){
+                    memset(data, 0, sz);
+                }
+                NixBuffer_release(&bufs[i]);
+                NixBuffer_null(&bufs[i]);
+            }
+            NixContext_release(&ctx);
+            NixContext_null(&ctx);
+            NIX_TEST_POOL_CHECK(gTestPoolAlive == 0, "%ld blocks leaked", gTestPoolAlive)
+        }
+    }
+    printf("%lu errors, %s\n", errs, (errs == 0 ? "PASSED" : "FAILED"));
+    return (errs == 0 ? 0 : -1);
+}
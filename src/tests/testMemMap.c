@@ -0,0 +1,265 @@
+//
+//  testMemMap.c
+//  NixtlaDemo
+//
+//  Created by Marcos Ortega on 20/07/25.
+//  Copyright (c) 2014 Marcos Ortega. All rights reserved.
+//
+
+//
+// This test inserts and removes pointers in the NixMemBlocks index
+// using colliding and wrap-around (end of hash table) patterns, and
+// validates 'findExact' and 'findContainer' against a linear scan.
+// No audio device is required; returns zero on success.
+//
+
+#include "../utils/NixMemMap.h"
+
+#include <stdio.h>  //printf
+#include <stdlib.h> //malloc, free
+#include <string.h> //memset
+#include <stdint.h> //uintptr_t
+
+#define NIX_TEST_MEM_BASE           ((uintptr_t)0x10000000u) //fake pointers (never dereferenced)
+#define NIX_TEST_MEM_STRIDE         64      //distance between fake pointers
+#define NIX_TEST_MEM_BYTES          32      //block size (gap between blocks)
+#define NIX_TEST_MEM_GROUP_SZ       24      //pointers per home slot
+#define NIX_TEST_MEM_GROWTH_SZ      5000    //forces the hash to grow
+#define NIX_TEST_MEM_PTR(IDX)       ((void*)(NIX_TEST_MEM_BASE + ((uintptr_t)(IDX) * NIX_TEST_MEM_STRIDE)))
+
+//shadow record (reference for the linear scan)
+
+typedef struct STNixTestMemRec_ {
+    void*           pointer;
+    unsigned long   bytes;
+    int             isUsed;
+} STNixTestMemRec;
+
+typedef struct STNixTestMemShadow_ {
+    STNixTestMemRec* arr;
+    unsigned long   use;
+    unsigned long   sz;
+} STNixTestMemShadow;
+
+static STNixTestMemRec* NixTestMemShadow_findExact(STNixTestMemShadow* obj, void* pointer){
+    unsigned long i; for(i = 0; i < obj->use; i++){
+        STNixTestMemRec* r = &obj->arr[i];
+        if(r->isUsed && r->pointer == pointer){
+            return r;
+        }
+    }
+    return NULL;
+}
+
+//same semantics as the index: exact match, or the last block starting before 'pointer' if it reaches it
+static STNixTestMemRec* NixTestMemShadow_findContainer(STNixTestMemShadow* obj, void* pointer){
+    STNixTestMemRec* r = NixTestMemShadow_findExact(obj, pointer);
+    if(r == NULL){
+        unsigned long i; for(i = 0; i < obj->use; i++){
+            STNixTestMemRec* b = &obj->arr[i];
+            if(b->isUsed && b->pointer <= pointer && (r == NULL || r->pointer < b->pointer)){
+                r = b;
+            }
+        }
+        if(r != NULL && pointer > (void*)((char*)r->pointer + r->bytes)){
+            r = NULL;
+        }
+    }
+    return r;
+}
+
+static int NixTestMem_add(STNixMemBlocks* blocks, STNixTestMemShadow* shadow, void* pointer, const unsigned long bytes){
+    if(shadow->use >= shadow->sz){
+        printf("ERROR, shadow is full.\n");
+        return 0;
+    }
+    if(NixMemBlocks_add(blocks, pointer, bytes, 0) == NULL){
+        printf("ERROR, NixMemBlocks_add failed for %p.\n", pointer);
+        return 0;
+    }
+    {
+        STNixTestMemRec* r = &shadow->arr[shadow->use++];
+        r->pointer  = pointer;
+        r->bytes    = bytes;
+        r->isUsed   = 1;
+    }
+    return 1;
+}
+
+static int NixTestMem_remove(STNixMemBlocks* blocks, STNixTestMemRec* r){
+    STNixMemBlock* b = NixMemBlocks_findExact(blocks, r->pointer);
+    if(b == NULL){
+        printf("ERROR, %p not found for removal.\n", r->pointer);
+        return 0;
+    }
+    NixMemBlocks_remove(blocks, b);
+    r->isUsed = 0;
+    return 1;
+}
+
+//removes every 'step'-th alive record (starting at 'offset')
+static int NixTestMem_removeEvery(STNixMemBlocks* blocks, STNixTestMemShadow* shadow, const unsigned long step, const unsigned long offset){
+    unsigned long i, iAlive = 0;
+    for(i = 0; i < shadow->use; i++){
+        STNixTestMemRec* r = &shadow->arr[i];
+        if(r->isUsed){
+            if((iAlive % step) == offset && !NixTestMem_remove(blocks, r)){
+                return 0;
+            }
+            iAlive++;
+        }
+    }
+    return 1;
+}
+
+//compares the index against the linear scan, for every known pointer and its neighbourhood
+static int NixTestMem_validate(STNixMemBlocks* blocks, STNixTestMemShadow* shadow, const char* phase){
+    unsigned long i, errs = 0, ammAlive = 0, ammProbes = 0;
+    for(i = 0; i < shadow->use; i++){
+        const STNixTestMemRec* r = &shadow->arr[i];
+        void* probes[5];
+        probes[0] = r->pointer;
+        probes[1] = (void*)((char*)r->pointer + (r->bytes / 2));
+        probes[2] = (void*)((char*)r->pointer + r->bytes);
+        probes[3] = (void*)((char*)r->pointer + r->bytes + 1);
+        probes[4] = (void*)((char*)r->pointer - 1);
+        if(r->isUsed){
+            ammAlive++;
+        }
+        {
+            unsigned long p; for(p = 0; p < (sizeof(probes) / sizeof(probes[0])); p++){
+                STNixMemBlock* bExact = NixMemBlocks_findExact(blocks, probes[p]);
+                STNixMemBlock* bCont = NixMemBlocks_findContainer(blocks, probes[p]);
+                STNixTestMemRec* sExact = NixTestMemShadow_findExact(shadow, probes[p]);
+                STNixTestMemRec* sCont = NixTestMemShadow_findContainer(shadow, probes[p]);
+                if((bExact == NULL) != (sExact == NULL) || (bExact != NULL && bExact->pointer != sExact->pointer)){
+                    if(errs++ < 8){
+                        printf("ERROR, %s: findExact(%p) returned %p, expected %p.\n", phase, probes[p], (bExact != NULL ? bExact->pointer : NULL), (sExact != NULL ? sExact->pointer : NULL));
+                    }
+                }
+                if((bCont == NULL) != (sCont == NULL) || (bCont != NULL && bCont->pointer != sCont->pointer)){
+                    if(errs++ < 8){
+                        printf("ERROR, %s: findContainer(%p) returned %p, expected %p.\n", phase, probes[p], (bCont != NULL ? bCont->pointer : NULL), (sCont != NULL ? sCont->pointer : NULL));
+                    }
+                }
+                ammProbes++;
+            }
+        }
+    }
+    if(blocks->hash.use != ammAlive){
+        printf("ERROR, %s: hash holds %lu pointers, expected %lu.\n", phase, blocks->hash.use, ammAlive);
+        errs++;
+    }
+    printf("%s: %lu alive, %lu probes, hash %lu/%lu, %lu errors.\n", phase, ammAlive, ammProbes, blocks->hash.use, blocks->hash.sz, errs);
+    return (errs == 0);
+}
+
+//returns the hash slot where 'pointer' lands when inserted into an empty index
+static unsigned long NixTestMem_homeSlot(STNixMemBlocks* empty, void* pointer){
+    unsigned long r = (unsigned long)-1;
+    STNixMemBlock* b = NixMemBlocks_add(empty, pointer, 1, 0);
+    if(b != NULL){
+        unsigned long i; for(i = 0; i < empty->hash.sz; i++){
+            if(empty->hash.arr[i] != 0){
+                r = i;
+                break;
+            }
+        }
+        NixMemBlocks_remove(empty, b);
+    }
+    return r;
+}
+
+int main(void){
+    int r = 0;
+    STNixMemBlocks blocks;
+    STNixTestMemShadow shadow;
+    NixMemBlocks_init(&blocks);
+    memset(&shadow, 0, sizeof(shadow));
+    shadow.sz   = (NIX_TEST_MEM_GROUP_SZ * 4) + NIX_TEST_MEM_GROWTH_SZ;
+    shadow.arr  = (STNixTestMemRec*)malloc(sizeof(shadow.arr[0]) * shadow.sz);
+    if(shadow.arr == NULL){
+        printf("ERROR, malloc failed.\n");
+        return -1;
+    }
+    //find pointers that collide at the last two and first two slots (probing wraps around the table's end)
+    {
+        STNixMemBlocks empty;
+        unsigned long hashSz, homes[4], founds[4] = { 0, 0, 0, 0 }, iCandidate = 0, ammFound = 0;
+        void* groups[4][NIX_TEST_MEM_GROUP_SZ];
+        NixMemBlocks_init(&empty);
+        NixTestMem_homeSlot(&empty, NIX_TEST_MEM_PTR(0)); //allocates the initial table
+        hashSz      = empty.hash.sz;
+        homes[0]    = hashSz - 2;
+        homes[1]    = hashSz - 1;
+        homes[2]    = 0;
+        homes[3]    = 1;
+        while(ammFound < (NIX_TEST_MEM_GROUP_SZ * 4) && iCandidate < (hashSz * NIX_TEST_MEM_GROUP_SZ * 64)){
+            void* ptr = NIX_TEST_MEM_PTR(iCandidate);
+            const unsigned long iHome = NixTestMem_homeSlot(&empty, ptr);
+            unsigned long g; for(g = 0; g < 4; g++){
+                if(iHome == homes[g] && founds[g] < NIX_TEST_MEM_GROUP_SZ){
+                    groups[g][founds[g]++] = ptr;
+                    ammFound++;
+                    break;
+                }
+            }
+            iCandidate++;
+        }
+        NixMemBlocks_destroy(&empty);
+        if(ammFound < (NIX_TEST_MEM_GROUP_SZ * 4)){
+            printf("ERROR, only %lu colliding pointers found after %lu candidates.\n", ammFound, iCandidate);
+            r = -1;
+        } else {
+            printf("Collisions: %lu pointers at slots %lu, %lu, 0 and 1 of %lu (%lu candidates).\n", ammFound, homes[0], homes[1], hashSz, iCandidate);
+            //insert interleaved, so each cluster is built across the table's end
+            {
+                unsigned long i, g;
+                for(i = 0; i < NIX_TEST_MEM_GROUP_SZ && r == 0; i++){
+                    for(g = 0; g < 4 && r == 0; g++){
+                        if(!NixTestMem_add(&blocks, &shadow, groups[g][i], NIX_TEST_MEM_BYTES)){
+                            r = -1;
+                        }
+                    }
+                }
+            }
+            if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "collisions-added")) r = -1;
+            if(r == 0 && (blocks.hash.sz != hashSz || !NixTestMem_removeEvery(&blocks, &shadow, 2, 1))) r = -1;
+            if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "collisions-removed-odd")) r = -1;
+            if(r == 0 && !NixTestMem_removeEvery(&blocks, &shadow, 3, 0)) r = -1;
+            if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "collisions-removed-third")) r = -1;
+            //re-add the removed ones (records and slots are reused)
+            if(r == 0){
+                unsigned long i; const unsigned long use = shadow.use;
+                for(i = 0; i < use && r == 0; i++){
+                    if(!shadow.arr[i].isUsed){
+                        if(NixMemBlocks_add(&blocks, shadow.arr[i].pointer, shadow.arr[i].bytes, 0) == NULL){
+                            r = -1;
+                        } else {
+                            shadow.arr[i].isUsed = 1;
+                        }
+                    }
+                }
+            }
+            if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "collisions-readded")) r = -1;
+        }
+    }
+    //growth (rehash with the clusters inside), then mixed removals
+    if(r == 0){
+        const uintptr_t iFirst = ((uintptr_t)1 << 24); //after the candidates range
+        unsigned long i; for(i = 0; i < NIX_TEST_MEM_GROWTH_SZ && r == 0; i++){
+            if(!NixTestMem_add(&blocks, &shadow, NIX_TEST_MEM_PTR(iFirst + i), NIX_TEST_MEM_BYTES)){
+                r = -1;
+            }
+        }
+        if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "growth-added")) r = -1;
+        if(r == 0 && !NixTestMem_removeEvery(&blocks, &shadow, 3, 1)) r = -1;
+        if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "growth-removed-third")) r = -1;
+        if(r == 0 && !NixTestMem_removeEvery(&blocks, &shadow, 1, 0)) r = -1;
+        if(r == 0 && !NixTestMem_validate(&blocks, &shadow, "growth-removed-all")) r = -1;
+    }
+    NixMemBlocks_destroy(&blocks);
+    free(shadow.arr);
+    printf("%s\n", (r == 0 ? "PASSED" : "FAILED"));
+    return r;
+}
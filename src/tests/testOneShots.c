@@ -0,0 +1,333 @@
+//
+//  testOneShots.c
+//  NixtlaDemo
+//
+//  Created by Marcos Ortega on 20/07/25.
+//  Copyright (c) 2014 Marcos Ortega. All rights reserved.
+//
+
+//
+// This test plays one-shots on a stub engine (no audio device) with
+// random volumes, priorities, limits and steal policies, and validates
+// the voices stolen or rejected by NixOneShots against a reference model.
+// Also plays short one-shots to completion, validating that the voices
+// left paused at the end of their buffer (like AAudio does) are reclaimed.
+// Returns zero on success.
+//
+
+#include "nixaudio/nixtla-audio.h"
+
+#include <stdio.h>  //printf
+#include <stdlib.h> //rand, srand
+#include <string.h> //memset
+
+#define NIX_TEST_ONESHOTS_OPS       5000    //random operations per policy
+#define NIX_TEST_ONESHOTS_SRCS_MAX  NIX_TEST_ONESHOTS_OPS   //voices per policy (at most one per operation)
+
+//stub source (records are never reused, to validate the final state of each voice)
+
+typedef struct STNixTestVoice_ {
+    NixBOOL     isPlaying;
+    NixBOOL     isPaused;
+    NixBOOL     isReleased;
+    NixUI64     framesQueued;
+    NixUI64     framesPlayed;
+    NixFLOAT    vol;
+    NixUI8      priority;
+    NixUI32     seq;        //play order (model)
+} STNixTestVoice;
+
+static STNixTestVoice gTestVoices[NIX_TEST_ONESHOTS_SRCS_MAX];
+static NixUI32 gTestVoicesUse = 0;
+static STNixContextRef gTestCtx = STNixContextRef_Zero;
+static STNixSourceItf gTestSrcItf;
+
+static STNixTestVoice* NixTestVoice_get(STNixSourceRef ref){
+    return (STNixTestVoice*)NixSharedPtr_getOpq(ref.ptr);
+}
+
+static void NixTestVoice_free(STNixSourceRef ref){
+    STNixTestVoice* v = NixTestVoice_get(ref);
+    v->isReleased = NIX_TRUE;
+    NixSharedPtr_free(ref.ptr);
+}
+
+static NixBOOL NixTestVoice_setVolume(STNixSourceRef ref, const float vol){ NixTestVoice_get(ref)->vol = vol; return NIX_TRUE; }
+static NixBOOL NixTestVoice_setPriority(STNixSourceRef ref, const NixUI8 priority){ NixTestVoice_get(ref)->priority = priority; return NIX_TRUE; }
+static NixBOOL NixTestVoice_setBuffer(STNixSourceRef ref, STNixBufferRef buff){
+    NixUI32 use = 0;
+    NixBuffer_getData(buff, &use, NULL);
+    NixTestVoice_get(ref)->framesQueued = use / 2; //mono 16-bits
+    return !NixBuffer_isNull(buff);
+}
+static void NixTestVoice_play(STNixSourceRef ref){ NixTestVoice_get(ref)->isPlaying = NIX_TRUE; }
+static void NixTestVoice_stop(STNixSourceRef ref){ NixTestVoice_get(ref)->isPlaying = NIX_FALSE; }
+static NixBOOL NixTestVoice_isPlaying(STNixSourceRef ref){ return NixTestVoice_get(ref)->isPlaying; }
+static NixBOOL NixTestVoice_isPaused(STNixSourceRef ref){ return NixTestVoice_get(ref)->isPaused; }
+
+static NixBOOL NixTestVoice_getCounters(STNixSourceRef ref, STNixSourceCounters* dst){
+    const STNixTestVoice* v = NixTestVoice_get(ref);
+    dst->framesQueued   = v->framesQueued;
+    dst->framesPlayed   = v->framesPlayed;
+    dst->timeUs         = 0;
+    return NIX_TRUE;
+}
+
+//consumes frames of a static source, pausing it at the end of the buffer (as AAudio does)
+static void NixTestVoice_render(STNixTestVoice* v, const NixUI64 frames){
+    v->framesPlayed += frames;
+    if(v->framesPlayed >= v->framesQueued){
+        v->framesPlayed = v->framesQueued;
+        v->isPaused = NIX_TRUE;
+    }
+}
+
+static STNixSourceRef NixTestEngine_allocSource(STNixEngineRef ref){
+    STNixSourceRef r = STNixSourceRef_Zero;
+    (void)ref;
+    if(gTestVoicesUse < NIX_TEST_ONESHOTS_SRCS_MAX){
+        STNixTestVoice* v = &gTestVoices[gTestVoicesUse];
+        if(NULL != (r.ptr = NixSharedPtr_alloc(gTestCtx.itf, v, "NixTestEngine_allocSource"))){
+            memset(v, 0, sizeof(*v));
+            r.itf = &gTestSrcItf;
+            gTestVoicesUse++;
+        }
+    }
+    return r;
+}
+
+//reference model (voices playing, in any order)
+
+typedef struct STNixTestModel_ {
+    NixUI32             ids[NIX_TEST_ONESHOTS_SRCS_MAX];
+    NixUI32             use;
+    NixUI32             max;
+    ENNixOneShotSteal   steal;
+    NixUI32             seq;
+} STNixTestModel;
+
+static void NixTestModel_removeAt(STNixTestModel* obj, const NixUI32 idx){
+    obj->ids[idx] = obj->ids[--obj->use];
+}
+
+static NixUI32 NixTestModel_oldestIdx(const STNixTestModel* obj){
+    NixUI32 i, r = 0;
+    for(i = 1; i < obj->use; i++){
+        if(gTestVoices[obj->ids[i]].seq < gTestVoices[obj->ids[r]].seq){
+            r = i;
+        }
+    }
+    return r;
+}
+
+//returns the index to steal, or -1 to reject
+static int NixTestModel_stealIdx(const STNixTestModel* obj, const NixUI8 priority){
+    int r = -1;
+    NixUI32 i;
+    if(obj->steal == ENNixOneShotSteal_None || obj->use == 0){
+        return -1;
+    }
+    r = (int)NixTestModel_oldestIdx(obj);
+    for(i = 0; i < obj->use; i++){
+        const STNixTestVoice* v = &gTestVoices[obj->ids[i]];
+        const STNixTestVoice* b = &gTestVoices[obj->ids[r]];
+        if(obj->steal == ENNixOneShotSteal_Quietest){
+            if(v->vol < b->vol || (v->vol == b->vol && v->seq < b->seq)) r = (int)i;
+        } else if(obj->steal == ENNixOneShotSteal_LowerPriority){
+            if(v->priority < b->priority || (v->priority == b->priority && v->seq < b->seq)) r = (int)i;
+        }
+    }
+    if(obj->steal == ENNixOneShotSteal_LowerPriority && gTestVoices[obj->ids[r]].priority > priority){
+        r = -1;
+    }
+    return r;
+}
+
+//compares the stub voices against the model
+static NixUI32 NixTestModel_validate(const STNixTestModel* obj, const char* what, const NixUI32 iOp){
+    NixUI32 i, errs = 0, ammPlaying = 0;
+    for(i = 0; i < gTestVoicesUse; i++){
+        const STNixTestVoice* v = &gTestVoices[i];
+        NixBOOL isInModel = NIX_FALSE;
+        NixUI32 j; for(j = 0; j < obj->use; j++){
+            if(obj->ids[j] == i){
+                isInModel = NIX_TRUE;
+                break;
+            }
+        }
+        if(isInModel != (v->isPlaying && !v->isReleased) || (!isInModel && !v->isReleased)){
+            if(errs++ < 4){
+                printf("ERROR, op #%u (%s): voice #%u playing(%d) released(%d), expected %s.\n", iOp, what, i, v->isPlaying, v->isReleased, (isInModel ? "playing" : "stopped and released"));
+            }
+        }
+        if(v->isPlaying && !v->isReleased){
+            ammPlaying++;
+        }
+    }
+    if(obj->max > 0 && ammPlaying > obj->max){
+        printf("ERROR, op #%u (%s): %u voices playing, limit is %u.\n", iOp, what, ammPlaying, obj->max);
+        errs++;
+    }
+    return errs;
+}
+
+int main(void){
+    static const NixFLOAT vols[] = { 0.25f, 0.5f, 0.75f, 1.0f }; //few values, to force ties
+    static const char* stealNames[] = { "None", "Oldest", "Quietest", "LowerPriority" };
+    NixUI32 errs = 0;
+    STNixContextItf ctxItf = NixContextItf_getDefault();
+    STNixEngineItf engItf;
+    STNixEngineRef eng = STNixEngineRef_Zero;
+    STNixBufferPoolRef pool = STNixBufferPoolRef_Zero;
+    STNixBufferRef buff = STNixBufferRef_Zero;
+    STNixAudioDesc desc = STNixAudioDesc_Zero;
+    //stub engine and sources
+    memset(&engItf, 0, sizeof(engItf));
+    engItf.allocSource = NixTestEngine_allocSource;
+    NixEngineItf_fillMissingMembers(&engItf);
+    eng.itf = &engItf;
+    memset(&gTestSrcItf, 0, sizeof(gTestSrcItf));
+    gTestSrcItf.free        = NixTestVoice_free;
+    gTestSrcItf.setVolume   = NixTestVoice_setVolume;
+    gTestSrcItf.setPriority = NixTestVoice_setPriority;
+    gTestSrcItf.setBuffer   = NixTestVoice_setBuffer;
+    gTestSrcItf.play        = NixTestVoice_play;
+    gTestSrcItf.stop        = NixTestVoice_stop;
+    gTestSrcItf.isPlaying   = NixTestVoice_isPlaying;
+    gTestSrcItf.isPaused    = NixTestVoice_isPaused;
+    gTestSrcItf.getCounters = NixTestVoice_getCounters;
+    NixSourceItf_fillMissingMembers(&gTestSrcItf);
+    //buffer
+    gTestCtx = NixContext_alloc(&ctxItf);
+    desc.samplesFormat  = ENNixSampleFmt_Int;
+    desc.channels       = 1;
+    desc.bitsPerSample  = 16;
+    desc.samplerate     = 22050;
+    desc.blockAlign     = 2;
+    pool = NixBufferPool_alloc(gTestCtx, 1);
+    buff = NixBufferPool_acquire(pool, &desc, 256);
+    if(NixBuffer_isNull(buff) || !NixBuffer_setDataUse(buff, 256)){
+        printf("ERROR, NixBufferPool_acquire failed.\n");
+        return -1;
+    }
+    srand(1234);
+    {
+        NixUI32 iSteal; for(iSteal = 0; iSteal < ENNixOneShotSteal_Count; iSteal++){
+            static STNixTestModel model;
+            STNixOneShots shots;
+            NixUI32 iOp, ammStolen = 0, ammRejected = 0, errsBefore = errs;
+            memset(&model, 0, sizeof(model));
+            NixOneShots_init(gTestCtx, &shots);
+            model.max   = 3;
+            model.steal = (ENNixOneShotSteal)iSteal;
+            if(!NixOneShots_setLimit(&shots, model.max, model.steal)){
+                printf("ERROR, NixOneShots_setLimit failed.\n");
+                errs++;
+            }
+            for(iOp = 0; iOp < NIX_TEST_ONESHOTS_OPS && (errs - errsBefore) == 0; iOp++){
+                const int action = rand() % 100;
+                if(action < 70){
+                    //play
+                    const NixFLOAT vol = vols[rand() % (sizeof(vols) / sizeof(vols[0]))];
+                    const NixUI8 priority = (NixUI8)(rand() % 4);
+                    const NixUI32 iNew = gTestVoicesUse;
+                    NixBOOL expected = NIX_TRUE, played;
+                    if(model.max > 0 && model.use >= model.max){
+                        const int iVictim = NixTestModel_stealIdx(&model, priority);
+                        if(iVictim < 0){
+                            expected = NIX_FALSE;
+                            ammRejected++;
+                        } else {
+                            NixTestModel_removeAt(&model, (NixUI32)iVictim);
+                            ammStolen++;
+                        }
+                    }
+                    played = NixOneShots_play(&shots, eng, buff, vol, priority);
+                    if(played != expected){
+                        printf("ERROR, op #%u (play): returned %d, expected %d.\n", iOp, played, expected);
+                        errs++;
+                    }
+                    if(played && iNew < gTestVoicesUse){
+                        gTestVoices[iNew].seq = model.seq++;
+                        model.ids[model.use++] = iNew;
+                    }
+                    errs += NixTestModel_validate(&model, "play", iOp);
+                } else if(action < 90){
+                    //a voice ends, then the tick releases it
+                    if(model.use > 0){
+                        const NixUI32 idx = (NixUI32)rand() % model.use;
+                        gTestVoices[model.ids[idx]].isPlaying = NIX_FALSE;
+                        NixTestModel_removeAt(&model, idx);
+                    }
+                    NixOneShots_tick(&shots);
+                    errs += NixTestModel_validate(&model, "tick", iOp);
+                } else {
+                    //new limit (zero is unlimited), extra voices are stopped oldest first
+                    model.max = (NixUI32)(rand() % 6);
+                    if(!NixOneShots_setLimit(&shots, model.max, model.steal)){
+                        printf("ERROR, op #%u: NixOneShots_setLimit failed.\n", iOp);
+                        errs++;
+                    }
+                    while(model.max > 0 && model.use > model.max){
+                        NixTestModel_removeAt(&model, NixTestModel_oldestIdx(&model));
+                    }
+                    errs += NixTestModel_validate(&model, "setLimit", iOp);
+                }
+            }
+            NixOneShots_destroy(&shots);
+            //every voice is released
+            {
+                NixUI32 i; for(i = 0; i < gTestVoicesUse; i++){
+                    if(!gTestVoices[i].isReleased){
+                        printf("ERROR, voice #%u not released after destroy.\n", i);
+                        errs++;
+                        break;
+                    }
+                }
+            }
+            printf("%s: %u voices, %u stolen, %u rejected, %u errors.\n", stealNames[iSteal], gTestVoicesUse, ammStolen, ammRejected, (errs - errsBefore));
+            gTestVoicesUse = 0;
+        }
+    }
+    //short one-shots played to completion are reclaimed (even if the backend keeps them paused)
+    {
+        STNixOneShots shots;
+        NixUI32 i, errsBefore = errs;
+        NixOneShots_init(gTestCtx, &shots);
+        NixOneShots_setLimit(&shots, 4, ENNixOneShotSteal_None);
+        for(i = 0; i < 4; i++){
+            if(!NixOneShots_play(&shots, eng, buff, 1.0f, 0)){
+                printf("ERROR, completion: play #%u failed.\n", i);
+                errs++;
+            }
+        }
+        //voice #0 and #1 end, voice #2 is half played, voice #3 is paused before its end
+        NixTestVoice_render(&gTestVoices[0], gTestVoices[0].framesQueued);
+        NixTestVoice_render(&gTestVoices[1], 16);
+        NixTestVoice_render(&gTestVoices[1], gTestVoices[1].framesQueued);
+        NixTestVoice_render(&gTestVoices[2], gTestVoices[2].framesQueued / 2);
+        NixTestVoice_render(&gTestVoices[3], 1);
+        gTestVoices[3].isPaused = NIX_TRUE;
+        NixOneShots_tick(&shots);
+        if(shots.use != 2 || !gTestVoices[0].isReleased || !gTestVoices[1].isReleased || gTestVoices[2].isReleased || gTestVoices[3].isReleased){
+            printf("ERROR, completion: %u voices after tick, expected 2 (released: %d %d %d %d).\n", shots.use, gTestVoices[0].isReleased, gTestVoices[1].isReleased, gTestVoices[2].isReleased, gTestVoices[3].isReleased);
+            errs++;
+        }
+        //the reclaimed voices are available again (steal is 'None')
+        if(!NixOneShots_play(&shots, eng, buff, 1.0f, 0) || !NixOneShots_play(&shots, eng, buff, 1.0f, 0) || NixOneShots_play(&shots, eng, buff, 1.0f, 0)){
+            printf("ERROR, completion: reclaimed voices were not reused.\n");
+            errs++;
+        }
+        NixOneShots_destroy(&shots);
+        printf("Completion: %u voices, %u errors.\n", gTestVoicesUse, (errs - errsBefore));
+        gTestVoicesUse = 0;
+    }
+    NixBuffer_release(&buff);
+    NixBuffer_null(&buff);
+    NixBufferPool_release(&pool);
+    NixBufferPool_null(&pool);
+    NixContext_release(&gTestCtx);
+    NixContext_null(&gTestCtx);
+    printf("%s\n", (errs == 0 ? "PASSED" : "FAILED"));
+    return (errs == 0 ? 0 : -1);
+}
@@ -12,6 +12,55 @@
 
 #include "../utils/NixMemMap.h"
 
+#if !defined(NIX_MUTEX_T) || !defined(NIX_MUTEX_INIT) || !defined(NIX_MUTEX_DESTROY) || !defined(NIX_MUTEX_LOCK) || !defined(NIX_MUTEX_UNLOCK)
+#   ifdef _WIN32
+//#     define WIN32_LEAN_AND_MEAN
+#       include <windows.h>             //for CRITICAL_SECTION
+#       define NIX_MUTEX_T              CRITICAL_SECTION
+#       define NIX_MUTEX_INIT(PTR)      InitializeCriticalSection(PTR)
+#       define NIX_MUTEX_DESTROY(PTR)   DeleteCriticalSection(PTR)
+#       define NIX_MUTEX_LOCK(PTR)      EnterCriticalSection(PTR)
+#       define NIX_MUTEX_UNLOCK(PTR)    LeaveCriticalSection(PTR)
+#   else
+#       include <pthread.h>             //for pthread_mutex_t
+#       define NIX_MUTEX_T              pthread_mutex_t
+#       define NIX_MUTEX_INIT(PTR)      pthread_mutex_init(PTR, NULL)
+#       define NIX_MUTEX_DESTROY(PTR)   pthread_mutex_destroy(PTR)
+#       define NIX_MUTEX_LOCK(PTR)      pthread_mutex_lock(PTR)
+#       define NIX_MUTEX_UNLOCK(PTR)    pthread_mutex_unlock(PTR)
+#   endif
+#endif
+
+//global counters (this file does not depend on the library's private header)
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#   define NIX_MEM_ATOMIC_ADD(PTR, V)       ((unsigned long)_InterlockedExchangeAdd((volatile long*)(PTR), (long)(V)) + (unsigned long)(V)) //returns new value
+#   define NIX_MEM_ATOMIC_LOAD(PTR)         ((unsigned long)_InterlockedOr((volatile long*)(PTR), 0))
+#   define NIX_MEM_ATOMIC_CAS(PTR, EXP, V)  (_InterlockedCompareExchange((volatile long*)(PTR), (long)(V), (long)(EXP)) == (long)(EXP))
+#else
+#   define NIX_MEM_ATOMIC_ADD(PTR, V)       __atomic_add_fetch((PTR), (V), __ATOMIC_RELAXED) //returns new value
+#   define NIX_MEM_ATOMIC_LOAD(PTR)         __atomic_load_n((PTR), __ATOMIC_RELAXED)
+#   define NIX_MEM_ATOMIC_CAS(PTR, EXP, V)  NixMem_atomicCas_((PTR), (EXP), (V))
+static int NixMem_atomicCas_(unsigned long* ptr, unsigned long exp, const unsigned long v){ return __atomic_compare_exchange_n(ptr, &exp, v, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED); }
+#endif
+
+//monotonic time (for rates)
+#if defined(_WIN32)
+#   include <windows.h>     //for GetTickCount64
+#   define NIX_MEM_NOW_MS()     ((unsigned long long)GetTickCount64())
+#else
+#   include <time.h>        //for clock_gettime
+#   define NIX_MEM_NOW_MS()     NixMem_nowMs_()
+static unsigned long long NixMem_nowMs_(void){ struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t); return ((unsigned long long)t.tv_sec * 1000ull) + ((unsigned long long)t.tv_nsec / 1000000ull); }
+#endif
+
+static void NixMem_atomicMax_(unsigned long* ptr, const unsigned long v){
+    unsigned long cur = NIX_MEM_ATOMIC_LOAD(ptr);
+    while(cur < v && !NIX_MEM_ATOMIC_CAS(ptr, cur, v)){
+        cur = NIX_MEM_ATOMIC_LOAD(ptr);
+    }
+}
+
 #if defined(__ANDROID__) //Android
 #   include <jni.h>            //for JNIEnv, jobject
 #   include <android/log.h>    //for __android_log_print()
@@ -207,6 +256,125 @@ void NixMemBlock_releasedBy(STNixMemBlock* obj, const unsigned long iStrHint){
 
 //STNixMemBlocks
 
+#define NIX_MEM_HASH_MIN_SZ         1024    //power of two
+#define NIX_MEM_HASH_NOT_FOUND      ((unsigned long)-1)
+
+static unsigned long NixMemBlocks_hashOf_(const void* pointer){
+    size_t h = (size_t)pointer;
+    h = (h >> 4) ^ (h >> 20); //allocations are aligned, ignore the low bits
+    h *= (size_t)0x9E3779B1u; //golden ratio multiplier
+    return (unsigned long)(h ^ (h >> 15));
+}
+
+//returns the hash slot that holds 'pointer' or NIX_MEM_HASH_NOT_FOUND
+static unsigned long NixMemBlocks_hashFind_(STNixMemBlocks* obj, const void* pointer){
+    if(obj->hash.sz > 0){
+        const unsigned long mask = obj->hash.sz - 1;
+        unsigned long iSlot = NixMemBlocks_hashOf_(pointer) & mask;
+        while(obj->hash.arr[iSlot] != 0){
+            const STNixMemBlock* b = &obj->arr[obj->hash.arr[iSlot] - 1];
+            if(b->pointer == pointer){
+                return iSlot;
+            }
+            iSlot = (iSlot + 1) & mask;
+        }
+    }
+    return NIX_MEM_HASH_NOT_FOUND;
+}
+
+static void NixMemBlocks_hashInsert_(STNixMemBlocks* obj, const unsigned long iRec){
+    const unsigned long mask = obj->hash.sz - 1;
+    unsigned long iSlot = NixMemBlocks_hashOf_(obj->arr[iRec].pointer) & mask;
+    while(obj->hash.arr[iSlot] != 0){
+        iSlot = (iSlot + 1) & mask;
+    }
+    obj->hash.arr[iSlot] = iRec + 1;
+    obj->hash.use++;
+}
+
+//backward-shift deletion (keeps probe sequences intact without tombstones)
+static void NixMemBlocks_hashRemoveSlot_(STNixMemBlocks* obj, unsigned long iSlot){
+    const unsigned long mask = obj->hash.sz - 1;
+    unsigned long iNext = (iSlot + 1) & mask;
+    while(obj->hash.arr[iNext] != 0){
+        const unsigned long iHome = NixMemBlocks_hashOf_(obj->arr[obj->hash.arr[iNext] - 1].pointer) & mask;
+        //move the entry back if its home slot is not in the cyclic range (iSlot, iNext]
+        if(((iNext - iHome) & mask) >= ((iNext - iSlot) & mask)){
+            obj->hash.arr[iSlot] = obj->hash.arr[iNext];
+            iSlot = iNext;
+        }
+        iNext = (iNext + 1) & mask;
+    }
+    obj->hash.arr[iSlot] = 0;
+    obj->hash.use--;
+}
+
+//keeps the load factor under 3/4
+static int NixMemBlocks_hashReserve_(STNixMemBlocks* obj, const unsigned long ammUsed){
+    if(((ammUsed + 1) * 4) <= (obj->hash.sz * 3)){
+        return 1;
+    }
+    {
+        unsigned long szN = (obj->hash.sz > 0 ? obj->hash.sz : NIX_MEM_HASH_MIN_SZ);
+        while(((ammUsed + 1) * 4) > (szN * 3)){
+            szN *= 2;
+        }
+        unsigned long* arrN = (unsigned long*)malloc(sizeof(obj->hash.arr[0]) * szN);
+        if(arrN == NULL){
+            return 0;
+        }
+        memset(arrN, 0, sizeof(arrN[0]) * szN);
+        if(obj->hash.arr != NULL){
+            free(obj->hash.arr);
+        }
+        obj->hash.arr   = arrN;
+        obj->hash.sz    = szN;
+        obj->hash.use   = 0;
+        //rehash
+        {
+            unsigned long i; for(i = 0; i < obj->arrUse; i++){
+                if(obj->arr[i].regUsed){
+                    NixMemBlocks_hashInsert_(obj, i);
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+static int NixMemBlocks_sortedCompare_(const void* a, const void* b){
+    const char* pA = (const char*)((const STNixMemBlockPos*)a)->pointer;
+    const char* pB = (const char*)((const STNixMemBlockPos*)b)->pointer;
+    return (pA < pB ? -1 : pA > pB ? 1 : 0);
+}
+
+static int NixMemBlocks_sortedRebuild_(STNixMemBlocks* obj){
+    const unsigned long ammUsed = obj->arrUse - obj->unused.use;
+    if(obj->sorted.sz < ammUsed){
+        unsigned long szN = ((ammUsed + NIX_MEM_PTRS_BLOCKS_SZ - 1) / NIX_MEM_PTRS_BLOCKS_SZ * NIX_MEM_PTRS_BLOCKS_SZ);
+        STNixMemBlockPos* arrN = (STNixMemBlockPos*)realloc(obj->sorted.arr, sizeof(obj->sorted.arr[0]) * szN);
+        if(arrN == NULL){
+            return 0;
+        }
+        obj->sorted.arr = arrN;
+        obj->sorted.sz  = szN;
+    }
+    obj->sorted.use = 0;
+    {
+        unsigned long i; for(i = 0; i < obj->arrUse; i++){
+            if(obj->arr[i].regUsed){
+                STNixMemBlockPos* pos = &obj->sorted.arr[obj->sorted.use++];
+                pos->pointer    = obj->arr[i].pointer;
+                pos->iRec       = i;
+            }
+        }
+    }
+    assert(obj->sorted.use == ammUsed); //program logic error
+    qsort(obj->sorted.arr, obj->sorted.use, sizeof(obj->sorted.arr[0]), NixMemBlocks_sortedCompare_);
+    obj->sorted.isDirty = 0;
+    return 1;
+}
+
 void NixMemBlocks_init(STNixMemBlocks* obj){
     memset(obj, 0, sizeof(*obj));
 }
@@ -222,43 +390,75 @@ void NixMemBlocks_destroy(STNixMemBlocks* obj){
         obj->arrSz = 0;
         obj->arrUse = 0;
     }
+    //unused
+    if(obj->unused.arr != NULL){
+        free(obj->unused.arr);
+        obj->unused.arr = NULL;
+    }
+    obj->unused.sz = obj->unused.use = 0;
+    //hash
+    if(obj->hash.arr != NULL){
+        free(obj->hash.arr);
+        obj->hash.arr = NULL;
+    }
+    obj->hash.sz = obj->hash.use = 0;
+    //sorted
+    if(obj->sorted.arr != NULL){
+        free(obj->sorted.arr);
+        obj->sorted.arr = NULL;
+    }
+    obj->sorted.sz = obj->sorted.use = 0;
 }
 
 STNixMemBlock* NixMemBlocks_findExact(STNixMemBlocks* obj, void* pointer){
     STNixMemBlock* r = NULL;
-    unsigned long i; for(i = 0; i < obj->arrUse; i++){
-        STNixMemBlock* b = &obj->arr[i];
-        if(b->regUsed && b->pointer == pointer){
-            r = b;
-            break;
-        }
+    const unsigned long iSlot = NixMemBlocks_hashFind_(obj, pointer);
+    if(iSlot != NIX_MEM_HASH_NOT_FOUND){
+        r = &obj->arr[obj->hash.arr[iSlot] - 1];
+        assert(r->regUsed); //program logic error
     }
     return r;
 }
 
 STNixMemBlock* NixMemBlocks_findContainer(STNixMemBlocks* obj, void* pointer){
     STNixMemBlock* r = NULL;
-    unsigned long i; for(i = 0; i < obj->arrUse; i++){
-        STNixMemBlock* b = &obj->arr[i];
-        if(b->regUsed && b->pointer <= pointer && pointer <= (void*)((char*)b->pointer + b->bytes)){
-            r = b;
-            break;
+    //exact match (most common case)
+    r = NixMemBlocks_findExact(obj, pointer);
+    if(r != NULL){
+        return r;
+    }
+    //binary search for the last block starting at or before 'pointer'
+    if(!obj->sorted.isDirty || NixMemBlocks_sortedRebuild_(obj)){
+        unsigned long iStart = 0, iEnd = obj->sorted.use;
+        while(iStart < iEnd){
+            const unsigned long iMid = iStart + (iEnd - iStart) / 2;
+            if(obj->sorted.arr[iMid].pointer <= pointer){
+                iStart = iMid + 1;
+            } else {
+                iEnd = iMid;
+            }
+        }
+        if(iStart > 0){
+            STNixMemBlock* b = &obj->arr[obj->sorted.arr[iStart - 1].iRec];
+            if(b->regUsed && b->pointer <= pointer && pointer <= (void*)((char*)b->pointer + b->bytes)){
+                r = b;
+            }
         }
     }
     return r;
 }
 
 STNixMemBlock* NixMemBlocks_add(STNixMemBlocks* obj, void* pointer, unsigned long bytes, const unsigned long iStrHint){
-    STNixMemBlock* r = NULL;
-    //search for an available record
-    {
-        unsigned long i; for(i = 0; i < obj->arrUse; i++){
-            STNixMemBlock* b = &obj->arr[i];
-            if(!b->regUsed){
-                r = b;
-                break;
-            }
-        }
+    STNixMemBlock* r = NULL; unsigned long iRec = 0;
+    //reserve hash slot
+    if(!NixMemBlocks_hashReserve_(obj, obj->arrUse - obj->unused.use)){
+        return NULL;
+    }
+    //reuse an available record
+    if(obj->unused.use > 0){
+        iRec = obj->unused.arr[--obj->unused.use];
+        r = &obj->arr[iRec];
+        assert(!r->regUsed); //program logic error
     }
     //create new record
     if(r == NULL){
@@ -271,9 +471,18 @@ STNixMemBlock* NixMemBlocks_add(STNixMemBlocks* obj, void* pointer, unsigned lon
                 obj->arrSz = szN;
             }
         }
+        //resize unused indexes (always able to hold every record)
+        if(obj->unused.sz < obj->arrSz){
+            unsigned long* arrN = (unsigned long*)realloc(obj->unused.arr, sizeof(obj->unused.arr[0]) * obj->arrSz);
+            if(arrN != NULL){
+                obj->unused.arr = arrN;
+                obj->unused.sz  = obj->arrSz;
+            }
+        }
         //
-        if(obj->arrUse < obj->arrSz){
-            r = &obj->arr[obj->arrUse++];
+        if(obj->arrUse < obj->arrSz && obj->arrUse < obj->unused.sz){
+            iRec = obj->arrUse++;
+            r = &obj->arr[iRec];
             NixMemBlock_init(r);
         }
     }
@@ -283,10 +492,24 @@ STNixMemBlock* NixMemBlocks_add(STNixMemBlocks* obj, void* pointer, unsigned lon
         r->pointer  = pointer;
         r->bytes    = bytes;
         r->iStrHint = iStrHint;
+        NixMemBlocks_hashInsert_(obj, iRec);
+        obj->sorted.isDirty = 1;
     }
     return r;
 }
 
+void NixMemBlocks_remove(STNixMemBlocks* obj, STNixMemBlock* b){
+    const unsigned long iSlot = NixMemBlocks_hashFind_(obj, b->pointer);
+    assert(b->regUsed && iSlot != NIX_MEM_HASH_NOT_FOUND && &obj->arr[obj->hash.arr[iSlot] - 1] == b); //should be registered
+    if(iSlot != NIX_MEM_HASH_NOT_FOUND){
+        NixMemBlocks_hashRemoveSlot_(obj, iSlot);
+    }
+    b->regUsed = 0;
+    assert(obj->unused.use < obj->unused.sz); //program logic error
+    obj->unused.arr[obj->unused.use++] = (unsigned long)(b - obj->arr);
+    obj->sorted.isDirty = 1;
+}
+
 //STNixMemStats
 
 void NixMemStats_init(STNixMemStats* obj){
@@ -297,111 +520,423 @@ void NixMemStats_destroy(STNixMemStats* obj){
     memset(obj, 0, sizeof(*obj));
 }
 
-//---------------------------------------------
-//-- Usefull implementation for memory leaking
-//-- detection and tracking.
-//---------------------------------------------
+//STNixMemMapShard
 
-void NixMemMap_init(STNixMemMap* obj){
+void NixMemMapShard_init(STNixMemMapShard* obj){
     memset(obj, 0, sizeof(*obj));
     NixMemStats_init(&obj->stats);
     NixMemStrs_init(&obj->strs);
     NixMemBlocks_init(&obj->blocks);
+    {
+        NIX_MUTEX_T* mutex = (NIX_MUTEX_T*)malloc(sizeof(NIX_MUTEX_T));
+        if(mutex != NULL){
+            NIX_MUTEX_INIT(mutex);
+            obj->mutex = mutex;
+        }
+    }
 }
 
-void NixMemMap_destroy(STNixMemMap* obj){
+void NixMemMapShard_destroy(STNixMemMapShard* obj){
     NixMemStats_destroy(&obj->stats);
     NixMemStrs_destroy(&obj->strs);
     NixMemBlocks_destroy(&obj->blocks);
+    if(obj->strSites.arr != NULL){
+        free(obj->strSites.arr);
+        obj->strSites.arr = NULL;
+    }
+    obj->strSites.sz = 0;
+    if(obj->mutex != NULL){
+        NIX_MUTEX_DESTROY((NIX_MUTEX_T*)obj->mutex);
+        free(obj->mutex);
+        obj->mutex = NULL;
+    }
+}
+
+#define NixMemMapShard_lock_(OBJ)   NIX_MUTEX_LOCK((NIX_MUTEX_T*)(OBJ)->mutex)
+#define NixMemMapShard_unlock_(OBJ) NIX_MUTEX_UNLOCK((NIX_MUTEX_T*)(OBJ)->mutex)
+
+//---------------------------------------------
+//-- Usefull implementation for memory leaking
+//-- detection and tracking.
+//---------------------------------------------
+
+static STNixMemMapShard* NixMemMap_shardOf_(STNixMemMap* obj, const void* pointer){
+    size_t h = (size_t)pointer >> 4; //allocations are aligned, ignore the low bits
+    h ^= (h >> 7) ^ (h >> 13);
+    return &obj->shards[h & (NIX_MEM_MAP_SHARDS_SZ - 1)];
+}
+
+static void NixMemMap_aliveAdded_(STNixMemMap* obj, const unsigned long bytes){
+    NixMem_atomicMax_(&obj->max.count, NIX_MEM_ATOMIC_ADD(&obj->alive.count, 1));
+    NixMem_atomicMax_(&obj->max.bytes, NIX_MEM_ATOMIC_ADD(&obj->alive.bytes, bytes));
+}
+
+static unsigned long NixMemMap_sizeClass_(const unsigned long bytes){
+    unsigned long r = 0;
+    while(r < (NIX_MEM_MAP_SIZE_CLASSES_SZ - 1) && ((unsigned long)1 << r) < bytes){
+        r++;
+    }
+    return r;
+}
+
+static void NixMemSiteStats_added_(STNixMemSiteStats* obj, const unsigned long bytes){
+    NIX_MEM_ATOMIC_ADD(&obj->count, 1);
+    NIX_MEM_ATOMIC_ADD(&obj->bytes, bytes);
+    NIX_MEM_ATOMIC_ADD(&obj->aliveBytes, bytes);
+    NixMem_atomicMax_(&obj->peakCount, NIX_MEM_ATOMIC_ADD(&obj->aliveCount, 1));
+}
+
+static void NixMemSiteStats_removed_(STNixMemSiteStats* obj, const unsigned long bytes){
+    NIX_MEM_ATOMIC_ADD(&obj->aliveCount, (unsigned long)-1);
+    NIX_MEM_ATOMIC_ADD(&obj->aliveBytes, (unsigned long)0 - bytes);
+}
+
+//returns the site index for the shard's string (shard must be locked)
+static unsigned long NixMemMap_siteOf_(STNixMemMap* obj, STNixMemMapShard* shard, const unsigned long iStrHint){
+    unsigned long r = 0;
+    if(iStrHint == 0){
+        return r;
+    }
+    //cached
+    if(iStrHint < shard->strSites.sz && shard->strSites.arr[iStrHint] != 0){
+        return shard->strSites.arr[iStrHint] - 1;
+    }
+    //find or register (global)
+    NIX_MUTEX_LOCK((NIX_MUTEX_T*)obj->sites.mutex);
+    {
+        const unsigned long iStrSite = NixMemStrs_findOrAdd(&obj->sites.strs, &shard->strs.buff[iStrHint]);
+        if(iStrSite != 0){
+            //resize index (if necesary)
+            if(iStrSite >= obj->sites.strIdxSz){
+                const unsigned long szN = obj->sites.strs.buffSz;
+                unsigned long* arrN = (unsigned long*)realloc(obj->sites.strIdx, sizeof(obj->sites.strIdx[0]) * szN);
+                if(arrN != NULL){
+                    memset(&arrN[obj->sites.strIdxSz], 0, sizeof(arrN[0]) * (szN - obj->sites.strIdxSz));
+                    obj->sites.strIdx   = arrN;
+                    obj->sites.strIdxSz = szN;
+                }
+            }
+            if(iStrSite < obj->sites.strIdxSz){
+                if(obj->sites.strIdx[iStrSite] != 0){
+                    r = obj->sites.strIdx[iStrSite] - 1;
+                } else if(obj->sites.arr != NULL && obj->sites.use < NIX_MEM_MAP_SITES_MAX){
+                    r = obj->sites.use;
+                    obj->sites.arr[r].iStrHint = iStrSite;
+                    obj->sites.strIdx[iStrSite] = r + 1;
+                    NIX_MEM_ATOMIC_ADD(&obj->sites.use, 1); //publish after populating
+                }
+            }
+        }
+    }
+    NIX_MUTEX_UNLOCK((NIX_MUTEX_T*)obj->sites.mutex);
+    //cache
+    if(iStrHint >= shard->strSites.sz){
+        const unsigned long szN = shard->strs.buffSz;
+        unsigned long* arrN = (unsigned long*)realloc(shard->strSites.arr, sizeof(shard->strSites.arr[0]) * szN);
+        if(arrN != NULL){
+            memset(&arrN[shard->strSites.sz], 0, sizeof(arrN[0]) * (szN - shard->strSites.sz));
+            shard->strSites.arr = arrN;
+            shard->strSites.sz  = szN;
+        }
+    }
+    if(iStrHint < shard->strSites.sz){
+        shard->strSites.arr[iStrHint] = r + 1;
+    }
+    return r;
+}
+
+void NixMemMap_init(STNixMemMap* obj){
+    memset(obj, 0, sizeof(*obj));
+    {
+        unsigned long i; for(i = 0; i < NIX_MEM_MAP_SHARDS_SZ; i++){
+            NixMemMapShard_init(&obj->shards[i]);
+        }
+    }
+    //sites
+    {
+        NIX_MUTEX_T* mutex = (NIX_MUTEX_T*)malloc(sizeof(NIX_MUTEX_T));
+        if(mutex != NULL){
+            NIX_MUTEX_INIT(mutex);
+            obj->sites.mutex = mutex;
+        }
+        NixMemStrs_init(&obj->sites.strs);
+        obj->sites.arr = (STNixMemSiteStats*)malloc(sizeof(obj->sites.arr[0]) * NIX_MEM_MAP_SITES_MAX);
+        if(obj->sites.arr != NULL){
+            memset(obj->sites.arr, 0, sizeof(obj->sites.arr[0]) * NIX_MEM_MAP_SITES_MAX);
+            obj->sites.use = 1; //site #0 is <empty string> and overflow
+        }
+    }
+    //times
+    obj->times.start = obj->times.lastReport = NIX_MEM_NOW_MS();
+}
+
+void NixMemMap_destroy(STNixMemMap* obj){
+    unsigned long i; for(i = 0; i < NIX_MEM_MAP_SHARDS_SZ; i++){
+        NixMemMapShard_destroy(&obj->shards[i]);
+    }
+    //sites
+    {
+        NixMemStrs_destroy(&obj->sites.strs);
+        if(obj->sites.arr != NULL){
+            free(obj->sites.arr);
+            obj->sites.arr = NULL;
+        }
+        obj->sites.use = 0;
+        if(obj->sites.strIdx != NULL){
+            free(obj->sites.strIdx);
+            obj->sites.strIdx = NULL;
+        }
+        obj->sites.strIdxSz = 0;
+        if(obj->sites.mutex != NULL){
+            NIX_MUTEX_DESTROY((NIX_MUTEX_T*)obj->sites.mutex);
+            free(obj->sites.mutex);
+            obj->sites.mutex = NULL;
+        }
+    }
 }
 
 //mem
 
 void NixMemMap_ptrAdd(STNixMemMap* obj, void* pointer, unsigned long bytes, const char* strHint){
-    assert(NULL == NixMemBlocks_findExact(&obj->blocks, pointer)); //should not be registered
-    //Find or register hint string
-    const unsigned long iStrHint = NixMemStrs_findOrAdd(&obj->strs, strHint);
-    if(NULL != NixMemBlocks_add(&obj->blocks, pointer, bytes, iStrHint)){
-        obj->stats.alive.count++;
-        obj->stats.alive.bytes += bytes;
-        //
-        obj->stats.total.count++;
-        obj->stats.total.bytes += bytes;
-        //
-        if(obj->stats.max.count < obj->stats.alive.count) obj->stats.max.count = obj->stats.alive.count;
-        if(obj->stats.max.bytes < obj->stats.alive.bytes) obj->stats.max.bytes = obj->stats.alive.bytes;
+    STNixMemMapShard* shard = NixMemMap_shardOf_(obj, pointer);
+    NixMemMapShard_lock_(shard);
+    {
+        assert(NULL == NixMemBlocks_findExact(&shard->blocks, pointer)); //should not be registered
+        //Find or register hint string
+        const unsigned long iStrHint = NixMemStrs_findOrAdd(&shard->strs, strHint);
+        STNixMemBlock* b = NixMemBlocks_add(&shard->blocks, pointer, bytes, iStrHint);
+        if(b != NULL){
+            shard->stats.alive.count++;
+            shard->stats.alive.bytes += bytes;
+            //
+            shard->stats.total.count++;
+            shard->stats.total.bytes += bytes;
+            //
+            if(shard->stats.max.count < shard->stats.alive.count) shard->stats.max.count = shard->stats.alive.count;
+            if(shard->stats.max.bytes < shard->stats.alive.bytes) shard->stats.max.bytes = shard->stats.alive.bytes;
+            //global
+            NixMemMap_aliveAdded_(obj, bytes);
+            //site and size class
+            b->iSite = NixMemMap_siteOf_(obj, shard, iStrHint);
+            if(obj->sites.arr != NULL){
+                NixMemSiteStats_added_(&obj->sites.arr[b->iSite], bytes);
+            }
+            NixMemSiteStats_added_(&obj->sizes[NixMemMap_sizeClass_(bytes)], bytes);
+        }
     }
+    NixMemMapShard_unlock_(shard);
 }
 
 void NixMemMap_ptrRemove(STNixMemMap* obj, void* pointer){
-    unsigned long i; const unsigned long use = obj->blocks.arrUse;
-    for(i = 0; i < use; i++){
-        STNixMemBlock* b = &obj->blocks.arr[i];
-        if(b->regUsed && b->pointer == pointer){
-            b->regUsed = 0;
-            obj->stats.alive.count--;
-            obj->stats.alive.bytes -= b->bytes;
-            return;
+    STNixMemMapShard* shard = NixMemMap_shardOf_(obj, pointer);
+    NixMemMapShard_lock_(shard);
+    {
+        STNixMemBlock* b = NixMemBlocks_findExact(&shard->blocks, pointer);
+        assert(b != NULL); //Pointer was not found
+        if(b != NULL){
+            shard->stats.alive.count--;
+            shard->stats.alive.bytes -= b->bytes;
+            //global
+            NIX_MEM_ATOMIC_ADD(&obj->alive.count, (unsigned long)-1);
+            NIX_MEM_ATOMIC_ADD(&obj->alive.bytes, (unsigned long)0 - b->bytes);
+            //site and size class
+            if(obj->sites.arr != NULL){
+                NixMemSiteStats_removed_(&obj->sites.arr[b->iSite], b->bytes);
+            }
+            NixMemSiteStats_removed_(&obj->sizes[NixMemMap_sizeClass_(b->bytes)], b->bytes);
+            //
+            NixMemBlocks_remove(&shard->blocks, b);
         }
     }
-    assert(0); //Pointer was not found
+    NixMemMapShard_unlock_(shard);
 }
 
 //dbg
 
 void NixMemMap_ptrRetainedBy(STNixMemMap* obj, void* pointer, const char* by){
-    STNixMemBlock* b = NixMemBlocks_findExact(&obj->blocks, pointer);
-    assert(b != NULL); //should be registered
-    if(b != NULL){
-        const unsigned long iStrHint = NixMemStrs_findOrAdd(&obj->strs, by);
-        NixMemBlock_retainedBy(b, iStrHint);
+    STNixMemMapShard* shard = NixMemMap_shardOf_(obj, pointer);
+    NixMemMapShard_lock_(shard);
+    {
+        STNixMemBlock* b = NixMemBlocks_findExact(&shard->blocks, pointer);
+        assert(b != NULL); //should be registered
+        if(b != NULL){
+            const unsigned long iStrHint = NixMemStrs_findOrAdd(&shard->strs, by);
+            NixMemBlock_retainedBy(b, iStrHint);
+        }
     }
+    NixMemMapShard_unlock_(shard);
 }
 
 void NixMemMap_ptrReleasedBy(STNixMemMap* obj, void* pointer, const char* by){
-    STNixMemBlock* b = NixMemBlocks_findExact(&obj->blocks, pointer);
-    assert(b != NULL); //should be registered
-    if(b != NULL){
-        const unsigned long iStrHint = NixMemStrs_findOrAdd(&obj->strs, by);
-        NixMemBlock_releasedBy(b, iStrHint);
+    STNixMemMapShard* shard = NixMemMap_shardOf_(obj, pointer);
+    NixMemMapShard_lock_(shard);
+    {
+        STNixMemBlock* b = NixMemBlocks_findExact(&shard->blocks, pointer);
+        assert(b != NULL); //should be registered
+        if(b != NULL){
+            const unsigned long iStrHint = NixMemStrs_findOrAdd(&shard->strs, by);
+            NixMemBlock_releasedBy(b, iStrHint);
+        }
     }
+    NixMemMapShard_unlock_(shard);
 }
 
 //report
 
+void NixMemMap_getStats(STNixMemMap* obj, STNixMemStats* dst){
+    NixMemStats_init(dst);
+    {
+        unsigned long i; for(i = 0; i < NIX_MEM_MAP_SHARDS_SZ; i++){
+            STNixMemMapShard* shard = &obj->shards[i];
+            NixMemMapShard_lock_(shard);
+            {
+                dst->alive.count += shard->stats.alive.count;
+                dst->alive.bytes += shard->stats.alive.bytes;
+                dst->total.count += shard->stats.total.count;
+                dst->total.bytes += shard->stats.total.bytes;
+            }
+            NixMemMapShard_unlock_(shard);
+        }
+    }
+    dst->max.count = NIX_MEM_ATOMIC_LOAD(&obj->max.count);
+    dst->max.bytes = NIX_MEM_ATOMIC_LOAD(&obj->max.bytes);
+}
+
+typedef struct STNixMemSiteRow_ {
+    STNixMemSiteStats   stats;  //snapshot
+    unsigned long       iSite;
+    double              rateAvg; //allocs per sec since start
+    double              rateCur; //allocs per sec since previous report
+} STNixMemSiteRow;
+
+static ENNixMemMapSort NixMemMap_sortBy_ = ENNixMemMapSort_Count; //reports are serialized by 'sites.mutex'
+
+static int NixMemMap_sitesCompare_(const void* a, const void* b){
+    const STNixMemSiteRow* rA = (const STNixMemSiteRow*)a;
+    const STNixMemSiteRow* rB = (const STNixMemSiteRow*)b;
+    switch(NixMemMap_sortBy_){
+        case ENNixMemMapSort_Bytes: return (rA->stats.bytes > rB->stats.bytes ? -1 : rA->stats.bytes < rB->stats.bytes ? 1 : 0);
+        case ENNixMemMapSort_Peak:  return (rA->stats.peakCount > rB->stats.peakCount ? -1 : rA->stats.peakCount < rB->stats.peakCount ? 1 : 0);
+        case ENNixMemMapSort_Rate:  return (rA->rateCur > rB->rateCur ? -1 : rA->rateCur < rB->rateCur ? 1 : 0);
+        default: break;
+    }
+    return (rA->stats.count > rB->stats.count ? -1 : rA->stats.count < rB->stats.count ? 1 : 0);
+}
+
+static void NixMemSiteStats_snapshot_(STNixMemSiteStats* obj, STNixMemSiteStats* dst){
+    dst->iStrHint       = obj->iStrHint;
+    dst->count          = NIX_MEM_ATOMIC_LOAD(&obj->count);
+    dst->bytes          = NIX_MEM_ATOMIC_LOAD(&obj->bytes);
+    dst->aliveCount     = NIX_MEM_ATOMIC_LOAD(&obj->aliveCount);
+    dst->aliveBytes     = NIX_MEM_ATOMIC_LOAD(&obj->aliveBytes);
+    dst->peakCount      = NIX_MEM_ATOMIC_LOAD(&obj->peakCount);
+    dst->countAtReport  = obj->countAtReport;
+}
+
+void NixMemMap_printSitesReport(STNixMemMap* obj, const ENNixMemMapSort sortBy, const unsigned long maxRows){
+    if(obj->sites.mutex == NULL || obj->sites.arr == NULL){
+        return;
+    }
+    NIX_MUTEX_LOCK((NIX_MUTEX_T*)obj->sites.mutex);
+    {
+        const unsigned long long now = NIX_MEM_NOW_MS();
+        const double secsAvg = (double)(now - obj->times.start) / 1000.0;
+        const double secsCur = (double)(now - obj->times.lastReport) / 1000.0;
+        const unsigned long use = NIX_MEM_ATOMIC_LOAD(&obj->sites.use);
+        STNixMemSiteRow* rows = (STNixMemSiteRow*)malloc(sizeof(STNixMemSiteRow) * (use > NIX_MEM_MAP_SIZE_CLASSES_SZ ? use : NIX_MEM_MAP_SIZE_CLASSES_SZ));
+        if(rows != NULL){
+            unsigned long i, rowsUse = 0;
+            //sites
+            for(i = 0; i < use; i++){
+                STNixMemSiteRow* row = &rows[rowsUse];
+                NixMemSiteStats_snapshot_(&obj->sites.arr[i], &row->stats);
+                if(row->stats.count > 0){
+                    row->iSite      = i;
+                    row->rateAvg    = (secsAvg > 0.0 ? (double)row->stats.count / secsAvg : 0.0);
+                    row->rateCur    = (secsCur > 0.0 ? (double)(row->stats.count - row->stats.countAtReport) / secsCur : 0.0);
+                    obj->sites.arr[i].countAtReport = row->stats.count;
+                    rowsUse++;
+                }
+            }
+            NixMemMap_sortBy_ = sortBy;
+            qsort(rows, rowsUse, sizeof(rows[0]), NixMemMap_sitesCompare_);
+            NIX_PRINTF_INFO("-------------- MEM SITES (%lu of %lu, %.1fs running) -----------\n", (maxRows > 0 && maxRows < rowsUse ? maxRows : rowsUse), rowsUse, secsAvg);
+            NIX_PRINTF_INFO("%10s %12s %9s %9s %8s %8s  %s\n", "allocs", "bytes", "allocs/s", "recent/s", "alive", "peak", "site");
+            for(i = 0; i < rowsUse && (maxRows == 0 || i < maxRows); i++){
+                const STNixMemSiteRow* row = &rows[i];
+                NIX_PRINTF_INFO("%10lu %12lu %9.1f %9.1f %8lu %8lu  '%s'\n", row->stats.count, row->stats.bytes, row->rateAvg, row->rateCur, row->stats.aliveCount, row->stats.peakCount, (row->iSite == 0 ? (obj->sites.use >= NIX_MEM_MAP_SITES_MAX ? "<no-hint-or-overflow>" : "<no-hint>") : &obj->sites.strs.buff[row->stats.iStrHint]));
+            }
+            //size classes
+            NIX_PRINTF_INFO("-------------- MEM SIZE CLASSES -----------\n");
+            NIX_PRINTF_INFO("%10s %12s %9s %9s %8s %8s  %s\n", "allocs", "bytes", "allocs/s", "recent/s", "alive", "peak", "size");
+            for(i = 0; i < NIX_MEM_MAP_SIZE_CLASSES_SZ; i++){
+                STNixMemSiteRow* row = &rows[0];
+                NixMemSiteStats_snapshot_(&obj->sizes[i], &row->stats);
+                if(row->stats.count > 0){
+                    row->rateAvg    = (secsAvg > 0.0 ? (double)row->stats.count / secsAvg : 0.0);
+                    row->rateCur    = (secsCur > 0.0 ? (double)(row->stats.count - row->stats.countAtReport) / secsCur : 0.0);
+                    obj->sizes[i].countAtReport = row->stats.count;
+                    if(i == 0){
+                        NIX_PRINTF_INFO("%10lu %12lu %9.1f %9.1f %8lu %8lu  <= 1\n", row->stats.count, row->stats.bytes, row->rateAvg, row->rateCur, row->stats.aliveCount, row->stats.peakCount);
+                    } else if(i == (NIX_MEM_MAP_SIZE_CLASSES_SZ - 1)){
+                        NIX_PRINTF_INFO("%10lu %12lu %9.1f %9.1f %8lu %8lu  > %lu\n", row->stats.count, row->stats.bytes, row->rateAvg, row->rateCur, row->stats.aliveCount, row->stats.peakCount, ((unsigned long)1 << (i - 1)));
+                    } else {
+                        NIX_PRINTF_INFO("%10lu %12lu %9.1f %9.1f %8lu %8lu  %lu-%lu\n", row->stats.count, row->stats.bytes, row->rateAvg, row->rateCur, row->stats.aliveCount, row->stats.peakCount, ((unsigned long)1 << (i - 1)) + 1, ((unsigned long)1 << i));
+                    }
+                }
+            }
+            free(rows);
+        }
+        obj->times.lastReport = now;
+    }
+    NIX_MUTEX_UNLOCK((NIX_MUTEX_T*)obj->sites.mutex);
+}
+
 void NixMemMap_printAlivePtrs(STNixMemMap* obj){
-    unsigned long i, countUsed = 0, bytesUsed = 0; const unsigned long use = obj->blocks.arrUse;
-    for(i = 0; i < use; i++){
-        STNixMemBlock* b = &obj->blocks.arr[i];
-        if(b->regUsed){
-            ++countUsed;
-            bytesUsed += b->bytes;
-            NIX_PRINTF_INFO("#%lu) %lu, %lu bytes, '%s'\n", countUsed, (unsigned long)b->pointer, b->bytes, &obj->strs.buff[b->iStrHint]);
-            if(b->retains.arr != NULL && b->retains.use > 0){
-                NIX_PRINTF_INFO("        Retains balance: %ld (should be -1)\n", b->retains.balance);
-                unsigned long i; for(i = 0; i < b->retains.use; i++){
-                    STNixPtrRetainer* rr = &b->retains.arr[i];
-                    NIX_PRINTF_INFO("        %ld by '%s'\n", rr->balance, rr->iStrHint == 0 ? "stack-or-unmanaged-obj": &obj->strs.buff[rr->iStrHint]);
+    STNixMemStats stats;
+    unsigned long countUsed = 0, bytesUsed = 0;
+    unsigned long iShard; for(iShard = 0; iShard < NIX_MEM_MAP_SHARDS_SZ; iShard++){
+        STNixMemMapShard* shard = &obj->shards[iShard];
+        NixMemMapShard_lock_(shard);
+        {
+            unsigned long i; const unsigned long use = shard->blocks.arrUse;
+            for(i = 0; i < use; i++){
+                STNixMemBlock* b = &shard->blocks.arr[i];
+                if(b->regUsed){
+                    ++countUsed;
+                    bytesUsed += b->bytes;
+                    NIX_PRINTF_INFO("#%lu) %lu, %lu bytes, '%s'\n", countUsed, (unsigned long)b->pointer, b->bytes, &shard->strs.buff[b->iStrHint]);
+                    if(b->retains.arr != NULL && b->retains.use > 0){
+                        NIX_PRINTF_INFO("        Retains balance: %ld (should be -1)\n", b->retains.balance);
+                        unsigned long i; for(i = 0; i < b->retains.use; i++){
+                            STNixPtrRetainer* rr = &b->retains.arr[i];
+                            NIX_PRINTF_INFO("        %ld by '%s'\n", rr->balance, rr->iStrHint == 0 ? "stack-or-unmanaged-obj": &shard->strs.buff[rr->iStrHint]);
+                        }
+                    }
                 }
             }
         }
+        NixMemMapShard_unlock_(shard);
     }
+    NixMemMap_getStats(obj, &stats);
     NIX_PRINTF_INFO("\n");
-    NIX_PRINTF_INFO("CURRENTLY USED   : %lu blocks (%lu bytes)\n", obj->stats.alive.count, obj->stats.alive.bytes);
-    NIX_PRINTF_INFO("MAX USED         : %lu blocks (%lu bytes)\n", obj->stats.max.count, obj->stats.max.bytes);
-    NIX_PRINTF_INFO("TOTAL ALLOCATIONS: %lu blocks (%lu bytes)\n", obj->stats.total.count, obj->stats.total.bytes);
-    assert(obj->stats.alive.count == countUsed); //program logic error
-    assert(obj->stats.alive.bytes == bytesUsed); //program logic error
+    NIX_PRINTF_INFO("CURRENTLY USED   : %lu blocks (%lu bytes)\n", stats.alive.count, stats.alive.bytes);
+    NIX_PRINTF_INFO("MAX USED         : %lu blocks (%lu bytes)\n", stats.max.count, stats.max.bytes);
+    NIX_PRINTF_INFO("TOTAL ALLOCATIONS: %lu blocks (%lu bytes)\n", stats.total.count, stats.total.bytes);
+    assert(stats.alive.count == countUsed); //program logic error (or still allocating from other threads)
+    assert(stats.alive.bytes == bytesUsed); //program logic error (or still allocating from other threads)
 }
 
 void NixMemMap_printFinalReport(STNixMemMap* obj){
+    STNixMemStats stats;
+    NixMemMap_getStats(obj, &stats);
     NIX_PRINTF_INFO("-------------- MEM REPORT -----------\n");
-    if(obj->stats.alive.count == 0){
+    if(stats.alive.count == 0){
         NIX_PRINTF_INFO("Nixtla: no memory leaking detected :)\n");
     } else {
         NIX_PRINTF_WARNING("WARNING, NIXTLA MEMORY-LEAK DETECTED! :(\n");
     }
     NixMemMap_printAlivePtrs(obj);
+    NixMemMap_printSitesReport(obj, ENNixMemMapSort_Count, 32);
     NIX_PRINTF_INFO("-------------------------------------\n");
 }
-
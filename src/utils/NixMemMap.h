@@ -50,6 +50,7 @@ typedef struct STNixMemBlock_ {
     unsigned long   iStrHint;
     void*           pointer;
     unsigned long   bytes;
+    unsigned long   iSite;      //in STNixMemMap's 'sites'
     //retains
     struct {
         STNixPtrRetainer*   arr;
@@ -66,10 +67,34 @@ void NixMemBlock_releasedBy(STNixMemBlock* obj, const unsigned long iStrHint);
 
 //STNixMemBlocks
 
+typedef struct STNixMemBlockPos_ {
+    void*           pointer;
+    unsigned long   iRec;   //index in 'arr'
+} STNixMemBlockPos;
+
 typedef struct STNixMemBlocks_ {
     STNixMemBlock*   arr;
     unsigned long    arrSz;
     unsigned long    arrUse;
+    //unused (indexes of released records, reused before growing 'arr')
+    struct {
+        unsigned long*  arr;
+        unsigned long   sz;
+        unsigned long   use;
+    } unused;
+    //hash (open addressing by pointer with linear probing, values are 'arr' index + 1, zero means empty slot)
+    struct {
+        unsigned long*  arr;
+        unsigned long   sz;     //power of two
+        unsigned long   use;
+    } hash;
+    //sorted (used records ordered by pointer, rebuilt on demand by 'findContainer')
+    struct {
+        STNixMemBlockPos* arr;
+        unsigned long   sz;
+        unsigned long   use;
+        char            isDirty;
+    } sorted;
 } STNixMemBlocks;
 
 void NixMemBlocks_init(STNixMemBlocks* obj);
@@ -77,6 +102,7 @@ void NixMemBlocks_destroy(STNixMemBlocks* obj);
 STNixMemBlock* NixMemBlocks_findExact(STNixMemBlocks* obj, void* pointer);
 STNixMemBlock* NixMemBlocks_findContainer(STNixMemBlocks* obj, void* pointer);
 STNixMemBlock* NixMemBlocks_add(STNixMemBlocks* obj, void* pointer, unsigned long bytes, const unsigned long iStrHint);
+void NixMemBlocks_remove(STNixMemBlocks* obj, STNixMemBlock* b);
 
 //STNixMemStats
 
@@ -101,12 +127,94 @@ typedef struct STNixMemStats_ {
 void NixMemStats_init(STNixMemStats* obj);
 void NixMemStats_destroy(STNixMemStats* obj);
 
-//STNixMemMap
+//STNixMemMapShard
 
-typedef struct STNixMemMap_ {
-    STNixMemStats   stats;
+//Records are distributed in shards by pointer address,
+//each shard has its own lock, strings and stats; this
+//allows concurrent allocations from multiple threads
+//(and freeing from a thread other than the allocator's one).
+
+#ifndef NIX_MEM_MAP_SHARDS_SZ
+#   define NIX_MEM_MAP_SHARDS_SZ    16  //power of two
+#endif
+
+typedef struct STNixMemMapShard_ {
+    void*           mutex;  //NIX_MUTEX_T, allocated at init
+    STNixMemStats   stats;  //'max' is only meaningful globally, see STNixMemMap
     STNixMemStrs    strs;
     STNixMemBlocks  blocks;
+    //strSites (cache, 'strs' offset -> STNixMemMap's site index + 1)
+    struct {
+        unsigned long*  arr;
+        unsigned long   sz;
+    } strSites;
+} STNixMemMapShard;
+
+void NixMemMapShard_init(STNixMemMapShard* obj);
+void NixMemMapShard_destroy(STNixMemMapShard* obj);
+
+//STNixMemSiteStats
+
+//Statistics per allocation site ('dbgHintStr') or per size class,
+//members are updated atomically.
+
+#ifndef NIX_MEM_MAP_SITES_MAX
+#   define NIX_MEM_MAP_SITES_MAX        1024    //fixed (updated without locks); extra sites are accounted in site #0
+#endif
+
+#define NIX_MEM_MAP_SIZE_CLASSES_SZ     25      //powers of two, (2^(i-1), 2^i] bytes; the last one includes bigger blocks
+
+typedef struct STNixMemSiteStats_ {
+    unsigned long   iStrHint;       //in 'sites.strs' (sites only)
+    unsigned long   count;          //allocations
+    unsigned long   bytes;          //allocated
+    unsigned long   aliveCount;     //currently alive blocks
+    unsigned long   aliveBytes;     //currently alive bytes
+    unsigned long   peakCount;      //max concurrent blocks
+    unsigned long   countAtReport;  //'count' at previous report (for steady state rate)
+} STNixMemSiteStats;
+
+//ENNixMemMapSort
+
+typedef enum ENNixMemMapSort_ {
+    ENNixMemMapSort_Count = 0,  //total allocations
+    ENNixMemMapSort_Bytes,      //total bytes allocated
+    ENNixMemMapSort_Peak,       //max concurrent blocks
+    ENNixMemMapSort_Rate,       //allocations per second since previous report
+    //
+    ENNixMemMapSort_Count_
+} ENNixMemMapSort;
+
+//STNixMemMap
+
+typedef struct STNixMemMap_ {
+    STNixMemMapShard    shards[NIX_MEM_MAP_SHARDS_SZ];
+    //sites (per 'dbgHintStr')
+    struct {
+        void*               mutex;  //NIX_MUTEX_T, allocated at init (registration only)
+        STNixMemStrs        strs;
+        STNixMemSiteStats*  arr;    //NIX_MEM_MAP_SITES_MAX, allocated at init
+        unsigned long       use;    //atomic
+        unsigned long*      strIdx; //'strs' offset -> site index + 1
+        unsigned long       strIdxSz;
+    } sites;
+    //sizes (per size class)
+    STNixMemSiteStats   sizes[NIX_MEM_MAP_SIZE_CLASSES_SZ];
+    //times (ms)
+    struct {
+        unsigned long long  start;
+        unsigned long long  lastReport;
+    } times;
+    //alive (atomic, sum of all shards; used to track 'max')
+    struct {
+        unsigned long   count;
+        unsigned long   bytes;
+    } alive;
+    //max (atomic)
+    struct {
+        unsigned long   count;
+        unsigned long   bytes;
+    } max;
 } STNixMemMap;
 
 void NixMemMap_init(STNixMemMap* obj);
@@ -118,6 +226,8 @@ void NixMemMap_ptrRemove(STNixMemMap* obj, void* pointer);
 void NixMemMap_ptrRetainedBy(STNixMemMap* obj, void* pointer, const char* by);
 void NixMemMap_ptrReleasedBy(STNixMemMap* obj, void* pointer, const char* by);
 //report
+void NixMemMap_getStats(STNixMemMap* obj, STNixMemStats* dst); //merged from all shards
+void NixMemMap_printSitesReport(STNixMemMap* obj, const ENNixMemMapSort sortBy, const unsigned long maxRows); //maxRows zero means all
 void NixMemMap_printAlivePtrs(STNixMemMap* obj);
 void NixMemMap_printFinalReport(STNixMemMap* obj);
 